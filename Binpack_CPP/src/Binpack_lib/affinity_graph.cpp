@@ -0,0 +1,453 @@
+#include "affinity_graph.hpp"
+
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+
+
+static bool affinity_edge_target_less(const AffinityEdge& a, const AffinityEdge& b)
+{
+    return a.target < b.target;
+}
+
+// Sort a range by target and keep the last value of repeated targets,
+// returns the new end of the range
+static std::vector<AffinityEdge>::iterator uniqueSortedList(std::vector<AffinityEdge>::iterator first,
+                                                            std::vector<AffinityEdge>::iterator last)
+{
+    std::stable_sort(first, last, affinity_edge_target_less);
+    auto result = first;
+    for (auto it = first; it != last; ++it)
+    {
+        if ((it + 1 != last) and ((it + 1)->target == it->target))
+        {
+            continue;
+        }
+        *result++ = *it;
+    }
+    return result;
+}
+
+void sortAffinityList(std::vector<AffinityEdge>& edges)
+{
+    edges.erase(uniqueSortedList(edges.begin(), edges.end()), edges.end());
+}
+
+
+AffinityGraph::AffinityGraph()
+{ }
+
+void AffinityGraph::build(size_t nb_apps, size_t nb_nodes,
+                          const std::vector<size_t>& offsets, std::vector<AffinityEdge>& edges)
+{
+    // Out edges: sorted lists without repeated targets
+    out.begin.assign(nb_nodes, 0);
+    out.end.assign(nb_nodes, 0);
+    out.edges.clear();
+    out.edges.reserve(edges.size());
+    out.garbage = 0;
+    dropped_degrees.assign(nb_nodes, 0);
+    for (size_t i = 0; i < nb_apps; ++i)
+    {
+        auto list_end = uniqueSortedList(edges.begin() + offsets[i], edges.begin() + offsets[i+1]);
+        out.begin[i] = out.edges.size();
+        for (auto it = edges.begin() + offsets[i]; it != list_end; ++it)
+        {
+            if (it->target < (int)nb_nodes)
+            {
+                out.edges.push_back(*it);
+            }
+            else
+            {
+                dropped_degrees[i]++;
+            }
+        }
+        out.end[i] = out.edges.size();
+    }
+    for (size_t i = nb_apps; i < nb_nodes; ++i)
+    {
+        out.begin[i] = out.edges.size();
+        out.end[i] = out.edges.size();
+    }
+    out.edges.shrink_to_fit();
+
+    // In edges, sorted by source as the apps are visited in order
+    std::vector<size_t> counts(nb_nodes + 1, 0);
+    for (const AffinityEdge& edge : out.edges)
+    {
+        counts[edge.target + 1]++;
+    }
+    for (size_t i = 0; i < nb_nodes; ++i)
+    {
+        counts[i+1] += counts[i];
+    }
+    in.begin.assign(counts.begin(), counts.end() - 1);
+    in.end.assign(counts.begin(), counts.end() - 1);
+    in.edges.resize(out.edges.size());
+    in.garbage = 0;
+    for (size_t i = 0; i < nb_apps; ++i)
+    {
+        for (size_t e = out.begin[i]; e < out.end[i]; ++e)
+        {
+            const AffinityEdge& edge = out.edges[e];
+            in.edges[in.end[edge.target]++] = {(int)i, edge.value};
+        }
+    }
+
+    total_degrees.assign(nb_nodes, 0);
+    for (size_t i = 0; i < nb_nodes; ++i)
+    {
+        updateTotalDegree(i);
+    }
+}
+
+const size_t AffinityGraph::getNbNodes() const
+{
+    return total_degrees.size();
+}
+
+AffinitySpan AffinityGraph::getOut(int node) const
+{
+    return out.get(node);
+}
+
+AffinitySpan AffinityGraph::getIn(int node) const
+{
+    return in.get(node);
+}
+
+const int AffinityGraph::getTotalDegree(int node) const
+{
+    return total_degrees[node];
+}
+
+void AffinityGraph::updateTotalDegree(int node)
+{
+    // Size of the union of both sorted lists
+    AffinitySpan out_list = out.get(node);
+    AffinitySpan in_list = in.get(node);
+    const AffinityEdge* o = out_list.begin();
+    const AffinityEdge* n = in_list.begin();
+    int degree = dropped_degrees[node];
+    while ((o != out_list.end()) or (n != in_list.end()))
+    {
+        if ((n == in_list.end()) or ((o != out_list.end()) and (o->target < n->target)))
+        {
+            o++;
+        }
+        else if ((o == out_list.end()) or (n->target < o->target))
+        {
+            n++;
+        }
+        else
+        {
+            o++;
+            n++;
+        }
+        degree++;
+    }
+    total_degrees[node] = degree;
+}
+
+
+int AffinityGraph::addNode()
+{
+    out.begin.push_back(out.edges.size());
+    out.end.push_back(out.edges.size());
+    in.begin.push_back(in.edges.size());
+    in.end.push_back(in.edges.size());
+    total_degrees.push_back(0);
+    dropped_degrees.push_back(0);
+    return total_degrees.size() - 1;
+}
+
+void AffinityGraph::removeLastNode()
+{
+    int node = total_degrees.size() - 1;
+    if (!out.get(node).empty() or !in.get(node).empty())
+    {
+        throw std::runtime_error("Cannot remove node " + std::to_string(node) + " of the affinity graph with edges");
+    }
+    out.begin.pop_back();
+    out.end.pop_back();
+    in.begin.pop_back();
+    in.end.pop_back();
+    total_degrees.pop_back();
+    dropped_degrees.pop_back();
+}
+
+void AffinityGraph::setOut(int node, std::vector<AffinityEdge>& edges, int nb_dropped)
+{
+    sortAffinityList(edges);
+    AffinitySpan old_span = out.get(node);
+    std::vector<AffinityEdge> old_edges(old_span.begin(), old_span.end());
+
+    std::vector<AffinityEdge> list;
+    for (const AffinityEdge& edge : old_edges)
+    {
+        AffinitySpan in_list = in.get(edge.target);
+        list.clear();
+        for (const AffinityEdge& in_edge : in_list)
+        {
+            if (in_edge.target != node)
+            {
+                list.push_back(in_edge);
+            }
+        }
+        in.set(edge.target, list);
+    }
+    for (const AffinityEdge& edge : edges)
+    {
+        AffinitySpan in_list = in.get(edge.target);
+        const AffinityEdge* pos = std::lower_bound(in_list.begin(), in_list.end(),
+                                                   AffinityEdge{node, 0}, affinity_edge_target_less);
+        list.assign(in_list.begin(), pos);
+        list.push_back({node, edge.value});
+        list.insert(list.end(), pos, in_list.end());
+        in.set(edge.target, list);
+    }
+    out.set(node, edges);
+    dropped_degrees[node] = nb_dropped;
+
+    updateTotalDegree(node);
+    for (const AffinityEdge& edge : old_edges)
+    {
+        updateTotalDegree(edge.target);
+    }
+    for (const AffinityEdge& edge : edges)
+    {
+        updateTotalDegree(edge.target);
+    }
+}
+
+void AffinityGraph::dropInEdges(int node)
+{
+    AffinitySpan in_span = in.get(node);
+    std::vector<AffinityEdge> in_edges(in_span.begin(), in_span.end());
+
+    std::vector<AffinityEdge> list;
+    for (const AffinityEdge& in_edge : in_edges)
+    {
+        AffinitySpan out_list = out.get(in_edge.target);
+        list.clear();
+        for (const AffinityEdge& edge : out_list)
+        {
+            if (edge.target != node)
+            {
+                list.push_back(edge);
+            }
+        }
+        out.set(in_edge.target, list);
+        dropped_degrees[in_edge.target]++;
+    }
+    list.clear();
+    in.set(node, list);
+
+    updateTotalDegree(node);
+    for (const AffinityEdge& in_edge : in_edges)
+    {
+        updateTotalDegree(in_edge.target);
+    }
+}
+
+void AffinityGraph::swapNodes(int a, int b)
+{
+    if (a == b)
+    {
+        return;
+    }
+    auto rename = [a, b](int node) {
+        return (node == a) ? b : ((node == b) ? a : node);
+    };
+
+    // Lists containing a or b, with their ids once the nodes are swapped
+    std::vector<int> out_lists;
+    std::vector<int> in_lists;
+    for (int node : {a, b})
+    {
+        for (const AffinityEdge& edge : in.get(node))
+        {
+            out_lists.push_back(rename(edge.target));
+        }
+        for (const AffinityEdge& edge : out.get(node))
+        {
+            in_lists.push_back(rename(edge.target));
+        }
+    }
+
+    for (Adjacency* adj : {&out, &in})
+    {
+        std::swap(adj->begin[a], adj->begin[b]);
+        std::swap(adj->end[a], adj->end[b]);
+    }
+    std::swap(total_degrees[a], total_degrees[b]);
+    std::swap(dropped_degrees[a], dropped_degrees[b]);
+
+    std::sort(out_lists.begin(), out_lists.end());
+    out_lists.erase(std::unique(out_lists.begin(), out_lists.end()), out_lists.end());
+    for (int node : out_lists)
+    {
+        out.renameAndSort(node, a, b);
+    }
+    std::sort(in_lists.begin(), in_lists.end());
+    in_lists.erase(std::unique(in_lists.begin(), in_lists.end()), in_lists.end());
+    for (int node : in_lists)
+    {
+        in.renameAndSort(node, a, b);
+    }
+}
+
+void AffinityGraph::renumberNodes(const std::vector<int>& order)
+{
+    size_t nb_nodes = getNbNodes();
+    if (order.size() != nb_nodes)
+    {
+        throw std::runtime_error("Order of " + std::to_string(order.size()) + " nodes given to renumber " +
+                                 std::to_string(nb_nodes) + " nodes of the affinity graph");
+    }
+    std::vector<int> new_ids(nb_nodes);
+    for (size_t k = 0; k < nb_nodes; ++k)
+    {
+        new_ids[order[k]] = k;
+    }
+
+    for (Adjacency* adj : {&out, &in})
+    {
+        Adjacency renumbered;
+        renumbered.begin.resize(nb_nodes);
+        renumbered.end.resize(nb_nodes);
+        renumbered.edges.reserve(adj->edges.size() - adj->garbage);
+        for (size_t k = 0; k < nb_nodes; ++k)
+        {
+            renumbered.begin[k] = renumbered.edges.size();
+            for (const AffinityEdge& edge : adj->get(order[k]))
+            {
+                renumbered.edges.push_back({new_ids[edge.target], edge.value});
+            }
+            renumbered.end[k] = renumbered.edges.size();
+            std::sort(renumbered.edges.begin() + renumbered.begin[k], renumbered.edges.end(),
+                      affinity_edge_target_less);
+        }
+        *adj = std::move(renumbered);
+    }
+
+    std::vector<int> degrees(nb_nodes);
+    std::vector<int> dropped(nb_nodes);
+    for (size_t k = 0; k < nb_nodes; ++k)
+    {
+        degrees[k] = total_degrees[order[k]];
+        dropped[k] = dropped_degrees[order[k]];
+    }
+    total_degrees.swap(degrees);
+    dropped_degrees.swap(dropped);
+}
+
+std::vector<int> computeLocalityOrder(const AffinityGraph& graph, size_t nb_apps)
+{
+    auto degree_less = [&graph](int a, int b) {
+        return graph.getTotalDegree(a) < graph.getTotalDegree(b);
+    };
+    std::vector<int> starts(nb_apps);
+    std::iota(starts.begin(), starts.end(), 0);
+    std::stable_sort(starts.begin(), starts.end(), degree_less);
+
+    std::vector<int> order;
+    order.reserve(graph.getNbNodes());
+    std::vector<bool> visited(nb_apps, false);
+    for (int start : starts)
+    {
+        if (visited[start])
+        {
+            continue;
+        }
+        visited[start] = true;
+        order.push_back(start);
+        for (size_t head = order.size() - 1; head < order.size(); ++head)
+        {
+            int node = order[head];
+            size_t first = order.size();
+            for (AffinitySpan list : {graph.getOut(node), graph.getIn(node)})
+            {
+                for (const AffinityEdge& edge : list)
+                {
+                    if ((edge.target < (int)nb_apps) and !visited[edge.target])
+                    {
+                        visited[edge.target] = true;
+                        order.push_back(edge.target);
+                    }
+                }
+            }
+            std::stable_sort(order.begin() + first, order.end(), degree_less);
+        }
+    }
+    std::reverse(order.begin(), order.end());
+
+    for (size_t node = nb_apps; node < graph.getNbNodes(); ++node)
+    {
+        order.push_back(node);
+    }
+    return order;
+}
+
+
+AffinitySpan AffinityGraph::Adjacency::get(int node) const
+{
+    const AffinityEdge* data = edges.data();
+    return AffinitySpan(data + begin[node], data + end[node]);
+}
+
+void AffinityGraph::Adjacency::set(int node, const std::vector<AffinityEdge>& list)
+{
+    size_t old_size = end[node] - begin[node];
+    if (list.size() > old_size)
+    {
+        // Move the list at the end of the array
+        garbage += old_size;
+        begin[node] = edges.size();
+        edges.insert(edges.end(), list.begin(), list.end());
+    }
+    else
+    {
+        garbage += old_size - list.size();
+        std::copy(list.begin(), list.end(), edges.begin() + begin[node]);
+    }
+    end[node] = begin[node] + list.size();
+
+    if (garbage > edges.size() / 2)
+    {
+        compact();
+    }
+}
+
+void AffinityGraph::Adjacency::renameAndSort(int node, int a, int b)
+{
+    auto first = edges.begin() + begin[node];
+    auto last = edges.begin() + end[node];
+    for (auto it = first; it != last; ++it)
+    {
+        if (it->target == a)
+        {
+            it->target = b;
+        }
+        else if (it->target == b)
+        {
+            it->target = a;
+        }
+    }
+    std::sort(first, last, affinity_edge_target_less);
+}
+
+void AffinityGraph::Adjacency::compact()
+{
+    std::vector<AffinityEdge> compacted;
+    compacted.reserve(edges.size() - garbage);
+    for (size_t node = 0; node < begin.size(); ++node)
+    {
+        size_t new_begin = compacted.size();
+        compacted.insert(compacted.end(), edges.begin() + begin[node], edges.begin() + end[node]);
+        begin[node] = new_begin;
+        end[node] = compacted.size();
+    }
+    edges.swap(compacted);
+    garbage = 0;
+}
@@ -0,0 +1,110 @@
+#ifndef AFFINITY_GRAPH_HPP
+#define AFFINITY_GRAPH_HPP
+
+#include <cstddef>
+#include <vector>
+
+
+// Affinity value pair (app_b, k), app_b is the internal id of the other app
+struct AffinityEdge
+{
+    int target;
+    int value;
+};
+
+// Read-only view on the contiguous neighbours of one application
+// Only valid until the graph is updated
+class AffinitySpan
+{
+public:
+    AffinitySpan():
+        first(nullptr), last(nullptr)
+    { }
+    AffinitySpan(const AffinityEdge* first, const AffinityEdge* last):
+        first(first), last(last)
+    { }
+
+    const AffinityEdge* begin() const { return first; }
+    const AffinityEdge* end() const { return last; }
+    const size_t size() const { return last - first; }
+    const bool empty() const { return first == last; }
+
+private:
+    const AffinityEdge* first;
+    const AffinityEdge* last;
+};
+
+
+// Affinities of all applications of an instance in compressed sparse row
+// format, the neighbours of each node are sorted by target id
+// Out edges (app_b, k) of an app: it tolerates at most k replicas of app_b
+// In edges (app_b, k) of an app: at most k of its replicas are tolerated by app_b
+// The nodes are the apps (ids 0..nb_apps-1) followed by the ids only
+// referenced in affinity lists, which have no out edges.
+class AffinityGraph
+{
+public:
+    AffinityGraph();
+
+    // Build the graph of nb_apps apps from their affinity lists: the pairs
+    // of app i are edges[offsets[i]..offsets[i+1]] in the order of the list,
+    // a target repeated in a list keeps its last value
+    // Targets >= nb_nodes (filtered out apps) count in the total degree
+    // but are not stored
+    void build(size_t nb_apps, size_t nb_nodes,
+               const std::vector<size_t>& offsets, std::vector<AffinityEdge>& edges);
+
+    const size_t getNbNodes() const;
+    AffinitySpan getOut(int node) const;
+    AffinitySpan getIn(int node) const;
+    const int getTotalDegree(int node) const; // Number of distinct neighbours, in or out
+
+    // Incremental updates, in time proportional to the lists involved
+    int addNode(); // New last node without edges
+    void removeLastNode(); // The last node must have no edges
+    // Replace the affinity list of a node, edges given as for build()
+    // with nb_dropped pairs to filtered out apps
+    void setOut(int node, std::vector<AffinityEdge>& edges, int nb_dropped);
+    // The node is filtered out: its in edges are dropped from the other lists
+    void dropInEdges(int node);
+    void swapNodes(int a, int b);
+    // Node order[k] becomes node k, the lists are stored in the new order
+    void renumberNodes(const std::vector<int>& order);
+
+private:
+    // Lists of all nodes in a shared array, a list that grows is moved
+    // to the end of the array which is compacted once half of it is unused
+    struct Adjacency
+    {
+        std::vector<size_t> begin;
+        std::vector<size_t> end;
+        std::vector<AffinityEdge> edges;
+        size_t garbage = 0;
+
+        AffinitySpan get(int node) const;
+        void set(int node, const std::vector<AffinityEdge>& list);
+        void renameAndSort(int node, int a, int b);
+        void compact();
+    };
+
+    void updateTotalDegree(int node);
+
+    Adjacency out;
+    Adjacency in;
+    std::vector<int> total_degrees;
+    std::vector<int> dropped_degrees; // Targets of the out edges that are not stored
+};
+
+// Sort the pairs of an affinity list by target, keeping the last
+// value of repeated targets
+void sortAffinityList(std::vector<AffinityEdge>& edges);
+
+// Reverse Cuthill-McKee order of the apps over their in and out edges, so
+// that the neighbours of an app get close ids: each connected component is
+// visited in breadth-first order from a node of min degree, the neighbours
+// by increasing degree, and the whole order is reversed
+// Returns the order of all nodes for renumberNodes(), the nodes that are
+// not apps keep their ids
+std::vector<int> computeLocalityOrder(const AffinityGraph& graph, size_t nb_apps);
+
+#endif // AFFINITY_GRAPH_HPP
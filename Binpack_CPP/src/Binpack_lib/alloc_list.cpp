@@ -0,0 +1,115 @@
+#include "alloc_list.hpp"
+
+#include <algorithm>
+
+
+AllocList::AllocList():
+    records(inline_records),
+    nb_records(0),
+    capacity(INLINE_SIZE)
+{ }
+
+AllocList::AllocList(const AllocList& other):
+    records(inline_records),
+    nb_records(other.nb_records),
+    capacity(INLINE_SIZE)
+{
+    if (nb_records > INLINE_SIZE)
+    {
+        capacity = nb_records;
+        records = new AllocRecord[capacity];
+    }
+    std::copy(other.begin(), other.end(), records);
+}
+
+AllocList& AllocList::operator=(const AllocList& other)
+{
+    if (this == &other)
+    {
+        return *this;
+    }
+    if (other.nb_records > capacity)
+    {
+        if (records != inline_records)
+        {
+            delete[] records;
+        }
+        capacity = other.nb_records;
+        records = new AllocRecord[capacity];
+    }
+    nb_records = other.nb_records;
+    std::copy(other.begin(), other.end(), records);
+    return *this;
+}
+
+AllocList::~AllocList()
+{
+    if (records != inline_records)
+    {
+        delete[] records;
+    }
+}
+
+const size_t AllocList::size() const
+{
+    return nb_records;
+}
+
+const AllocRecord* AllocList::begin() const
+{
+    return records;
+}
+
+const AllocRecord* AllocList::end() const
+{
+    return records + nb_records;
+}
+
+AllocRecord* AllocList::find(int app) const
+{
+    return std::lower_bound(records, records + nb_records, app,
+        [](const AllocRecord& record, int app) { return record.app < app; });
+}
+
+const int AllocList::count(int app) const
+{
+    AllocRecord* it = find(app);
+    if ((it != end()) and (it->app == app))
+    {
+        return it->nb_replicas;
+    }
+    return 0;
+}
+
+void AllocList::clear()
+{
+    nb_records = 0;
+}
+
+bool AllocList::addReplica(int app)
+{
+    AllocRecord* it = find(app);
+    if ((it != end()) and (it->app == app))
+    {
+        it->nb_replicas += 1;
+        return false;
+    }
+
+    size_t pos = it - records;
+    if (nb_records == capacity)
+    {
+        // Move the records to a larger array on the heap
+        AllocRecord* new_records = new AllocRecord[2 * capacity];
+        std::copy(begin(), end(), new_records);
+        if (records != inline_records)
+        {
+            delete[] records;
+        }
+        records = new_records;
+        capacity = 2 * capacity;
+    }
+    std::copy_backward(records + pos, records + nb_records, records + nb_records + 1);
+    records[pos] = {app, 1};
+    nb_records += 1;
+    return true;
+}
@@ -0,0 +1,47 @@
+#ifndef ALLOC_LIST_HPP
+#define ALLOC_LIST_HPP
+
+#include <cstddef>
+
+
+// Number of replicas of an app packed in a bin
+struct AllocRecord
+{
+    int app; // Internal id of the app
+    int nb_replicas;
+};
+
+// Records of the apps packed in a bin, sorted by internal id
+// The first records are stored in the list itself, so the bins with a few
+// apps do not allocate and are copied with a single block
+class AllocList
+{
+public:
+    static const size_t INLINE_SIZE = 6;
+
+    AllocList();
+    AllocList(const AllocList& other);
+    AllocList& operator=(const AllocList& other);
+    ~AllocList();
+
+    const size_t size() const;
+    const AllocRecord* begin() const;
+    const AllocRecord* end() const;
+
+    // Number of replicas of the app in the bin, 0 if there is none
+    const int count(int app) const;
+
+    // Adds a replica of the app, returns true if it is the first one
+    bool addReplica(int app);
+    void clear(); // Keeps the array of the records
+
+private:
+    AllocRecord* find(int app) const;
+
+    AllocRecord* records; // inline_records, or an array on the heap
+    unsigned int nb_records;
+    unsigned int capacity;
+    AllocRecord inline_records[INLINE_SIZE];
+};
+
+#endif // ALLOC_LIST_HPP
@@ -0,0 +1,167 @@
+#include "app_table.hpp"
+
+#include <algorithm>
+
+
+AppTable::AppTable()
+{ }
+
+void AppTable::build(const AppList2D& apps)
+{
+    for (auto* column : {&nb_replicas, &cpu_sizes, &mem_sizes, &total_degrees})
+    {
+        column->clear();
+        column->reserve(apps.size());
+    }
+    for (auto* column : {&norm_cpus, &norm_memory, &max_sizes, &avg_sizes,
+                         &surrogate_sizes, &ext_sum_sizes, &avg_expo_sizes})
+    {
+        column->clear();
+        column->reserve(apps.size());
+    }
+    for (Application2D* app : apps)
+    {
+        nb_replicas.push_back(app->getNbReplicas());
+        cpu_sizes.push_back(app->getCPUSize());
+        mem_sizes.push_back(app->getMemorySize());
+        norm_cpus.push_back(app->getNormalizedCPU());
+        norm_memory.push_back(app->getNormalizedMemory());
+        total_degrees.push_back(app->getTotalDegree());
+        max_sizes.push_back(app->getMaxSize());
+        avg_sizes.push_back(app->getAvgSize());
+        surrogate_sizes.push_back(app->getSurrogate());
+        ext_sum_sizes.push_back(app->getExtSum());
+        avg_expo_sizes.push_back(app->getAvgExpoSize());
+    }
+}
+
+void AppTable::setTotalDegree(int app, int total_degree)
+{
+    total_degrees[app] = total_degree;
+}
+
+const size_t AppTable::size() const
+{
+    return nb_replicas.size();
+}
+
+const int AppTable::getNbReplicas(int app) const
+{
+    return nb_replicas[app];
+}
+
+const int AppTable::getCPUSize(int app) const
+{
+    return cpu_sizes[app];
+}
+
+const int AppTable::getMemorySize(int app) const
+{
+    return mem_sizes[app];
+}
+
+const float AppTable::getNormalizedCPU(int app) const
+{
+    return norm_cpus[app];
+}
+
+const float AppTable::getNormalizedMemory(int app) const
+{
+    return norm_memory[app];
+}
+
+const int AppTable::getTotalDegree(int app) const
+{
+    return total_degrees[app];
+}
+
+template<typename T>
+static void sortByKeyDecreasing(AppIndexList::iterator first, AppIndexList::iterator last, const std::vector<T>& keys)
+{
+    const T* key = keys.data();
+    std::stable_sort(first, last, [key](int a, int b) { return key[a] > key[b]; });
+}
+
+void AppTable::sortDecreasing(AppIndexList::iterator first, AppIndexList::iterator last, AppSortKey key) const
+{
+    switch (key)
+    {
+    case AppSortKey::TotalDegree:
+        sortByKeyDecreasing(first, last, total_degrees);
+        break;
+    case AppSortKey::CPU:
+        sortByKeyDecreasing(first, last, cpu_sizes);
+        break;
+    case AppSortKey::MaxSize:
+        sortByKeyDecreasing(first, last, max_sizes);
+        break;
+    case AppSortKey::AvgSize:
+        sortByKeyDecreasing(first, last, avg_sizes);
+        break;
+    case AppSortKey::Surrogate:
+        sortByKeyDecreasing(first, last, surrogate_sizes);
+        break;
+    case AppSortKey::ExtSum:
+        sortByKeyDecreasing(first, last, ext_sum_sizes);
+        break;
+    case AppSortKey::AvgExpo:
+        sortByKeyDecreasing(first, last, avg_expo_sizes);
+        break;
+    }
+}
+
+AppMeasures::AppMeasures(size_t nb_apps):
+    measures(nb_apps, 0.0),
+    fully_packed(nb_apps, false)
+{ }
+
+void AppMeasures::setMeasure(int app, float measure)
+{
+    measures[app] = measure;
+}
+
+const float AppMeasures::getMeasure(int app) const
+{
+    return measures[app];
+}
+
+void AppMeasures::bubbleMeasureUp(AppIndexList::iterator first, AppIndexList::iterator last, bool increasing) const
+{
+    if (first == last)
+        return; // Maybe first is also at the end
+    --last; // last MUST point to the end of the vector
+    // In case only one element
+    if (first == last)
+        return;
+
+    const float* measure = measures.data();
+    auto comp = [measure, increasing](int a, int b) {
+        return increasing ? (measure[a] < measure[b]) : (measure[a] > measure[b]);
+    };
+    auto current = last;
+    auto previous = last-1;
+    while(first != previous)
+    {
+        if (comp(*current, *previous))
+        {
+            std::iter_swap(current, previous);
+        }
+        --current;
+        --previous;
+    }
+    // One last time at the head of the vector
+    if (comp(*current, *previous))
+    {
+        std::iter_swap(current, previous);
+    }
+}
+
+void AppMeasures::setFullyPacked(int app, bool val)
+{
+    fully_packed[app] = val;
+}
+
+const bool AppMeasures::isFullyPacked(int app) const
+{
+    return fully_packed[app];
+}
@@ -0,0 +1,86 @@
+#ifndef APP_TABLE_HPP
+#define APP_TABLE_HPP
+
+#include "application.hpp"
+
+#include <vector>
+
+
+// Permutation of the apps of an AppTable, by internal id
+using AppIndexList = std::vector<int>;
+
+// Keys of the decreasing sorts of the apps
+enum class AppSortKey
+{
+    TotalDegree,
+    CPU,
+    MaxSize,
+    AvgSize,
+    Surrogate,
+    ExtSum,
+    AvgExpo
+};
+
+// Applications of a 2D instance in parallel arrays indexed by internal id,
+// the sizes and sort keys of the apps once their params are set
+// Built once by the instance and shared by its algorithms, which sort and
+// scan permutations of the indexes, so the keys of consecutive apps are
+// read from contiguous arrays instead of one object each
+class AppTable
+{
+public:
+    AppTable();
+
+    // Rows of all the apps, to call again when their params change
+    void build(const AppList2D& apps);
+    // After the degree of an app changes, e.g. with new affinities
+    void setTotalDegree(int app, int total_degree);
+
+    const size_t size() const;
+    const int getNbReplicas(int app) const;
+    const int getCPUSize(int app) const;
+    const int getMemorySize(int app) const;
+    const float getNormalizedCPU(int app) const;
+    const float getNormalizedMemory(int app) const;
+    const int getTotalDegree(int app) const;
+
+    // Stable sort by decreasing key, as the application2D comparators
+    void sortDecreasing(AppIndexList::iterator first, AppIndexList::iterator last, AppSortKey key) const;
+
+private:
+    std::vector<int> nb_replicas;
+    std::vector<int> cpu_sizes;
+    std::vector<int> mem_sizes;
+    std::vector<float> norm_cpus;
+    std::vector<float> norm_memory;
+    std::vector<int> total_degrees;
+
+    std::vector<float> max_sizes;
+    std::vector<float> avg_sizes;
+    std::vector<float> surrogate_sizes;
+    std::vector<float> ext_sum_sizes;
+    std::vector<float> avg_expo_sizes;
+};
+
+// Measures and packing state of the apps updated by one algorithm, indexed
+// by internal id as the AppTable of the instance
+class AppMeasures
+{
+public:
+    AppMeasures(size_t nb_apps);
+
+    void setMeasure(int app, float measure);
+    const float getMeasure(int app) const;
+    // One round of bubble upwards by increasing or decreasing measure,
+    // as bubble_apps2D_up
+    void bubbleMeasureUp(AppIndexList::iterator first, AppIndexList::iterator last, bool increasing) const;
+
+    void setFullyPacked(int app, bool val);
+    const bool isFullyPacked(int app) const;
+
+private:
+    std::vector<float> measures;
+    std::vector<char> fully_packed;
+};
+
+#endif // APP_TABLE_HPP
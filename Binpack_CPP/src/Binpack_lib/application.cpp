@@ -1,18 +1,19 @@
 #include "application.hpp"
 
 #include <cmath>
-#include <unordered_set>
+#include <utility>
 
 Application2D::Application2D(std::string& app_id, int internal_id,
               int nb_replicas, int nb_cpus, int nb_memory,
-              int affinity_degree, AffinityMap& affinities_out):
+              int affinity_degree):
     id(app_id),
     internal_id(internal_id),
     nb_replicas(nb_replicas),
     nb_cpus(nb_cpus),
     nb_memory(nb_memory),
+    fully_packed(false),
+    affinity_graph(nullptr),
     affinity_out_degree(affinity_degree),
-    affinity_out_map(affinities_out),
     measure(0.0)
 { }
 
@@ -48,12 +49,20 @@ const float Application2D::getNormalizedCPU() const
 
 const int Application2D::getOutDegree() const
 {
-    return affinity_out_degree;
+    if (affinity_graph == nullptr)
+    {
+        return affinity_out_degree;
+    }
+    return affinity_graph->getOut(internal_id).size();
 }
 
 const int Application2D::getTotalDegree() const
 {
-    return affinity_total_degree;
+    if (affinity_graph == nullptr)
+    {
+        return affinity_out_degree;
+    }
+    return affinity_graph->getTotalDegree(internal_id);
 }
 
 const int Application2D::getNbReplicas() const
@@ -61,53 +70,50 @@ const int Application2D::getNbReplicas() const
     return nb_replicas;
 }
 
-const AffinityMap& Application2D::getAffinityOutMap() const
+AffinitySpan Application2D::getAffinityOut() const
 {
-    return affinity_out_map;
+    if (affinity_graph == nullptr)
+    {
+        return AffinitySpan();
+    }
+    return affinity_graph->getOut(internal_id);
 }
 
-const AffinityMap& Application2D::getAffinityInMap() const
+AffinitySpan Application2D::getAffinityIn() const
 {
-    return affinity_in_map;
+    if (affinity_graph == nullptr)
+    {
+        return AffinitySpan();
+    }
+    return affinity_graph->getIn(internal_id);
 }
 
-void Application2D::removeAppsAffinity(std::vector<std::string>& to_remove)
+void Application2D::setAffinityGraph(const AffinityGraph* graph)
 {
-    for (std::string& app_str : to_remove)
-    {
-        affinity_in_map.erase(app_str);
-        affinity_out_map.erase(app_str);
-    }
-    affinity_out_degree = affinity_out_map.size();
+    affinity_graph = graph;
 }
 
-void Application2D::setAffinityInMap(AffinityMap& affinities_in)
+void Application2D::setInternalId(int internal_id)
 {
-    affinity_in_map = affinities_in;
+    this->internal_id = internal_id;
+}
 
-    std::unordered_set<std::string> neighbours;
-    for (auto pair : affinity_out_map)
-    {
-        neighbours.insert(pair.first);
-    }
-    for(auto pair : affinity_in_map)
-    {
-        neighbours.insert(pair.first);
-    }
-    affinity_total_degree = neighbours.size();
+void Application2D::setNbReplicas(int nb_replicas)
+{
+    this->nb_replicas = nb_replicas;
 }
 
 
 std::string Application2D::toString(bool full) const
 {
     std::string s(id);
-    s+= ": " + std::to_string(nb_replicas) + "\treplicas, " + std::to_string(nb_cpus) + " cores, " + std::to_string(nb_memory) + " memory and degree " + std::to_string(affinity_out_degree);
+    s+= ": " + std::to_string(nb_replicas) + "\treplicas, " + std::to_string(nb_cpus) + " cores, " + std::to_string(nb_memory) + " memory and degree " + std::to_string(getOutDegree());
     if (full)
     {
         s+= ":\n\t";
-        for (auto pair : affinity_out_map)
+        for (const AffinityEdge& edge : getAffinityOut())
         {
-            s+= "(" + pair.first + ", " + std::to_string(pair.second) + "), ";
+            s+= "(" + std::to_string(edge.target) + ", " + std::to_string(edge.value) + "), ";
         }
     }
     return s;
@@ -177,6 +183,18 @@ const bool Application2D::isFullyPacked() const
 
 
 
+Application2D* getApp2D(const AppList2D& list, int internal_id)
+{
+    for (Application2D* app : list)
+    {
+        if (app->getInternalId() == internal_id)
+        {
+            return app;
+        }
+    }
+    return nullptr;
+}
+
 Application2D* getApp2D(const AppList2D& list, const std::string& app_id)
 {
     auto it = list.begin();
@@ -296,38 +314,132 @@ void bubble_apps2D_up(AppList2D::iterator first, AppList2D::iterator last, bool
 
 ApplicationTS::ApplicationTS(std::string& app_id, int internal_id,
                              int nb_replicas, size_t size_TS,
-                             ResourceTS& cpu_usage, ResourceTS& mem_usage,
+                             ResourceTS&& cpu_usage, ResourceTS&& mem_usage,
                              float peak_cpu, float peak_mem,
-                             int affinity_degree, AffinityMap& affinities):
-    Application2D(app_id, internal_id, nb_replicas, 0, 0, affinity_degree, affinities),
+                             int affinity_degree):
+    Application2D(app_id, internal_id, nb_replicas, 0, 0, affinity_degree),
     TS_size(size_TS),
+    cpu_storage(std::move(cpu_usage)),
+    mem_storage(std::move(mem_usage)),
+    bin_cpu_cap(1.0),
+    bin_mem_cap(1.0),
+    peak_cpu(peak_cpu),
+    peak_mem(peak_mem)
+{
+    this->cpu_usage = SeriesSpan(cpu_storage.data(), TS_size);
+    this->mem_usage = SeriesSpan(mem_storage.data(), TS_size);
+    initSeries(cpu_storage, this->cpu_usage, cpu_shape, cpu_envelope);
+    initSeries(mem_storage, this->mem_usage, mem_shape, mem_envelope);
+}
+
+ApplicationTS::ApplicationTS(std::string& app_id, int internal_id,
+                             int nb_replicas, SeriesSpan cpu_usage, SeriesSpan mem_usage,
+                             float peak_cpu, float peak_mem,
+                             int affinity_degree):
+    Application2D(app_id, internal_id, nb_replicas, 0, 0, affinity_degree),
+    TS_size(cpu_usage.size()),
     cpu_usage(cpu_usage),
     mem_usage(mem_usage),
+    bin_cpu_cap(1.0),
+    bin_mem_cap(1.0),
     peak_cpu(peak_cpu),
-    peak_mem(peak_mem),
-    norm_cpus_TS(size_TS, 0.0),
-    norm_memory_TS(size_TS, 0.0)
-{ }
+    peak_mem(peak_mem)
+{
+    initSeries(cpu_storage, this->cpu_usage, cpu_shape, cpu_envelope);
+    initSeries(mem_storage, this->mem_usage, mem_shape, mem_envelope);
+}
+
+void ApplicationTS::initSeries(ResourceTS& storage, SeriesSpan& usage, SeriesShape& shape, SeriesEnvelope& envelope)
+{
+    shape = SeriesShape(usage.data(), TS_size);
+    if (shape.getKind() == SeriesShapeKind::Constant)
+    {
+        // Only the first value is kept, or read in a mapped file
+        if (!storage.empty())
+        {
+            storage.resize(1);
+            storage.shrink_to_fit();
+        }
+        const float* first = storage.empty() ? usage.data() : storage.data();
+        usage = SeriesSpan(first, TS_size, true);
+    }
+    else
+    {
+        envelope = SeriesEnvelope(usage.data(), TS_size, true);
+    }
+}
 
 
-const ResourceTS& ApplicationTS::getCpuUsage() const
+SeriesSpan ApplicationTS::getCpuUsage() const
 {
     return cpu_usage;
 }
 
-const ResourceTS& ApplicationTS::getMemUsage() const
+SeriesSpan ApplicationTS::getMemUsage() const
 {
     return mem_usage;
 }
 
-const ResourceTS& ApplicationTS::getNormCpuUsage() const
+ScaledSeries ApplicationTS::getNormCpuUsage() const
+{
+    return ScaledSeries(cpu_usage, bin_cpu_cap);
+}
+
+ScaledSeries ApplicationTS::getNormMemUsage() const
+{
+    return ScaledSeries(mem_usage, bin_mem_cap);
+}
+
+const SeriesShape& ApplicationTS::getCpuShape() const
+{
+    return cpu_shape;
+}
+
+const SeriesShape& ApplicationTS::getMemShape() const
+{
+    return mem_shape;
+}
+
+const SeriesEnvelope& ApplicationTS::getCpuEnvelope() const
+{
+    return cpu_envelope;
+}
+
+const SeriesEnvelope& ApplicationTS::getMemEnvelope() const
 {
-    return norm_cpus_TS;
+    return mem_envelope;
 }
 
-const ResourceTS& ApplicationTS::getNormMemUsage() const
+const FixedSeries& ApplicationTS::getFixedCpuUsage() const
 {
-    return norm_memory_TS;
+    return cpu_fixed;
+}
+
+const FixedSeries& ApplicationTS::getFixedMemUsage() const
+{
+    return mem_fixed;
+}
+
+void ApplicationTS::setPrecision(SeriesPrecision precision)
+{
+    if (precision == SeriesPrecision::Float)
+    {
+        cpu_fixed = FixedSeries();
+        mem_fixed = FixedSeries();
+    }
+    else
+    {
+        // From the whole series, also for the constant ones
+        ResourceTS cpu_values(TS_size);
+        ResourceTS mem_values(TS_size);
+        for (size_t i = 0; i < TS_size; ++i)
+        {
+            cpu_values[i] = cpu_usage[i];
+            mem_values[i] = mem_usage[i];
+        }
+        cpu_fixed = FixedSeries(cpu_values.data(), TS_size, bin_cpu_cap, precision);
+        mem_fixed = FixedSeries(mem_values.data(), TS_size, bin_mem_cap, precision);
+    }
 }
 
 void ApplicationTS::setParams(ResourceTS& sum_cpu, ResourceTS& sum_mem,
@@ -346,12 +458,14 @@ void ApplicationTS::setParams(ResourceTS& sum_cpu, ResourceTS& sum_mem,
     avg_expo_size = 0.0;
 
     max_size = std::max((peak_cpu / bin_cpu_cap), (peak_mem / bin_mem_cap));
+    this->bin_cpu_cap = bin_cpu_cap;
+    this->bin_mem_cap = bin_mem_cap;
+    ScaledSeries norm_cpus_TS = getNormCpuUsage();
+    ScaledSeries norm_memory_TS = getNormMemUsage();
 
     // For each dimension in the time series
     for(int i = 0; i < TS_size; ++i)
     {
-        norm_cpus_TS[i] = cpu_usage[i] / bin_cpu_cap;
-        norm_memory_TS[i] = mem_usage[i] / bin_mem_cap;
         lambda_cpu[i] = (sum_cpu[i] / total_sum_cpu_mem);
         lambda_mem[i] = (sum_mem[i] / total_sum_cpu_mem);
         weight_cpu[i] = (sum_cpu[i] / (total_replicas * bin_cpu_cap));
@@ -1,9 +1,13 @@
 #ifndef APPLICATION_HPP
 #define APPLICATION_HPP
 
+#include "affinity_graph.hpp"
+#include "fixed_series.hpp"
+#include "series_envelope.hpp"
+#include "series_shape.hpp"
+
 #include <vector>
 #include <string>
-#include <unordered_map>
 
 
 class Application2D;
@@ -11,11 +15,49 @@ class ApplicationTS;
 
 using AppList2D = std::vector<Application2D*>;
 
-using AffinityMap = std::unordered_map<std::string, int>;
-
 using AppListTS = std::vector<ApplicationTS*>;
 using ResourceTS = std::vector<float>; // A time series of resource consumption
 
+// Read-only view on a time series, owned by the application or stored in
+// a memory-mapped instance file
+// A constant series only needs its first value, all its indexes read it
+class SeriesSpan
+{
+public:
+    SeriesSpan():
+        first(nullptr), count(0), index_mask(~size_t(0))
+    { }
+    SeriesSpan(const float* first, size_t count, bool constant = false):
+        first(first), count(count), index_mask(constant ? 0 : ~size_t(0))
+    { }
+
+    const float* data() const { return first; } // Only the first value if constant
+    const size_t size() const { return count; }
+    const bool isConstant() const { return index_mask == 0; }
+    float operator[](size_t i) const { return first[i & index_mask]; }
+
+private:
+    const float* first;
+    size_t count;
+    size_t index_mask;
+};
+
+// Time series divided by a bin capacity, computed on demand: each value
+// is the one that would be stored by dividing the series once
+class ScaledSeries
+{
+public:
+    ScaledSeries(SeriesSpan series, float capacity):
+        series(series), capacity(capacity)
+    { }
+
+    const size_t size() const { return series.size(); }
+    float operator[](size_t i) const { return series[i] / capacity; }
+
+private:
+    SeriesSpan series;
+    float capacity;
+};
 
 
 class Application2D
@@ -23,7 +65,8 @@ class Application2D
 public:
     Application2D(std::string& app_id, int internal_id,
                   int nb_replicas, int nb_cpus, int nb_memory,
-                  int affinity_degree, AffinityMap& affinities);
+                  int affinity_degree);
+    virtual ~Application2D() = default; // Deleted through AppList2D
 
     const std::string& getId() const;
     const int getInternalId() const;
@@ -36,11 +79,14 @@ public:
 
     const int getOutDegree() const;
     const int getTotalDegree() const;
-    const AffinityMap& getAffinityOutMap() const;
-    const AffinityMap& getAffinityInMap() const;
+    // Neighbours keyed by internal id, the string ids are only used for input/output
+    AffinitySpan getAffinityOut() const;
+    AffinitySpan getAffinityIn() const;
 
-    void removeAppsAffinity(std::vector<std::string>& to_remove);
-    void setAffinityInMap(AffinityMap& affinities_in);
+    // The affinities and degrees are then read from the graph of the instance
+    void setAffinityGraph(const AffinityGraph* graph);
+    void setInternalId(int internal_id);
+    void setNbReplicas(int nb_replicas);
 
     virtual void setParams(float sum_cpu, float sum_mem, int total_replicas,
                    int bin_cpu_cap, int bin_mem_cap);
@@ -66,12 +112,10 @@ protected:
     float norm_memory; // = nb_memory / bin_memory_capacity
     bool fully_packed;
 
-    AffinityMap affinity_out_map; // map of affinity value pairs (app_b, k) of this item
-        // Meaning that this item tolerates at most k replicas of app_b in the same bin
-    AffinityMap affinity_in_map;  // map of affinity value pairs (app_b, k) from other items to this one
-        // Meaning that at most k replicas of this item are tolerated by app_b in the same bin
-    int affinity_out_degree; // size of the affinity out map
-    int affinity_total_degree;// total number of neighbors (either in or out) <= (in_degree + out_degree)
+    const AffinityGraph* affinity_graph; // Out and in affinity value pairs (app_b, k) of this item
+        // Out: this item tolerates at most k replicas of app_b in the same bin
+        // In: at most k replicas of this item are tolerated by app_b in the same bin
+    int affinity_out_degree; // declared degree, until the affinity graph is set
 
     float avg_size;
     float max_size;
@@ -83,6 +127,7 @@ protected:
 };
 
 Application2D* getApp2D(const AppList2D& list, const std::string& app_id);
+Application2D* getApp2D(const AppList2D& list, int internal_id);
 
 bool application2D_comparator_total_degree_decreasing(Application2D* appa, Application2D* appb);
 bool application2D_comparator_CPU_decreasing(Application2D* appa, Application2D* appb);
@@ -104,29 +149,61 @@ void bubble_apps2D_up(AppList2D::iterator first, AppList2D::iterator last, bool
 class ApplicationTS : public Application2D
 {
 public:
+    // The application owns its series
     ApplicationTS(std::string& app_id, int internal_id,
                   int nb_replicas, size_t size_TS,
-                  ResourceTS& cpu_usage, ResourceTS& mem_usage,
+                  ResourceTS&& cpu_usage, ResourceTS&& mem_usage,
                   float peak_cpu, float peak_mem,
-                  int affinity_degree, AffinityMap& affinities);
-
-    const ResourceTS& getCpuUsage() const;
-    const ResourceTS& getMemUsage() const;
-    const ResourceTS& getNormCpuUsage() const;
-    const ResourceTS& getNormMemUsage() const;
-
+                  int affinity_degree);
+    // The series are stored elsewhere, e.g. in a memory-mapped instance
+    // file, and must outlive the application
+    ApplicationTS(std::string& app_id, int internal_id,
+                  int nb_replicas, SeriesSpan cpu_usage, SeriesSpan mem_usage,
+                  float peak_cpu, float peak_mem,
+                  int affinity_degree);
+
+    // The spans point to the series owned by the application
+    ApplicationTS(const ApplicationTS& other) = delete;
+    ApplicationTS& operator=(const ApplicationTS& other) = delete;
+
+    SeriesSpan getCpuUsage() const;
+    SeriesSpan getMemUsage() const;
+    ScaledSeries getNormCpuUsage() const;
+    ScaledSeries getNormMemUsage() const;
+    // Class and runs of the series, constant series only store one value
+    const SeriesShape& getCpuShape() const;
+    const SeriesShape& getMemShape() const;
+    // Min and max of the series over windows, for the fit checks, empty
+    // for constant series
+    const SeriesEnvelope& getCpuEnvelope() const;
+    const SeriesEnvelope& getMemEnvelope() const;
+    // Series scaled to the bin capacities, empty with SeriesPrecision::Float
+    const FixedSeries& getFixedCpuUsage() const;
+    const FixedSeries& getFixedMemUsage() const;
 
     void setParams(ResourceTS& sum_cpu, ResourceTS& sum_mem,
                    float total_sum_cpu_mem,
                    int total_replicas,
                    int bin_cpu_cap, int bin_mem_cap);
+    // Compute the fixed-point series, after the params
+    void setPrecision(SeriesPrecision precision);
 
 private:
+    void initSeries(ResourceTS& storage, SeriesSpan& usage, SeriesShape& shape, SeriesEnvelope& envelope);
+
     size_t TS_size;           // The size of the time series
-    ResourceTS cpu_usage;     // Time series of cpu usage
-    ResourceTS mem_usage;     // Time series of memory usage
-    ResourceTS norm_cpus_TS;     // Time series of normalised cpu usage
-    ResourceTS norm_memory_TS;   // Time series of normalised memory usage
+    ResourceTS cpu_storage;   // Series owned by the application, if any
+    ResourceTS mem_storage;
+    SeriesSpan cpu_usage;     // Time series of cpu usage
+    SeriesSpan mem_usage;     // Time series of memory usage
+    SeriesShape cpu_shape;
+    SeriesShape mem_shape;
+    SeriesEnvelope cpu_envelope;
+    SeriesEnvelope mem_envelope;
+    float bin_cpu_cap;        // Capacities normalising the series, set with the params
+    float bin_mem_cap;
+    FixedSeries cpu_fixed;    // Series used by the fit checks of fixed-point bins
+    FixedSeries mem_fixed;
     float peak_cpu;           // Max requirement of cpu usage
     float peak_mem;           // MAx requirement of memory usage
 };
@@ -0,0 +1,113 @@
+#ifndef BIN_ARENA_HPP
+#define BIN_ARENA_HPP
+
+#include <cstddef>
+#include <new>
+#include <utility>
+#include <vector>
+
+
+// Storage of the bins of an algorithm, in chunks of CHUNK_SIZE bins which
+// are never moved, so the bins keep their address and are identified by
+// their handle, the index of their creation since the last reset
+// reset() does not free the bins: the next bins created reuse them in
+// place (BinType::reset, or the copy assignment for a copy), with the
+// vectors of their capacities, so a new solution of about the same number
+// of bins does not call the allocator
+template<typename BinType>
+class BinArena
+{
+public:
+    static const size_t CHUNK_SIZE = 256;
+
+    BinArena():
+        nb_used(0),
+        nb_constructed(0)
+    { }
+    BinArena(const BinArena& other) = delete;
+    BinArena& operator=(const BinArena& other) = delete;
+
+    ~BinArena()
+    {
+        for (size_t handle = 0; handle < nb_constructed; ++handle)
+        {
+            get(handle)->~BinType();
+        }
+        for (BinType* chunk : chunks)
+        {
+            ::operator delete(static_cast<void*>(chunk));
+        }
+    }
+
+    const size_t size() const
+    {
+        return nb_used;
+    }
+
+    BinType* get(size_t handle) const
+    {
+        return chunks[handle / CHUNK_SIZE] + (handle % CHUNK_SIZE);
+    }
+
+    // New bin constructed from args, returns its handle
+    template<typename... Args>
+    size_t create(Args&&... args)
+    {
+        if (nb_used < nb_constructed)
+        {
+            get(nb_used)->reset(std::forward<Args>(args)...);
+        }
+        else
+        {
+            new (newSlot()) BinType(std::forward<Args>(args)...);
+            nb_constructed += 1;
+        }
+        return nb_used++;
+    }
+
+    // New copy of a bin, returns its handle
+    size_t createCopy(const BinType& other)
+    {
+        if (nb_used < nb_constructed)
+        {
+            *get(nb_used) = other;
+        }
+        else
+        {
+            new (newSlot()) BinType(other);
+            nb_constructed += 1;
+        }
+        return nb_used++;
+    }
+
+    // Exchanges the bins of both arenas, the bins keep their address
+    void swap(BinArena& other)
+    {
+        chunks.swap(other.chunks);
+        std::swap(nb_used, other.nb_used);
+        std::swap(nb_constructed, other.nb_constructed);
+    }
+
+    // All handles become invalid, the bins are kept for the next ones
+    void reset()
+    {
+        nb_used = 0;
+    }
+
+private:
+    // Storage of the next bin to construct
+    void* newSlot()
+    {
+        if (nb_constructed == chunks.size() * CHUNK_SIZE)
+        {
+            chunks.push_back(static_cast<BinType*>(::operator new(CHUNK_SIZE * sizeof(BinType))));
+        }
+        return get(nb_constructed);
+    }
+
+    std::vector<BinType*> chunks;
+    size_t nb_used;        // Bins of the handles given since the last reset
+    size_t nb_constructed; // Bins constructed in the chunks, nb_used first ones in use
+};
+
+#endif // BIN_ARENA_HPP
@@ -0,0 +1,253 @@
+#include "bin_pool.hpp"
+
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
+#include <new>
+
+#if defined(__x86_64__) && defined(__GNUC__) && !defined(BINPACK_NO_SIMD)
+#define BIN_POOL_AVX2
+#include <immintrin.h>
+#endif
+
+static const size_t BLOCK_SIZE = 8; // Bins per AVX2 register of ints
+static const size_t LEAF_SIZE = 32; // Bins per leaf of the tree, a whole number of blocks
+static const size_t ALIGNMENT = 32;
+static const int NO_CAPACITY = INT_MIN; // Maxima of the leaves without bins
+
+
+static size_t findFirstFitScalar(const int* cpus, const int* mems, size_t first, size_t last, int cpu, int mem)
+{
+    for (size_t i = first; i < last; ++i)
+    {
+        if ((cpus[i] >= cpu) and (mems[i] >= mem))
+        {
+            return i;
+        }
+    }
+    return last;
+}
+
+#ifdef BIN_POOL_AVX2
+__attribute__((target("avx2")))
+static size_t findFirstFitAVX2(const int* cpus, const int* mems, size_t first, size_t last, int cpu, int mem)
+{
+    // Scalar scan up to the first aligned block
+    size_t i = std::min((first + BLOCK_SIZE - 1) & ~(BLOCK_SIZE - 1), last);
+    size_t found = findFirstFitScalar(cpus, mems, first, i, cpu, mem);
+    if (found < i)
+    {
+        return found;
+    }
+
+    // A bin fits unless the cpu or the mem asked is greater than its residual
+    __m256i cpu_vec = _mm256_set1_epi32(cpu);
+    __m256i mem_vec = _mm256_set1_epi32(mem);
+    for (; i + BLOCK_SIZE <= last; i += BLOCK_SIZE)
+    {
+        __m256i cpus_vec = _mm256_load_si256(reinterpret_cast<const __m256i*>(cpus + i));
+        __m256i mems_vec = _mm256_load_si256(reinterpret_cast<const __m256i*>(mems + i));
+        __m256i too_small = _mm256_or_si256(_mm256_cmpgt_epi32(cpu_vec, cpus_vec),
+                                            _mm256_cmpgt_epi32(mem_vec, mems_vec));
+        int fit_mask = ~_mm256_movemask_ps(_mm256_castsi256_ps(too_small)) & 0xFF;
+        if (fit_mask != 0)
+        {
+            return i + __builtin_ctz(fit_mask);
+        }
+    }
+    return findFirstFitScalar(cpus, mems, i, last, cpu, mem);
+}
+#endif
+
+
+BinPool::BinPool():
+    available_cpus(nullptr),
+    available_mems(nullptr),
+    nb_bins(0),
+    capacity(0),
+    use_avx2(false),
+    nb_leaves(0)
+{
+#ifdef BIN_POOL_AVX2
+    use_avx2 = __builtin_cpu_supports("avx2");
+#endif
+}
+
+BinPool::~BinPool()
+{
+    std::free(available_cpus);
+    std::free(available_mems);
+}
+
+const size_t BinPool::size() const
+{
+    return nb_bins;
+}
+
+void BinPool::clear()
+{
+    nb_bins = 0;
+    std::fill(tree_max_cpu.begin(), tree_max_cpu.end(), NO_CAPACITY);
+    std::fill(tree_max_mem.begin(), tree_max_mem.end(), NO_CAPACITY);
+}
+
+void BinPool::reserve(size_t new_capacity)
+{
+    // A whole number of blocks, as aligned_alloc needs
+    new_capacity = (new_capacity + BLOCK_SIZE - 1) & ~(BLOCK_SIZE - 1);
+    int* new_cpus = static_cast<int*>(std::aligned_alloc(ALIGNMENT, new_capacity * sizeof(int)));
+    int* new_mems = static_cast<int*>(std::aligned_alloc(ALIGNMENT, new_capacity * sizeof(int)));
+    if ((new_cpus == nullptr) or (new_mems == nullptr))
+    {
+        std::free(new_cpus);
+        std::free(new_mems);
+        throw std::bad_alloc();
+    }
+    std::copy(available_cpus, available_cpus + nb_bins, new_cpus);
+    std::copy(available_mems, available_mems + nb_bins, new_mems);
+    std::free(available_cpus);
+    std::free(available_mems);
+    available_cpus = new_cpus;
+    available_mems = new_mems;
+    capacity = new_capacity;
+}
+
+void BinPool::addBin(int available_cpu, int available_mem)
+{
+    if (nb_bins == capacity)
+    {
+        reserve(std::max(2 * capacity, 4 * BLOCK_SIZE));
+    }
+    available_cpus[nb_bins] = available_cpu;
+    available_mems[nb_bins] = available_mem;
+    nb_bins += 1;
+
+    size_t leaf = (nb_bins - 1) / LEAF_SIZE;
+    if (leaf >= nb_leaves)
+    {
+        buildTree(2 * (leaf + 1));
+    }
+    else
+    {
+        updateLeaf(leaf);
+    }
+}
+
+void BinPool::setAvailable(size_t index, int available_cpu, int available_mem)
+{
+    available_cpus[index] = available_cpu;
+    available_mems[index] = available_mem;
+    updateLeaf(index / LEAF_SIZE);
+}
+
+void BinPool::updateLeaf(size_t leaf)
+{
+    size_t first = leaf * LEAF_SIZE;
+    size_t last = std::min(first + LEAF_SIZE, nb_bins);
+    size_t node = nb_leaves + leaf;
+    tree_max_cpu[node] = *std::max_element(available_cpus + first, available_cpus + last);
+    tree_max_mem[node] = *std::max_element(available_mems + first, available_mems + last);
+
+    // Update the maxima of the ancestors, until one does not change
+    node /= 2;
+    while (node >= 1)
+    {
+        int max_cpu = std::max(tree_max_cpu[2 * node], tree_max_cpu[2 * node + 1]);
+        int max_mem = std::max(tree_max_mem[2 * node], tree_max_mem[2 * node + 1]);
+        if ((max_cpu == tree_max_cpu[node]) and (max_mem == tree_max_mem[node]))
+        {
+            break;
+        }
+        tree_max_cpu[node] = max_cpu;
+        tree_max_mem[node] = max_mem;
+        node /= 2;
+    }
+}
+
+void BinPool::buildTree(size_t min_nb_leaves)
+{
+    nb_leaves = 1;
+    while (nb_leaves < min_nb_leaves)
+    {
+        nb_leaves *= 2;
+    }
+    tree_max_cpu.assign(2 * nb_leaves, NO_CAPACITY);
+    tree_max_mem.assign(2 * nb_leaves, NO_CAPACITY);
+
+    size_t nb_used_leaves = (nb_bins + LEAF_SIZE - 1) / LEAF_SIZE;
+    for (size_t leaf = 0; leaf < nb_used_leaves; ++leaf)
+    {
+        size_t first = leaf * LEAF_SIZE;
+        size_t last = std::min(first + LEAF_SIZE, nb_bins);
+        tree_max_cpu[nb_leaves + leaf] = *std::max_element(available_cpus + first, available_cpus + last);
+        tree_max_mem[nb_leaves + leaf] = *std::max_element(available_mems + first, available_mems + last);
+    }
+    for (size_t node = nb_leaves - 1; node >= 1; --node)
+    {
+        tree_max_cpu[node] = std::max(tree_max_cpu[2 * node], tree_max_cpu[2 * node + 1]);
+        tree_max_mem[node] = std::max(tree_max_mem[2 * node], tree_max_mem[2 * node + 1]);
+    }
+}
+
+const int BinPool::getAvailableCPU(size_t index) const
+{
+    return available_cpus[index];
+}
+
+const int BinPool::getAvailableMem(size_t index) const
+{
+    return available_mems[index];
+}
+
+size_t BinPool::findFirstFit(size_t first, int cpu, int mem) const
+{
+    if (first >= nb_bins)
+    {
+        return nb_bins;
+    }
+    return searchTree(1, 0, nb_leaves, first, cpu, mem);
+}
+
+// Leftmost fitting bin at or after first in the leaves of the subtree of
+// node, which covers the nb_node_leaves leaves from first_leaf, nb_bins if none
+size_t BinPool::searchTree(size_t node, size_t first_leaf, size_t nb_node_leaves,
+                           size_t first, int cpu, int mem) const
+{
+    if (((first_leaf + nb_node_leaves) * LEAF_SIZE <= first)
+        or (tree_max_cpu[node] < cpu) or (tree_max_mem[node] < mem))
+    {
+        return nb_bins; // No bin of the subtree can fit
+    }
+    if (nb_node_leaves == 1)
+    {
+        size_t leaf_first = std::max(first, first_leaf * LEAF_SIZE);
+        size_t leaf_last = std::min(first_leaf * LEAF_SIZE + LEAF_SIZE, nb_bins);
+        return scanLeaf(leaf_first, leaf_last, cpu, mem);
+    }
+
+    size_t half = nb_node_leaves / 2;
+    size_t found = searchTree(2 * node, first_leaf, half, first, cpu, mem);
+    if (found < nb_bins)
+    {
+        return found;
+    }
+    // The maxima of the left subtree may come from bins before first, or
+    // from different bins for cpu and mem
+    return searchTree(2 * node + 1, first_leaf + half, half, first, cpu, mem);
+}
+
+size_t BinPool::scanLeaf(size_t first, size_t last, int cpu, int mem) const
+{
+    size_t found;
+#ifdef BIN_POOL_AVX2
+    if (use_avx2)
+    {
+        found = findFirstFitAVX2(available_cpus, available_mems, first, last, cpu, mem);
+    }
+    else
+#endif
+    {
+        found = findFirstFitScalar(available_cpus, available_mems, first, last, cpu, mem);
+    }
+    return (found < last) ? found : nb_bins;
+}
@@ -0,0 +1,57 @@
+#ifndef BIN_POOL_HPP
+#define BIN_POOL_HPP
+
+#include <cstddef>
+#include <vector>
+
+
+// Available capacities of the bins of an algorithm, in contiguous arrays
+// indexed by the position of the bins, so that first fit finds a bin
+// without loading the bins
+// The bins are grouped in leaves of 32 bins of a max-tree holding the max
+// available cpu and mem of each range of leaves: the search descends to the
+// leftmost leaves whose maxima are large enough, in logarithmic time when
+// the two maxima of a range come from the same bins
+// The leaves are scanned with AVX2 when the CPU supports it (not built with
+// BINPACK_NO_SIMD), with a scalar fallback, so the arrays are aligned on 32 bytes
+class BinPool
+{
+public:
+    BinPool();
+    BinPool(const BinPool& other) = delete;
+    BinPool& operator=(const BinPool& other) = delete;
+    ~BinPool();
+
+    const size_t size() const;
+    void clear();
+    void addBin(int available_cpu, int available_mem);
+    void setAvailable(size_t index, int available_cpu, int available_mem);
+    const int getAvailableCPU(size_t index) const;
+    const int getAvailableMem(size_t index) const;
+
+    // Index of the first bin at or after first with at least cpu and mem
+    // available, size() if there is none
+    size_t findFirstFit(size_t first, int cpu, int mem) const;
+
+private:
+    void reserve(size_t new_capacity);
+    size_t scanLeaf(size_t first, size_t last, int cpu, int mem) const;
+    size_t searchTree(size_t node, size_t first_leaf, size_t nb_node_leaves,
+                      size_t first, int cpu, int mem) const;
+    void updateLeaf(size_t leaf);
+    void buildTree(size_t min_nb_leaves);
+
+    int* available_cpus;
+    int* available_mems;
+    size_t nb_bins;
+    size_t capacity;
+    bool use_avx2;
+
+    // Nodes of the max-tree, 1 is the root and the children of node k are
+    // 2k and 2k+1, the leaves are the nodes from nb_leaves
+    size_t nb_leaves;
+    std::vector<int> tree_max_cpu;
+    std::vector<int> tree_max_mem;
+};
+
+#endif // BIN_POOL_HPP
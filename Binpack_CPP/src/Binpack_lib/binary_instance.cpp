@@ -0,0 +1,564 @@
+#include "binary_instance.hpp"
+#include "instance.hpp"
+#include "compressed_input.hpp"
+
+#define CSV_IO_NO_THREAD // Disable multithreading in csv.h
+#include "csv.h" // From https://github.com/ben-strasser/fast-cpp-csv-parser
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace io; // From csv.h
+
+
+BinaryInstanceFile::BinaryInstanceFile(const std::string& filename):
+    filename(filename),
+    data(nullptr),
+    data_size(0),
+    mapped(false),
+    header(nullptr)
+{
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        throw std::runtime_error("Cannot open binary instance file " + filename);
+    }
+
+    struct stat st;
+    if ((fstat(fd, &st) != 0) or (st.st_size < (off_t)sizeof(BinaryInstanceHeader)))
+    {
+        close(fd);
+        throw std::runtime_error("Binary instance file " + filename + " is too small");
+    }
+    data_size = st.st_size;
+
+    void* ptr = mmap(nullptr, data_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd); // The mapping stays valid after closing the file
+    if (ptr == MAP_FAILED)
+    {
+        throw std::runtime_error("Cannot map binary instance file " + filename);
+    }
+    data = static_cast<const char*>(ptr);
+    mapped = true;
+    madvise(ptr, data_size, MADV_SEQUENTIAL); // The loader reads each column once
+
+    try
+    {
+        checkHeader();
+    }
+    catch (...)
+    {
+        munmap(ptr, data_size);
+        throw;
+    }
+}
+
+BinaryInstanceFile::BinaryInstanceFile(std::vector<char>&& buffer, const std::string& name):
+    filename(name),
+    buffer(std::move(buffer)),
+    mapped(false)
+{
+    data = this->buffer.data();
+    data_size = this->buffer.size();
+    if (data_size < sizeof(BinaryInstanceHeader))
+    {
+        throw std::runtime_error("Binary instance " + filename + " is too small");
+    }
+    checkHeader();
+}
+
+// Size in bytes of count values of element_size bytes, false on overflow
+static bool sectionBytes(uint64_t count, uint64_t element_size, uint64_t& bytes)
+{
+    if ((element_size != 0) and (count > UINT64_MAX / element_size))
+    {
+        return false;
+    }
+    bytes = count * element_size;
+    return true;
+}
+
+// The offsets start at 0, never decrease and end at last
+static bool checkOffsets(const uint64_t* offsets, uint64_t nb_offsets, uint64_t last)
+{
+    if (offsets[0] != 0)
+    {
+        return false;
+    }
+    for (uint64_t i = 1; i < nb_offsets; ++i)
+    {
+        if (offsets[i] < offsets[i-1])
+        {
+            return false;
+        }
+    }
+    return (offsets[nb_offsets-1] == last);
+}
+
+void BinaryInstanceFile::checkHeader()
+{
+    header = reinterpret_cast<const BinaryInstanceHeader*>(data);
+    if ((std::memcmp(header->magic, BINARY_INSTANCE_MAGIC, sizeof(BINARY_INSTANCE_MAGIC)) != 0)
+        or (header->version != BINARY_INSTANCE_VERSION))
+    {
+        throw std::runtime_error("Wrong magic or version in binary instance file " + filename);
+    }
+    BinaryInstanceKind kind = header->kind;
+    if (((kind != BinaryInstanceKind::Fixed2D) and (kind != BinaryInstanceKind::TimeSeries)
+         and (kind != BinaryInstanceKind::Affinities))
+        or (header->nb_apps > header->nb_ids) or (header->nb_ids == UINT64_MAX))
+    {
+        throw std::runtime_error("Wrong header in binary instance file " + filename);
+    }
+
+    // Expected size of each section from the counts of the header
+    uint64_t nb_apps = header->nb_apps;
+    uint64_t expected[NB_BINARY_SECTIONS] = {0};
+    bool valid = sectionBytes(header->nb_ids + 1, sizeof(uint64_t), expected[SECTION_ID_OFFSETS])
+        and sectionBytes(nb_apps, sizeof(int32_t), expected[SECTION_NB_REPLICAS])
+        and sectionBytes(nb_apps, sizeof(int32_t), expected[SECTION_DEGREE])
+        and sectionBytes(nb_apps + 1, sizeof(uint64_t), expected[SECTION_EDGE_OFFSETS])
+        and sectionBytes(header->nb_edges, sizeof(uint32_t), expected[SECTION_EDGE_TARGETS])
+        and sectionBytes(header->nb_edges, sizeof(int32_t), expected[SECTION_EDGE_VALUES]);
+    if (kind == BinaryInstanceKind::Fixed2D)
+    {
+        valid = valid and sectionBytes(nb_apps, sizeof(int32_t), expected[SECTION_CPU])
+            and sectionBytes(nb_apps, sizeof(int32_t), expected[SECTION_MEM]);
+    }
+    else if (kind == BinaryInstanceKind::TimeSeries)
+    {
+        uint64_t nb_values;
+        valid = valid and sectionBytes(nb_apps, header->TS_size, nb_values)
+            and sectionBytes(nb_values, sizeof(float), expected[SECTION_CPU])
+            and sectionBytes(nb_values, sizeof(float), expected[SECTION_MEM]);
+        for (int s : {SECTION_PEAK_CPU, SECTION_PEAK_MEM, SECTION_SUM_CPU, SECTION_SUM_MEM})
+        {
+            valid = valid and sectionBytes(nb_apps, sizeof(float), expected[s]);
+        }
+    }
+    if (!valid)
+    {
+        throw std::runtime_error("Wrong header in binary instance file " + filename);
+    }
+
+    for (int s = 0; s < NB_BINARY_SECTIONS; ++s)
+    {
+        uint64_t offset = header->section_offset[s];
+        uint64_t size = header->section_size[s];
+        if ((offset > data_size) or (size > data_size - offset))
+        {
+            throw std::runtime_error("Truncated binary instance file " + filename);
+        }
+        // The string section is the only one whose size is not given by the counts
+        if (((s != SECTION_ID_STRINGS) and (size != expected[s])) or (offset % 8 != 0))
+        {
+            throw std::runtime_error("Wrong size of section " + std::to_string(s)
+                                     + " in binary instance file " + filename);
+        }
+    }
+
+    // The offsets and the targets are used as indexes, without further checks
+    if (!checkOffsets(getIdOffsets(), header->nb_ids + 1, header->section_size[SECTION_ID_STRINGS])
+        or !checkOffsets(getEdgeOffsets(), nb_apps + 1, header->nb_edges))
+    {
+        throw std::runtime_error("Wrong offsets in binary instance file " + filename);
+    }
+    const uint32_t* edge_targets = getEdgeTargets();
+    for (uint64_t e = 0; e < header->nb_edges; ++e)
+    {
+        if (edge_targets[e] >= header->nb_ids)
+        {
+            throw std::runtime_error("Wrong affinity target in binary instance file " + filename);
+        }
+    }
+}
+
+BinaryInstanceFile::~BinaryInstanceFile()
+{
+    if (mapped)
+    {
+        munmap(const_cast<char*>(data), data_size);
+    }
+}
+
+const void* BinaryInstanceFile::section(BinaryInstanceSection s) const
+{
+    return data + header->section_offset[s];
+}
+
+const BinaryInstanceHeader& BinaryInstanceFile::getHeader() const
+{
+    return *header;
+}
+
+const size_t BinaryInstanceFile::getNbApps() const
+{
+    return header->nb_apps;
+}
+
+const size_t BinaryInstanceFile::getTSLength() const
+{
+    return header->TS_size;
+}
+
+const uint64_t* BinaryInstanceFile::getIdOffsets() const
+{
+    return static_cast<const uint64_t*>(section(SECTION_ID_OFFSETS));
+}
+
+std::string BinaryInstanceFile::getAppId(size_t index) const
+{
+    const uint64_t* offsets = getIdOffsets();
+    const char* strings = static_cast<const char*>(section(SECTION_ID_STRINGS));
+    return std::string(strings + offsets[index], offsets[index+1] - offsets[index]);
+}
+
+const int32_t* BinaryInstanceFile::getNbReplicas() const
+{
+    return static_cast<const int32_t*>(section(SECTION_NB_REPLICAS));
+}
+
+const int32_t* BinaryInstanceFile::getDegrees() const
+{
+    return static_cast<const int32_t*>(section(SECTION_DEGREE));
+}
+
+const int32_t* BinaryInstanceFile::getCPUSizes() const
+{
+    return static_cast<const int32_t*>(section(SECTION_CPU));
+}
+
+const int32_t* BinaryInstanceFile::getMemSizes() const
+{
+    return static_cast<const int32_t*>(section(SECTION_MEM));
+}
+
+const float* BinaryInstanceFile::getCPUSeries() const
+{
+    return static_cast<const float*>(section(SECTION_CPU));
+}
+
+const float* BinaryInstanceFile::getMemSeries() const
+{
+    return static_cast<const float*>(section(SECTION_MEM));
+}
+
+const float* BinaryInstanceFile::getPeakCPU() const
+{
+    return static_cast<const float*>(section(SECTION_PEAK_CPU));
+}
+
+const float* BinaryInstanceFile::getPeakMem() const
+{
+    return static_cast<const float*>(section(SECTION_PEAK_MEM));
+}
+
+const float* BinaryInstanceFile::getSumCPU() const
+{
+    return static_cast<const float*>(section(SECTION_SUM_CPU));
+}
+
+const float* BinaryInstanceFile::getSumMem() const
+{
+    return static_cast<const float*>(section(SECTION_SUM_MEM));
+}
+
+void BinaryInstanceFile::adviseRandomAccess() const
+{
+    if (mapped)
+    {
+        madvise(const_cast<char*>(data), data_size, MADV_NORMAL);
+    }
+}
+
+const uint64_t* BinaryInstanceFile::getEdgeOffsets() const
+{
+    return static_cast<const uint64_t*>(section(SECTION_EDGE_OFFSETS));
+}
+
+const uint32_t* BinaryInstanceFile::getEdgeTargets() const
+{
+    return static_cast<const uint32_t*>(section(SECTION_EDGE_TARGETS));
+}
+
+const int32_t* BinaryInstanceFile::getEdgeValues() const
+{
+    return static_cast<const int32_t*>(section(SECTION_EDGE_VALUES));
+}
+
+
+bool isBinaryInstanceFile(const std::string& filename)
+{
+    std::ifstream f(filename, std::ios::binary);
+    char magic[sizeof(BINARY_INSTANCE_MAGIC)];
+    if (!f.read(magic, sizeof(magic)))
+    {
+        return false;
+    }
+    return (std::memcmp(magic, BINARY_INSTANCE_MAGIC, sizeof(magic)) == 0);
+}
+
+
+void BinaryInstanceColumns::addAffinities(std::string& aff_str, unsigned row)
+{
+    parseAffinityList(aff_str, row, [this](std::string_view app_b, int k) {
+        edge_target_ids.emplace_back(app_b);
+        edge_values.push_back(k);
+    });
+    edge_offsets.push_back(edge_values.size());
+}
+
+void BinaryInstanceColumns::addApp(const std::string& app_id)
+{
+    // The id of the i-th app is always the i-th id of the table
+    id_index.insert({app_id, (uint32_t)ids.size()});
+    ids.push_back(app_id);
+}
+
+uint32_t BinaryInstanceColumns::internId(const std::string& app_id)
+{
+    auto it = id_index.find(app_id);
+    if (it != id_index.end())
+    {
+        return it->second;
+    }
+    uint32_t index = ids.size();
+    ids.push_back(app_id);
+    id_index.insert({app_id, index});
+    return index;
+}
+
+template<typename T>
+static void appendSection(std::vector<char>& buffer, BinaryInstanceHeader& header,
+                          BinaryInstanceSection s, const T* values, size_t count)
+{
+    // Keep every section aligned on 8 bytes
+    buffer.resize((buffer.size() + 7) & ~size_t(7), '\0');
+    header.section_offset[s] = buffer.size();
+    header.section_size[s] = count * sizeof(T);
+    const char* bytes = reinterpret_cast<const char*>(values);
+    buffer.insert(buffer.end(), bytes, bytes + count * sizeof(T));
+}
+
+std::vector<char> buildBinaryInstance(BinaryInstanceColumns& cols, BinaryInstanceKind kind,
+                                      size_t TS_size)
+{
+    size_t nb_apps = cols.nb_replicas.size();
+
+    // Resolve the targets of the affinities, unknown ids are appended after the apps
+    std::vector<uint32_t>& edge_targets = cols.edge_targets;
+    edge_targets.reserve(edge_targets.size() + cols.edge_target_ids.size());
+    for (const std::string& target : cols.edge_target_ids)
+    {
+        edge_targets.push_back(cols.internId(target));
+    }
+    cols.edge_target_ids.clear();
+
+    std::vector<uint64_t> id_offsets(1, 0);
+    std::string strings;
+    for (const std::string& app_id : cols.ids)
+    {
+        strings += app_id;
+        id_offsets.push_back(strings.size());
+    }
+
+    BinaryInstanceHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, BINARY_INSTANCE_MAGIC, sizeof(BINARY_INSTANCE_MAGIC));
+    header.version = BINARY_INSTANCE_VERSION;
+    header.kind = kind;
+    header.nb_apps = nb_apps;
+    header.nb_ids = cols.ids.size();
+    header.nb_edges = edge_targets.size();
+    header.TS_size = TS_size;
+
+    std::vector<char> buffer(sizeof(BinaryInstanceHeader), '\0');
+    appendSection(buffer, header, SECTION_ID_OFFSETS, id_offsets.data(), id_offsets.size());
+    appendSection(buffer, header, SECTION_ID_STRINGS, strings.data(), strings.size());
+    appendSection(buffer, header, SECTION_NB_REPLICAS, cols.nb_replicas.data(), nb_apps);
+    appendSection(buffer, header, SECTION_DEGREE, cols.degrees.data(), nb_apps);
+    if (kind == BinaryInstanceKind::Fixed2D)
+    {
+        appendSection(buffer, header, SECTION_CPU, cols.cpu_sizes.data(), nb_apps);
+        appendSection(buffer, header, SECTION_MEM, cols.mem_sizes.data(), nb_apps);
+    }
+    else if (kind == BinaryInstanceKind::TimeSeries)
+    {
+        appendSection(buffer, header, SECTION_CPU, cols.cpu_series.data(), cols.cpu_series.size());
+        appendSection(buffer, header, SECTION_MEM, cols.mem_series.data(), cols.mem_series.size());
+        appendSection(buffer, header, SECTION_PEAK_CPU, cols.peak_cpu.data(), nb_apps);
+        appendSection(buffer, header, SECTION_PEAK_MEM, cols.peak_mem.data(), nb_apps);
+        appendSection(buffer, header, SECTION_SUM_CPU, cols.sum_cpu.data(), nb_apps);
+        appendSection(buffer, header, SECTION_SUM_MEM, cols.sum_mem.data(), nb_apps);
+    }
+    appendSection(buffer, header, SECTION_EDGE_OFFSETS, cols.edge_offsets.data(), cols.edge_offsets.size());
+    appendSection(buffer, header, SECTION_EDGE_TARGETS, edge_targets.data(), edge_targets.size());
+    appendSection(buffer, header, SECTION_EDGE_VALUES, cols.edge_values.data(), cols.edge_values.size());
+    std::memcpy(buffer.data(), &header, sizeof(header));
+    return buffer;
+}
+
+void writeBinaryInstance(const std::vector<char>& buffer, const std::string& bin_filename)
+{
+    std::ofstream f(bin_filename, std::ios::binary | std::ios::trunc);
+    if (!f.write(buffer.data(), buffer.size()))
+    {
+        throw std::runtime_error("Cannot write binary instance file " + bin_filename);
+    }
+}
+
+
+std::vector<char> buildInstance2DBinary(const std::string& csv_filename)
+{
+    CSVReader<6, trim_chars<'[', ']'>, no_quote_escape<'\t'>> reader(csv_filename, openInputFile(csv_filename));
+    reader.read_header(ignore_extra_column, "app_id", "nb_instances", "core", "memory", "inter_degree", "inter_aff");
+    std::string app_id("");
+    std::string aff_str("");
+    int nb_rep, nb_cpus, nb_memory, degree;
+
+    BinaryInstanceColumns cols;
+    while(reader.read_row(app_id, nb_rep, nb_cpus, nb_memory, degree, aff_str))
+    {
+        cols.addApp(app_id);
+        cols.nb_replicas.push_back(nb_rep);
+        cols.degrees.push_back(degree);
+        cols.cpu_sizes.push_back(nb_cpus);
+        cols.mem_sizes.push_back(nb_memory);
+        cols.addAffinities(aff_str, reader.get_file_line());
+    }
+    return buildBinaryInstance(cols, BinaryInstanceKind::Fixed2D, 0);
+}
+
+static const uint64_t FNV_OFFSET_BASIS = 14695981039346656037ull;
+static const uint64_t FNV_PRIME = 1099511628211ull;
+
+// FNV-1a hash of a field and of the separator after it
+static void hashField(uint64_t& hash, const char* field)
+{
+    for (const char* p = field; *p != '\0'; ++p)
+    {
+        hash = (hash ^ (unsigned char)*p) * FNV_PRIME;
+    }
+    hash = (hash ^ (unsigned char)'\t') * FNV_PRIME;
+}
+
+uint64_t hashResourceColumns(const std::string& csv_filename)
+{
+    CSVReader<2, trim_chars<'[', ']'>, no_quote_escape<'\t'>> reader(csv_filename, openInputFile(csv_filename));
+    reader.read_header(ignore_extra_column, "core", "memory");
+    char* core;
+    char* memory;
+
+    uint64_t hash = FNV_OFFSET_BASIS;
+    while(reader.read_row(core, memory))
+    {
+        hashField(hash, core);
+        hashField(hash, memory);
+    }
+    return hash;
+}
+
+std::vector<char> buildAffinitiesBinary(const std::string& csv_filename, const BinaryInstanceFile& baseline,
+                                        uint64_t& resources_hash)
+{
+    // The series of the resource columns are only hashed, not converted
+    CSVReader<6, trim_chars<'[', ']'>, no_quote_escape<'\t'>> reader(csv_filename, openInputFile(csv_filename));
+    reader.read_header(ignore_extra_column, "app_id", "nb_instances", "core", "memory", "inter_degree", "inter_aff");
+    std::string app_id("");
+    std::string aff_str("");
+    char* core;
+    char* memory;
+    int nb_rep, degree;
+
+    BinaryInstanceColumns cols;
+    size_t nb_apps = baseline.getNbApps();
+    resources_hash = FNV_OFFSET_BASIS;
+    while(reader.read_row(app_id, nb_rep, core, memory, degree, aff_str))
+    {
+        size_t i = cols.nb_replicas.size();
+        if ((i >= nb_apps) or (app_id != baseline.getAppId(i)))
+        {
+            throw std::runtime_error("Instance file " + csv_filename + " does not have the applications of its baseline");
+        }
+        hashField(resources_hash, core);
+        hashField(resources_hash, memory);
+        cols.addApp(app_id);
+        cols.nb_replicas.push_back(nb_rep);
+        cols.degrees.push_back(degree);
+        cols.addAffinities(aff_str, reader.get_file_line());
+    }
+    if (cols.nb_replicas.size() != nb_apps)
+    {
+        throw std::runtime_error("Instance file " + csv_filename + " does not have the applications of its baseline");
+    }
+    return buildBinaryInstance(cols, BinaryInstanceKind::Affinities, baseline.getTSLength());
+}
+
+void convertInstance2DToBinary(const std::string& csv_filename, const std::string& bin_filename)
+{
+    writeBinaryInstance(buildInstance2DBinary(csv_filename), bin_filename);
+}
+
+std::vector<char> buildInstanceTSBinary(const std::string& csv_filename)
+{
+    CSVReader<6, trim_chars<'[', ']'>, no_quote_escape<'\t'>> reader(csv_filename, openInputFile(csv_filename));
+    reader.read_header(ignore_extra_column, "app_id", "nb_instances", "core", "memory", "inter_degree", "inter_aff");
+    std::string app_id("");
+    std::string aff_str("");
+    std::string cpu_usage_str;
+    std::string mem_usage_str;
+    int nb_rep, degree;
+
+    BinaryInstanceColumns cols;
+    size_t TS_size = 0;
+    ResourceTS cpu_usage;
+    ResourceTS mem_usage;
+    while(reader.read_row(app_id, nb_rep, cpu_usage_str, mem_usage_str, degree, aff_str))
+    {
+        float peak_cpu, sum_cpu;
+        float peak_mem, sum_mem;
+        unsigned row = reader.get_file_line();
+        if (cols.nb_replicas.empty())
+        {
+            // The first row gives the size of the series
+            TS_size = parseResourceTS(cpu_usage_str, row, nullptr, 0, peak_cpu, sum_cpu);
+            cpu_usage.resize(TS_size);
+            mem_usage.resize(TS_size);
+        }
+        size_t cpu_size = parseResourceTS(cpu_usage_str, row, cpu_usage.data(), TS_size, peak_cpu, sum_cpu);
+        size_t mem_size = parseResourceTS(mem_usage_str, row, mem_usage.data(), TS_size, peak_mem, sum_mem);
+
+        if ((cpu_size != TS_size) or (mem_size != TS_size))
+        {
+            std::string s = "Wrong size of resource usage for application " + app_id + ": found sizes ";
+            s += std::to_string(cpu_size) + " and " + std::to_string(mem_size);
+            throw std::runtime_error(s);
+        }
+
+        cols.addApp(app_id);
+        cols.nb_replicas.push_back(nb_rep);
+        cols.degrees.push_back(degree);
+        cols.cpu_series.insert(cols.cpu_series.end(), cpu_usage.begin(), cpu_usage.end());
+        cols.mem_series.insert(cols.mem_series.end(), mem_usage.begin(), mem_usage.end());
+        cols.peak_cpu.push_back(peak_cpu);
+        cols.peak_mem.push_back(peak_mem);
+        cols.sum_cpu.push_back(sum_cpu);
+        cols.sum_mem.push_back(sum_mem);
+        cols.addAffinities(aff_str, row);
+    }
+    return buildBinaryInstance(cols, BinaryInstanceKind::TimeSeries, TS_size);
+}
+
+void convertInstanceTSToBinary(const std::string& csv_filename, const std::string& bin_filename)
+{
+    writeBinaryInstance(buildInstanceTSBinary(csv_filename), bin_filename);
+}
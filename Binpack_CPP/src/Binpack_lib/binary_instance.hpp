@@ -0,0 +1,166 @@
+#ifndef BINARY_INSTANCE_HPP
+#define BINARY_INSTANCE_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+
+// Compact binary instance format
+// The file is a fixed-size header followed by 8-byte aligned sections,
+// each section stores one column for all applications:
+//   - app ids as a string table (offsets + characters), followed by the ids
+//     referenced in affinity lists that are not applications of the file
+//   - number of replicas, declared degree
+//   - 2D: cpu and memory requirements
+//   - TS: cpu and memory series as contiguous float blocks (nb_apps * TS_size)
+//         with the peak and sum of each series
+//   - affinities as a flat edge array (offsets per app, target, value)
+// The content is capacity-independent: no application is filtered out,
+// filtering is done by the loader as for the CSV files.
+
+constexpr char BINARY_INSTANCE_MAGIC[8] = {'L', 'R', 'A', 'B', 'I', 'N', '\0', '\0'};
+constexpr uint32_t BINARY_INSTANCE_VERSION = 1;
+
+enum class BinaryInstanceKind : uint32_t
+{
+    Fixed2D = 0,
+    TimeSeries = 1,
+    Affinities = 2 // No resource section, the apps are the ones of a baseline instance
+};
+
+enum BinaryInstanceSection
+{
+    SECTION_ID_OFFSETS = 0, // uint64[nb_ids+1], offsets in the string section
+    SECTION_ID_STRINGS,     // char[], concatenated ids
+    SECTION_NB_REPLICAS,    // int32[nb_apps]
+    SECTION_DEGREE,         // int32[nb_apps], inter_degree column
+    SECTION_CPU,            // 2D: int32[nb_apps], TS: float[nb_apps*TS_size]
+    SECTION_MEM,            // 2D: int32[nb_apps], TS: float[nb_apps*TS_size]
+    SECTION_PEAK_CPU,       // TS only: float[nb_apps]
+    SECTION_PEAK_MEM,       // TS only: float[nb_apps]
+    SECTION_SUM_CPU,        // TS only: float[nb_apps]
+    SECTION_SUM_MEM,        // TS only: float[nb_apps]
+    SECTION_EDGE_OFFSETS,   // uint64[nb_apps+1], offsets in the edge arrays
+    SECTION_EDGE_TARGETS,   // uint32[nb_edges], index in the id table
+    SECTION_EDGE_VALUES,    // int32[nb_edges], affinity value
+    NB_BINARY_SECTIONS
+};
+
+struct BinaryInstanceHeader
+{
+    char magic[8];
+    uint32_t version;
+    BinaryInstanceKind kind;
+    uint64_t nb_apps;  // Number of applications (rows of the CSV file)
+    uint64_t nb_ids;   // nb_apps + ids only referenced in affinity lists
+    uint64_t nb_edges; // Total number of affinity pairs
+    uint64_t TS_size;  // Size of the time series (0 for 2D)
+    uint64_t section_offset[NB_BINARY_SECTIONS]; // Offsets from the start of the file
+    uint64_t section_size[NB_BINARY_SECTIONS];   // Sizes in bytes
+};
+
+
+// Read-only memory-mapped view of a binary instance file
+class BinaryInstanceFile
+{
+public:
+    BinaryInstanceFile(const std::string& filename);
+    // Binary instance built in memory, name is only used in error messages
+    BinaryInstanceFile(std::vector<char>&& buffer, const std::string& name);
+    ~BinaryInstanceFile();
+
+    BinaryInstanceFile(const BinaryInstanceFile& other) = delete;
+    BinaryInstanceFile& operator=(const BinaryInstanceFile& other) = delete;
+
+    const BinaryInstanceHeader& getHeader() const;
+    const size_t getNbApps() const;
+    const size_t getTSLength() const;
+
+    std::string getAppId(size_t index) const; // index in the id table
+
+    const int32_t* getNbReplicas() const;
+    const int32_t* getDegrees() const;
+    const int32_t* getCPUSizes() const;   // 2D only
+    const int32_t* getMemSizes() const;   // 2D only
+    const float* getCPUSeries() const;    // TS only, series of app i starts at i*TS_size
+    const float* getMemSeries() const;    // TS only
+    const float* getPeakCPU() const;      // TS only
+    const float* getPeakMem() const;      // TS only
+    const float* getSumCPU() const;       // TS only
+    const float* getSumMem() const;       // TS only
+
+    // The series are then read in any order, while the instances are solved
+    void adviseRandomAccess() const;
+
+    const uint64_t* getEdgeOffsets() const;
+    const uint32_t* getEdgeTargets() const;
+    const int32_t* getEdgeValues() const;
+
+private:
+    const void* section(BinaryInstanceSection s) const;
+    const uint64_t* getIdOffsets() const;
+    // Checks the sizes of the sections against the counts of the header,
+    // and the offsets and targets used as indexes
+    void checkHeader();
+
+    std::string filename;
+    std::vector<char> buffer; // Content of an instance built in memory
+    const char* data;   // Start of the mapping or of the buffer
+    size_t data_size;   // Size of the mapping or of the buffer
+    bool mapped;
+    const BinaryInstanceHeader* header;
+};
+
+// Columns of an instance file before being written in binary format
+struct BinaryInstanceColumns
+{
+    std::vector<std::string> ids; // Apps first, then other referenced ids
+    std::unordered_map<std::string, uint32_t> id_index;
+
+    std::vector<int32_t> nb_replicas;
+    std::vector<int32_t> degrees;
+    std::vector<int32_t> cpu_sizes;
+    std::vector<int32_t> mem_sizes;
+    std::vector<float> cpu_series;
+    std::vector<float> mem_series;
+    std::vector<float> peak_cpu;
+    std::vector<float> peak_mem;
+    std::vector<float> sum_cpu;
+    std::vector<float> sum_mem;
+
+    std::vector<uint64_t> edge_offsets = std::vector<uint64_t>(1, 0);
+    std::vector<uint32_t> edge_targets;       // Index in the id table
+    std::vector<std::string> edge_target_ids; // Resolved once all apps are known, after edge_targets
+    std::vector<int32_t> edge_values;
+
+    void addAffinities(std::string& aff_str, unsigned row);
+    void addApp(const std::string& app_id);
+    uint32_t internId(const std::string& app_id);
+};
+
+std::vector<char> buildBinaryInstance(BinaryInstanceColumns& cols, BinaryInstanceKind kind, size_t TS_size);
+
+// Whether the file starts with the binary instance magic
+bool isBinaryInstanceFile(const std::string& filename);
+
+// Parse the TAB-separated CSV files into the binary format
+std::vector<char> buildInstance2DBinary(const std::string& csv_filename);
+std::vector<char> buildInstanceTSBinary(const std::string& csv_filename);
+void writeBinaryInstance(const std::vector<char>& buffer, const std::string& bin_filename);
+// Parse only the ids, replicas and affinities of a CSV file with the same
+// apps as the baseline, in the same order, the resource columns are not
+// parsed but their hash is set in resources_hash (see hashResourceColumns)
+std::vector<char> buildAffinitiesBinary(const std::string& csv_filename, const BinaryInstanceFile& baseline,
+                                        uint64_t& resources_hash);
+// Hash of the raw text of the core and memory columns of a CSV file, the
+// files with the same hash have the same resources
+uint64_t hashResourceColumns(const std::string& csv_filename);
+
+// Converters from the TAB-separated CSV files to the binary format
+void convertInstance2DToBinary(const std::string& csv_filename, const std::string& bin_filename);
+void convertInstanceTSToBinary(const std::string& csv_filename, const std::string& bin_filename);
+
+#endif // BINARY_INSTANCE_HPP
@@ -6,20 +6,95 @@
 
 using namespace std;
 
+#ifdef BINPACK_FILTER_STATS
+static ConflictFilterStats filter_stats = {0, 0, 0};
+#endif
+
+const ConflictFilterStats& getConflictFilterStats()
+{
+#ifdef BINPACK_FILTER_STATS
+    return filter_stats;
+#else
+    static const ConflictFilterStats no_stats = {0, 0, 0};
+    return no_stats;
+#endif
+}
+
+void resetConflictFilterStats()
+{
+#ifdef BINPACK_FILTER_STATS
+    filter_stats = {0, 0, 0};
+#endif
+}
+
+void printConflictFilterStats([[maybe_unused]] const std::string& label)
+{
+#ifdef BINPACK_FILTER_STATS
+    const ConflictFilterStats& stats = filter_stats;
+    float hit_rate = (stats.nb_probes > 0) ? (float)stats.nb_hits / stats.nb_probes : 0.0;
+    float false_rate = (stats.nb_hits > 0) ? (float)stats.nb_false_hits / stats.nb_hits : 0.0;
+    cout << label << ": " << stats.nb_probes << " filter probes, hit rate " << hit_rate
+         << ", false hit rate " << false_rate << endl;
+#endif
+}
+
+// Bit of an app in the conflict filters, from a multiplicative hash of its
+// internal id so that the apps with close ids are spread over the word
+static inline uint64_t filterBit(int app)
+{
+    return uint64_t(1) << ((uint64_t(app) * 0x9E3779B97F4A7C15ull) >> 58);
+}
+
+static inline void countFilterProbe([[maybe_unused]] bool hit, [[maybe_unused]] bool found)
+{
+#ifdef BINPACK_FILTER_STATS
+    filter_stats.nb_probes += 1;
+    if (hit)
+    {
+        filter_stats.nb_hits += 1;
+        if (!found)
+        {
+            filter_stats.nb_false_hits += 1;
+        }
+    }
+#endif
+}
+
 Bin2D::Bin2D(int id, int max_cpu_capacity, int max_mem_capacity):
     id(id),
     max_cpu_capacity(max_cpu_capacity),
     max_mem_capacity(max_mem_capacity),
     available_cpu_capacity(max_cpu_capacity),
     available_mem_capacity(max_mem_capacity),
+    hosted_filter(0),
+    restricted_filter(0),
     measure(0.0)
 { }
 
+void Bin2D::reset(int id, int max_cpu_capacity, int max_mem_capacity)
+{
+    this->id = id;
+    this->max_cpu_capacity = max_cpu_capacity;
+    this->max_mem_capacity = max_mem_capacity;
+    available_cpu_capacity = max_cpu_capacity;
+    available_mem_capacity = max_mem_capacity;
+    alloc_list.clear();
+    conflict_map.clear();
+    hosted_filter = 0;
+    restricted_filter = 0;
+    measure = 0.0;
+}
+
 const int Bin2D::getId() const
 {
     return id;
 }
 
+void Bin2D::setId(int id)
+{
+    this->id = id;
+}
+
 const int Bin2D::getMaxCPUCap() const
 {
     return max_cpu_capacity;
@@ -40,9 +115,9 @@ const int Bin2D::getAvailableMemCap() const
     return available_mem_capacity;
 }
 
-const AllocMap& Bin2D::getAllocMap() const
+const AllocList& Bin2D::getAllocList() const
 {
-    return alloc_map;
+    return alloc_list;
 }
 
 const ConflictMap& Bin2D::getConflictMap() const
@@ -51,22 +126,14 @@ const ConflictMap& Bin2D::getConflictMap() const
 }
 
 
-void Bin2D::addItem(Application2D* app, int replica_id)
+void Bin2D::addItem(Application2D* app)
 {
     // We do not check anything and don't return a boolean
     // That's the job of the algo to not make stupid decisions.
     if (doesItemFit(app->getCPUSize(), app->getMemorySize()))
     {
-        auto it = alloc_map.find(app->getId());
-        if (it == alloc_map.end())
-        {
-            std::vector<int> v(1, replica_id);
-            alloc_map.insert(it, {app->getId(), v});
-        }
-        else
-        {
-            it->second.push_back(replica_id);
-        }
+        alloc_list.addReplica(app->getInternalId());
+        hosted_filter |= filterBit(app->getInternalId());
         available_cpu_capacity -= app->getCPUSize();
 
         available_mem_capacity -= app->getMemorySize();
@@ -83,24 +150,10 @@ void Bin2D::printAlloc() const
     stringstream ss;
     ss << "Bin_" << id << ": ";
 
-    std::vector<std::string> keys;
-    keys.reserve(alloc_map.size());
-    for (auto app_it : alloc_map)
+    // Apps are printed with their internal id and number of replicas
+    for (const AllocRecord& record : alloc_list)
     {
-        keys.push_back(app_it.first);
-    }
-
-    auto compare = [](const std::string& a, const std::string& b) {
-        return std::stoi(a) < std::stoi(b);
-    };
-
-    sort(keys.begin(), keys.end(), compare);
-    for (std::string& key: keys)
-    {
-        for (auto e : alloc_map.at(key))
-        {
-            ss << key << "_" << e << ",";
-        }
+        ss << record.app << "_x" << record.nb_replicas << ",";
     }
     cout << ss.str() << endl;
 }
@@ -108,38 +161,45 @@ void Bin2D::printAlloc() const
 
 bool Bin2D::isAffinityCompliant(Application2D *app) const
 {
-    auto it = conflict_map.find(app->getId());
-    if (it != conflict_map.end())
+    if ((hosted_filter | restricted_filter) == 0)
+    {
+        return true; // Empty bin
+    }
+
+    int app_id = app->getInternalId();
+    bool hit = (restricted_filter & filterBit(app_id)) != 0;
+    const int* nb_tolerated = hit ? conflict_map.find(app_id) : nullptr;
+    countFilterProbe(hit, nb_tolerated != nullptr);
+    if (nb_tolerated != nullptr)
     {
         // The candidate app is in conflict with apps in the bin
-        if (it->second < 1)
+        if (*nb_tolerated < 1)
         {
             // 0 replicas of the candidate app are tolerated
             return false;
         }
 
-        auto it2 = alloc_map.find(app->getId());
-        if (it2 != alloc_map.end())
+        // There may already be replicas of the candidate app
+        // Check if we can put one more
+        if (*nb_tolerated < (alloc_list.count(app_id) + 1))
         {
-            // There are already replicas of the candidate app
-            // Check if we can put one more
-            if (it->second < (it2->second.size() + 1))
-            {
-                return false;
-            }
+            return false;
         }
     }
-    for (auto pair : app->getAffinityOutMap())
+    for (const AffinityEdge& edge : app->getAffinityOut())
     {
         // For each app_b in conflict with the candidate app
         // check if there are more than the tolerated replicas
-        auto it3 = alloc_map.find(pair.first);
-        if (it3 != alloc_map.end())
+        if ((hosted_filter & filterBit(edge.target)) == 0)
         {
-            if (it3->second.size() > pair.second)
-            {
-                return false;
-            }
+            countFilterProbe(false, false);
+            continue; // No replica of app_b in this bin
+        }
+        int nb_replicas = alloc_list.count(edge.target);
+        countFilterProbe(true, nb_replicas > 0);
+        if (nb_replicas > edge.value)
+        {
+            return false;
         }
     }
     return true;
@@ -149,22 +209,15 @@ bool Bin2D::isAffinityCompliant(Application2D *app) const
 void Bin2D::addNewConflict(Application2D *app)
 {
     // Only add conflicts if the app is new to the bin (i.e., there was no replica of the app yet in the bin)
-    if (alloc_map.find(app->getId()) != alloc_map.end())
+    if (alloc_list.count(app->getInternalId()) > 0)
     {
         return;
     }
 
-    for (auto pair : app->getAffinityOutMap())
+    for (const AffinityEdge& edge : app->getAffinityOut())
     {
-        auto it = conflict_map.find(pair.first);
-        if (it != conflict_map.end())
-        {
-            it->second = min(pair.second, it->second);
-        }
-        else
-        {
-            conflict_map[pair.first] = pair.second;
-        }
+        restricted_filter |= filterBit(edge.target);
+        conflict_map.addConflict(edge.target, edge.value);
     }
 }
 
@@ -191,6 +244,15 @@ bool bin2D_comparator_measure_decreasing(Bin2D* bina, Bin2D* binb)
     return(bina->getMeasure() > binb->getMeasure());
 }
 
+void freeBins(BinList2D& bins)
+{
+    for (Bin2D* bin : bins)
+    {
+        delete bin;
+    }
+    bins.clear();
+}
+
 // Perform one round of bubble upwards
 void bubble_bin_up(BinList2D::iterator first, BinList2D::iterator last, bool comp(Bin2D*, Bin2D*))
 {
@@ -246,72 +308,225 @@ void bubble_bin_down(BinList2D::iterator first, BinList2D::iterator last, bool c
 
 
 
-BinTS::BinTS(int id, int max_cpu_capacity, int max_mem_capacity, size_t size_TS):
+// Fit checks and updates of a residual series by the shape of the item series
+// A constant item is decided by the min of the residual, and the runs of a
+// piecewise constant item are compared without loading its values
+static bool shapeMayFit(const SeriesShape& shape, const SeriesSpan& usage,
+                        const SeriesEnvelope& item_envelope, const SeriesEnvelope& residual_envelope)
+{
+    if (shape.getKind() == SeriesShapeKind::Constant)
+    {
+        return usage[0] <= residual_envelope.getMin();
+    }
+    return seriesMayFit(item_envelope, residual_envelope);
+}
+
+static bool shapeFits(const SeriesShape& shape, const SeriesSpan& usage, const SeriesEnvelope& item_envelope,
+                      const SeriesEnvelope& residual_envelope, const ResourceTS& residual)
+{
+    switch (shape.getKind())
+    {
+    case SeriesShapeKind::Constant:
+        return usage[0] <= residual_envelope.getMin();
+    case SeriesShapeKind::PiecewiseConstant:
+    {
+        size_t t = 0;
+        for (size_t r = 0; r < shape.getNbRuns(); ++r)
+        {
+            const float value = shape.getRunValue(r);
+            for (const size_t run_end = shape.getRunEnd(r); t < run_end; ++t)
+            {
+                if (value > residual[t])
+                {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+    default:
+        return seriesFits(item_envelope, usage.data(), residual_envelope, residual.data());
+    }
+}
+
+// Same subtractions in the same order as with the whole series, so that the
+// residuals do not depend on the shapes
+static void subtractSeries(const SeriesShape& shape, const SeriesSpan& usage, ResourceTS& residual,
+                           float& total_residual, SeriesEnvelope& residual_envelope)
+{
+    switch (shape.getKind())
+    {
+    case SeriesShapeKind::Constant:
+    {
+        const float value = usage[0];
+        for (size_t t = 0; t < residual.size(); ++t)
+        {
+            residual[t] -= value;
+            total_residual -= value;
+        }
+        residual_envelope.subtract(value);
+        return;
+    }
+    case SeriesShapeKind::PiecewiseConstant:
+    {
+        size_t t = 0;
+        for (size_t r = 0; r < shape.getNbRuns(); ++r)
+        {
+            const float value = shape.getRunValue(r);
+            for (const size_t run_end = shape.getRunEnd(r); t < run_end; ++t)
+            {
+                residual[t] -= value;
+                total_residual -= value;
+            }
+        }
+        break;
+    }
+    default:
+        for (size_t t = 0; t < residual.size(); ++t)
+        {
+            residual[t] -= usage[t];
+            total_residual -= usage[t];
+        }
+    }
+    residual_envelope.update(residual.data());
+}
+
+
+BinTS::BinTS(int id, int max_cpu_capacity, int max_mem_capacity, size_t size_TS,
+             SeriesPrecision precision):
     Bin2D(id, max_cpu_capacity, max_mem_capacity),
     available_cpu_capacity(size_TS, max_cpu_capacity),
     available_mem_capacity(size_TS, max_mem_capacity),
+    float_residuals_stale(false),
     size_TS(size_TS),
     total_residual_cpu(0.0),
-    total_residual_mem(0.0)
-{ }
+    total_residual_mem(0.0),
+    precision(precision),
+    used_cpu_units(0),
+    used_mem_units(0)
+{
+    if (precision != SeriesPrecision::Float)
+    {
+        fixed_cpu_capacity = FixedSeries(size_TS, max_cpu_capacity, precision);
+        fixed_mem_capacity = FixedSeries(size_TS, max_mem_capacity, precision);
+    }
+    else
+    {
+        cpu_envelope = SeriesEnvelope(available_cpu_capacity.data(), size_TS, false);
+        mem_envelope = SeriesEnvelope(available_mem_capacity.data(), size_TS, false);
+    }
+}
 
+void BinTS::reset(int id, int max_cpu_capacity, int max_mem_capacity, size_t size_TS,
+                  SeriesPrecision precision)
+{
+    if ((size_TS != this->size_TS) or (precision != this->precision))
+    {
+        *this = BinTS(id, max_cpu_capacity, max_mem_capacity, size_TS, precision);
+        return;
+    }
 
-void BinTS::addItem(ApplicationTS* app, int replica_id)
+    Bin2D::reset(id, max_cpu_capacity, max_mem_capacity);
+    available_cpu_capacity.assign(size_TS, max_cpu_capacity);
+    available_mem_capacity.assign(size_TS, max_mem_capacity);
+    float_residuals_stale = false;
+    total_residual_cpu = 0.0;
+    total_residual_mem = 0.0;
+    used_cpu_units = 0;
+    used_mem_units = 0;
+    if (precision != SeriesPrecision::Float)
+    {
+        fixed_cpu_capacity.reset(size_TS, max_cpu_capacity, precision);
+        fixed_mem_capacity.reset(size_TS, max_mem_capacity, precision);
+    }
+    else
+    {
+        // Same windows as for a new bin, the envelopes are only recomputed
+        cpu_envelope.update(available_cpu_capacity.data());
+        mem_envelope.update(available_mem_capacity.data());
+    }
+}
+
+void BinTS::addItem(ApplicationTS* app)
 {
     // We do not check anything and don't return a boolean
     // That's the job of the algo to not make stupid decisions.
     if (doesItemFit(app))
     {
-        auto it = alloc_map.find(app->getId());
-        if (it == alloc_map.end())
-        {
-            std::vector<int> v(1, replica_id);
-            alloc_map.insert(it, {app->getId(), v});
-        }
-        else
+        alloc_list.addReplica(app->getInternalId());
+        hosted_filter |= filterBit(app->getInternalId());
+
+        if (precision != SeriesPrecision::Float)
         {
-            it->second.push_back(replica_id);
+            addFixedItem(app);
+            return;
         }
 
         // Update usage vectors
-        const ResourceTS& app_cpu = app->getCpuUsage();
-        const ResourceTS& app_mem = app->getMemUsage();
+        subtractSeries(app->getCpuShape(), app->getCpuUsage(), available_cpu_capacity, total_residual_cpu, cpu_envelope);
+        subtractSeries(app->getMemShape(), app->getMemUsage(), available_mem_capacity, total_residual_mem, mem_envelope);
+    }
+}
 
-        for (size_t i = 0; i < size_TS; i++)
-        {
-            available_cpu_capacity[i] -= app_cpu[i];
-            available_mem_capacity[i] -= app_mem[i];
 
-            total_residual_cpu -= app_cpu[i];
-            total_residual_mem -= app_mem[i];
-        }
-    }
+void BinTS::addFixedItem(ApplicationTS* app)
+{
+    const FixedSeries& app_cpu = app->getFixedCpuUsage();
+    const FixedSeries& app_mem = app->getFixedMemUsage();
+    fixed_cpu_capacity.subtract(app_cpu);
+    fixed_mem_capacity.subtract(app_mem);
+    float_residuals_stale = true;
+
+    // Minus the total usage, as with the float series
+    used_cpu_units += app_cpu.getTotalUnits();
+    used_mem_units += app_mem.getTotalUnits();
+    total_residual_cpu = -fixed_cpu_capacity.unitsToResource(used_cpu_units);
+    total_residual_mem = -fixed_mem_capacity.unitsToResource(used_mem_units);
 }
 
 
 bool BinTS::doesItemFit(ApplicationTS* app) const
 {
-    const ResourceTS& app_cpu = app->getCpuUsage();
-    const ResourceTS& app_mem = app->getMemUsage();
+    if (precision != SeriesPrecision::Float)
+    {
+        return fixed_cpu_capacity.fits(app->getFixedCpuUsage()) and
+               fixed_mem_capacity.fits(app->getFixedMemUsage());
+    }
 
-    for (size_t i = 0; i < size_TS; i++)
+    // Most bins are rejected from the windows, before any time step is compared
+    const SeriesEnvelope& app_cpu_envelope = app->getCpuEnvelope();
+    const SeriesEnvelope& app_mem_envelope = app->getMemEnvelope();
+    if (!shapeMayFit(app->getCpuShape(), app->getCpuUsage(), app_cpu_envelope, cpu_envelope) or
+        !shapeMayFit(app->getMemShape(), app->getMemUsage(), app_mem_envelope, mem_envelope))
     {
-        if ((app_cpu[i] > available_cpu_capacity[i]) or
-            (app_mem[i] > available_mem_capacity[i]) )
-        {
-            return false;
-        }
+        return false;
     }
-    return true;
+    return shapeFits(app->getCpuShape(), app->getCpuUsage(), app_cpu_envelope, cpu_envelope, available_cpu_capacity) and
+           shapeFits(app->getMemShape(), app->getMemUsage(), app_mem_envelope, mem_envelope, available_mem_capacity);
+}
+
+void BinTS::updateFloatResiduals() const
+{
+    fixed_cpu_capacity.toResource(available_cpu_capacity);
+    fixed_mem_capacity.toResource(available_mem_capacity);
+    float_residuals_stale = false;
 }
 
 const ResourceTS& BinTS::getAvailableCPUCaps() const
 {
+    if (float_residuals_stale)
+    {
+        updateFloatResiduals();
+    }
     return available_cpu_capacity;
 }
 
 const ResourceTS& BinTS::getAvailableMemCaps() const
 {
+    if (float_residuals_stale)
+    {
+        updateFloatResiduals();
+    }
     return available_mem_capacity;
 }
 
@@ -325,6 +540,20 @@ const float BinTS::getTotalResidualMem() const
     return total_residual_mem;
 }
 
+const SeriesPrecision BinTS::getPrecision() const
+{
+    return precision;
+}
+
+void freeBins(BinListTS& bins)
+{
+    for (BinTS* bin : bins)
+    {
+        delete bin;
+    }
+    bins.clear();
+}
+
 // Perform one round of bubble upwards
 void bubble_bin_up(BinListTS::iterator first, BinListTS::iterator last, bool comp(Bin2D*, Bin2D*))
 {
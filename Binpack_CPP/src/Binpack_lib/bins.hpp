@@ -1,8 +1,12 @@
 #ifndef BINS_HPP
 #define BINS_HPP
 
+#include "alloc_list.hpp"
+#include "conflict_map.hpp"
 #include "application.hpp"
 
+#include <algorithm>
+#include <cstdint>
 #include <string>
 #include <vector>
 #include <unordered_map>
@@ -14,8 +18,19 @@ class BinTS;
 using BinList2D = std::vector<Bin2D*>;
 using BinListTS = std::vector<BinTS*>;
 
-using AllocMap = std::unordered_map<std::string, std::vector<int>>;
-using ConflictMap = std::unordered_map<std::string, int>;
+// Counters of the probes of the conflict filters of the bins, only updated
+// when the library is built with BINPACK_FILTER_STATS
+struct ConflictFilterStats
+{
+    uint64_t nb_probes;     // Apps looked up in a filter
+    uint64_t nb_hits;       // Probes then looked up in the exact map
+    uint64_t nb_false_hits; // Hits without an entry in the exact map
+};
+
+const ConflictFilterStats& getConflictFilterStats();
+void resetConflictFilterStats();
+// Prints the hit and false hit rates since the last reset
+void printConflictFilterStats(const std::string& label);
 
 
 class Bin2D
@@ -23,17 +38,21 @@ class Bin2D
 public:
     Bin2D(int id, int max_cpu_capacity, int max_mem_capacity);
     Bin2D(const Bin2D& other) = default; // Copy ctor
+    Bin2D& operator=(const Bin2D& other) = default;
+    // Same as a new bin, keeping the memory of the containers (see BinArena)
+    void reset(int id, int max_cpu_capacity, int max_mem_capacity);
 
     const int getId() const;
+    void setId(int id); // The algos identify a bin by its position in their bins
     const int getMaxCPUCap() const;
     const int getAvailableCPUCap() const;
     const int getMaxMemCap() const;
     const int getAvailableMemCap() const;
 
-    const AllocMap& getAllocMap() const;
+    const AllocList& getAllocList() const;
     const ConflictMap& getConflictMap() const;
 
-    void addItem(Application2D* app, int replica_id);
+    void addItem(Application2D* app);
     bool doesItemFit(int size_cpu, int size_mem) const;
 
     void printAlloc() const;
@@ -50,35 +69,52 @@ public:
     const float getMeasure() const;
 
 protected:
-    const int id;
-    const int max_cpu_capacity;
-    const int max_mem_capacity;
+    int id;
+    int max_cpu_capacity;
+    int max_mem_capacity;
     int available_cpu_capacity;
     int available_mem_capacity;
 
-    // Maps an application id to a vector of replica id allocated to this bin
-    AllocMap alloc_map;
+    // Number of replicas of each application allocated to this bin
+    AllocList alloc_list;
 
     // Maps an application id to the number of replicas of this application
     // tolerated by the apps already packed in this bin
     ConflictMap conflict_map;
 
+    // One bit per hash of the internal id of the apps with replicas in this
+    // bin, and of the apps in conflict_map: isAffinityCompliant only reads
+    // alloc_list and conflict_map for the apps whose bit is set
+    uint64_t hosted_filter;
+    uint64_t restricted_filter;
+
     float measure; // Placeholder for a measure value
 };
 
 bool bin2D_comparator_measure_increasing(Bin2D* bina, Bin2D* binb);
 bool bin2D_comparator_measure_decreasing(Bin2D* bina, Bin2D* binb);
 
+// Deletes the bins allocated with new, e.g. by getBinsCopy, and clears the list
+void freeBins(BinList2D& bins);
+
 void bubble_bin_up(BinList2D::iterator first, BinList2D::iterator last, bool comp(Bin2D*, Bin2D*));
 void bubble_bin_down(BinList2D::iterator first, BinList2D::iterator last, bool comp(Bin2D*, Bin2D*));
 
 class BinTS : public Bin2D
 {
 public:
-    BinTS(int id, int max_cpu_capacity, int max_mem_capacity, size_t size_TS);
+    // With a fixed-point precision, the fit checks and additions are done on
+    // the fixed-point series of the apps, which must have the same precision,
+    // and the float residuals are converted back from the exact residuals
+    // when they are read, so only the measures read floats
+    BinTS(int id, int max_cpu_capacity, int max_mem_capacity, size_t size_TS,
+          SeriesPrecision precision = SeriesPrecision::Float);
     BinTS(const BinTS& other) = default; // Copy ctor
+    BinTS& operator=(const BinTS& other) = default;
+    void reset(int id, int max_cpu_capacity, int max_mem_capacity, size_t size_TS,
+               SeriesPrecision precision = SeriesPrecision::Float);
 
-    void addItem(ApplicationTS* app, int replica_id);
+    void addItem(ApplicationTS* app);
     bool doesItemFit(ApplicationTS* app) const;
 
     const ResourceTS& getAvailableCPUCaps() const;
@@ -86,15 +122,114 @@ public:
 
     const float getTotalResidualCPU() const;
     const float getTotalResidualMem() const;
+    const SeriesPrecision getPrecision() const;
 private:
-    ResourceTS available_cpu_capacity;
-    ResourceTS available_mem_capacity;
+    void addFixedItem(ApplicationTS* app);
+    void updateFloatResiduals() const;
+
+    // With a fixed-point precision, only up to date if !float_residuals_stale
+    mutable ResourceTS available_cpu_capacity;
+    mutable ResourceTS available_mem_capacity;
+    mutable bool float_residuals_stale;
+    SeriesEnvelope cpu_envelope; // Windows of the residuals with floats
+    SeriesEnvelope mem_envelope;
     size_t size_TS;
     float total_residual_cpu;
     float total_residual_mem;
+    SeriesPrecision precision;
+    FixedSeries fixed_cpu_capacity; // Residuals in fixed point, empty with floats
+    FixedSeries fixed_mem_capacity;
+    uint64_t used_cpu_units;        // Sums of the fixed-point usages of the apps
+    uint64_t used_mem_units;
 };
 
+void freeBins(BinListTS& bins); // See freeBins(BinList2D&)
+
 void bubble_bin_up(BinListTS::iterator first, BinListTS::iterator last, bool comp(Bin2D*, Bin2D*));
 void bubble_bin_down(BinListTS::iterator first, BinListTS::iterator last, bool comp(Bin2D*, Bin2D*));
 
+// Index of the first replica of each app in computeReplicaBins, indexed by
+// the internal ids, so it does not depend on the order of apps; the last
+// value is the total number of replicas
+template<typename AppList>
+std::vector<int> computeReplicaOffsets(const AppList& apps)
+{
+    int max_id = -1;
+    for (auto app : apps)
+    {
+        max_id = std::max(max_id, app->getInternalId());
+    }
+    std::vector<int> offsets(max_id + 2, 0);
+    for (auto app : apps)
+    {
+        offsets[app->getInternalId() + 1] = app->getNbReplicas();
+    }
+    for (int i = 0; i <= max_id; ++i)
+    {
+        offsets[i + 1] += offsets[i];
+    }
+    return offsets;
+}
+
+// Id of the bin of each replica, the replicas of the apps following the order
+// of their internal ids, -1 for the replicas not packed
+// The replicas of an app are interchangeable, so they are numbered in the
+// order of the bins instead of being stored in the bins
+template<typename BinList, typename AppList>
+std::vector<int> computeReplicaBins(const BinList& bins, const AppList& apps)
+{
+    std::vector<int> next_replica = computeReplicaOffsets(apps);
+    std::vector<int> replica_bins(next_replica.back(), -1);
+    for (auto bin : bins)
+    {
+        for (const AllocRecord& record : bin->getAllocList())
+        {
+            for (int i = 0; i < record.nb_replicas; ++i)
+            {
+                replica_bins[next_replica[record.app]++] = bin->getId();
+            }
+        }
+    }
+    return replica_bins;
+}
+
+// Whether all the replicas are packed in replica_bins, and each bin hosts as
+// many replicas of each app in replica_bins as in its AllocList
+template<typename BinList, typename AppList>
+bool checkReplicaBins(const BinList& bins, const AppList& apps,
+                      const std::vector<int>& replica_bins)
+{
+    std::vector<int> offsets = computeReplicaOffsets(apps);
+    if ((int)replica_bins.size() != offsets.back())
+    {
+        return false;
+    }
+    // Number of replicas assigned to each bin, keyed by (app, bin id)
+    std::unordered_map<uint64_t, int> nb_assigned;
+    for (size_t app = 0; app + 1 < offsets.size(); ++app)
+    {
+        for (int replica = offsets[app]; replica < offsets[app + 1]; ++replica)
+        {
+            if (replica_bins[replica] == -1)
+            {
+                return false;
+            }
+            ++nb_assigned[((uint64_t)app << 32) | (uint32_t)replica_bins[replica]];
+        }
+    }
+    for (auto bin : bins)
+    {
+        for (const AllocRecord& record : bin->getAllocList())
+        {
+            auto it = nb_assigned.find(((uint64_t)record.app << 32) | (uint32_t)bin->getId());
+            if ((it == nb_assigned.end()) or (it->second != record.nb_replicas))
+            {
+                return false;
+            }
+            nb_assigned.erase(it);
+        }
+    }
+    return nb_assigned.empty();
+}
+
 #endif // BINS_HPP
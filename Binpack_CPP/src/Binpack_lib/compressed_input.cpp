@@ -0,0 +1,228 @@
+#include "compressed_input.hpp"
+
+#define CSV_IO_NO_THREAD // Disable multithreading in csv.h
+#include "csv.h" // From https://github.com/ben-strasser/fast-cpp-csv-parser
+
+#include <cstdio>
+#include <stdexcept>
+#include <vector>
+
+#ifdef BINPACK_WITH_ZLIB
+#include <zlib.h>
+#endif
+#ifdef BINPACK_WITH_ZSTD
+#include <zstd.h>
+#endif
+
+
+InputCompression detectCompression(const std::string& filename)
+{
+    unsigned char magic[4] = {0, 0, 0, 0};
+    FILE* file = std::fopen(filename.c_str(), "rb");
+    if (file == nullptr)
+    {
+        return InputCompression::None;
+    }
+    size_t size = std::fread(magic, 1, sizeof(magic), file);
+    std::fclose(file);
+
+    if ((size >= 2) and (magic[0] == 0x1f) and (magic[1] == 0x8b))
+    {
+        return InputCompression::Gzip;
+    }
+    if ((size == 4) and (magic[0] == 0x28) and (magic[1] == 0xb5) and (magic[2] == 0x2f) and (magic[3] == 0xfd))
+    {
+        return InputCompression::Zstd;
+    }
+    return InputCompression::None;
+}
+
+
+// The LineReader of csv.h stops at the first read returning less than the
+// requested size, so the sources below only do it at the end of the file
+
+class PlainFileSource : public io::ByteSourceBase
+{
+public:
+    PlainFileSource(FILE* file):
+        file(file)
+    {
+        // csv.h does its own buffering
+        std::setvbuf(file, 0, _IONBF, 0);
+    }
+
+    ~PlainFileSource()
+    {
+        std::fclose(file);
+    }
+
+    int read(char* buffer, int size) override
+    {
+        return std::fread(buffer, 1, size, file);
+    }
+
+private:
+    FILE* file;
+};
+
+#ifdef BINPACK_WITH_ZLIB
+class GzipFileSource : public io::ByteSourceBase
+{
+public:
+    GzipFileSource(const std::string& filename):
+        filename(filename)
+    {
+        file = gzopen(filename.c_str(), "rb");
+        if (file == nullptr)
+        {
+            throw std::runtime_error("Cannot open file " + filename);
+        }
+        gzbuffer(file, 1 << 18);
+    }
+
+    ~GzipFileSource()
+    {
+        gzclose(file);
+    }
+
+    int read(char* buffer, int size) override
+    {
+        // gzread only returns less than size at the end of the file
+        int count = gzread(file, buffer, size);
+        if (count < size)
+        {
+            // Also reports a truncated file
+            int errnum;
+            const char* message = gzerror(file, &errnum);
+            if (errnum != Z_OK)
+            {
+                // The message already gives the file name
+                throw std::runtime_error(std::string("Cannot decompress ") + message);
+            }
+        }
+        return count;
+    }
+
+private:
+    std::string filename;
+    gzFile file;
+};
+#endif
+
+#ifdef BINPACK_WITH_ZSTD
+class ZstdFileSource : public io::ByteSourceBase
+{
+public:
+    ZstdFileSource(FILE* file, const std::string& filename):
+        filename(filename),
+        file(file),
+        in_buffer(ZSTD_DStreamInSize()),
+        end_of_file(false),
+        frame_complete(true)
+    {
+        stream = ZSTD_createDStream();
+        ZSTD_initDStream(stream);
+        input.src = in_buffer.data();
+        input.size = 0;
+        input.pos = 0;
+    }
+
+    ~ZstdFileSource()
+    {
+        ZSTD_freeDStream(stream);
+        std::fclose(file);
+    }
+
+    int read(char* buffer, int size) override
+    {
+        ZSTD_outBuffer output = {buffer, (size_t)size, 0};
+        while (output.pos < output.size)
+        {
+            if ((input.pos == input.size) and !end_of_file)
+            {
+                input.size = std::fread(in_buffer.data(), 1, in_buffer.size(), file);
+                input.pos = 0;
+                end_of_file = (input.size == 0);
+            }
+
+            size_t in_pos = input.pos;
+            size_t out_pos = output.pos;
+            size_t ret = ZSTD_decompressStream(stream, &output, &input);
+            if (ZSTD_isError(ret))
+            {
+                std::string s = "Cannot decompress file " + filename + ": ";
+                throw std::runtime_error(s + ZSTD_getErrorName(ret));
+            }
+
+            if ((input.pos != in_pos) or (output.pos != out_pos))
+            {
+                frame_complete = (ret == 0);
+            }
+            else if (end_of_file)
+            {
+                // Nothing left to decompress
+                if (!frame_complete)
+                {
+                    throw std::runtime_error("Truncated compressed file " + filename);
+                }
+                break;
+            }
+        }
+        return output.pos;
+    }
+
+private:
+    std::string filename;
+    FILE* file;
+    ZSTD_DStream* stream;
+    std::vector<char> in_buffer;
+    ZSTD_inBuffer input;
+    bool end_of_file;
+    bool frame_complete;
+};
+#endif
+
+
+std::unique_ptr<io::ByteSourceBase> openInputFile(const std::string& filename)
+{
+    InputCompression compression = detectCompression(filename);
+    if (compression == InputCompression::Gzip)
+    {
+#ifdef BINPACK_WITH_ZLIB
+        return std::unique_ptr<io::ByteSourceBase>(new GzipFileSource(filename));
+#else
+        throw std::runtime_error("File " + filename + " is gzip compressed but zlib support is not built");
+#endif
+    }
+
+    FILE* file = std::fopen(filename.c_str(), "rb");
+    if (file == nullptr)
+    {
+        throw std::runtime_error("Cannot open file " + filename);
+    }
+    if (compression == InputCompression::Zstd)
+    {
+#ifdef BINPACK_WITH_ZSTD
+        return std::unique_ptr<io::ByteSourceBase>(new ZstdFileSource(file, filename));
+#else
+        std::fclose(file);
+        throw std::runtime_error("File " + filename + " is zstd compressed but zstd support is not built");
+#endif
+    }
+    return std::unique_ptr<io::ByteSourceBase>(new PlainFileSource(file));
+}
+
+std::string findInputFile(const std::string& filename)
+{
+    for (const char* suffix : {"", ".zst", ".gz"})
+    {
+        std::string path = filename + suffix;
+        FILE* file = std::fopen(path.c_str(), "rb");
+        if (file != nullptr)
+        {
+            std::fclose(file);
+            return path;
+        }
+    }
+    return filename;
+}
@@ -0,0 +1,28 @@
+#ifndef COMPRESSED_INPUT_HPP
+#define COMPRESSED_INPUT_HPP
+
+#include <memory>
+#include <string>
+
+namespace io { class ByteSourceBase; } // From csv.h
+
+
+enum class InputCompression
+{
+    None,
+    Gzip,
+    Zstd
+};
+
+// Detected from the first bytes of the file
+InputCompression detectCompression(const std::string& filename);
+
+// Byte source for csv.h returning the decompressed content of the file,
+// the file is decompressed on the fly while it is read
+// Gzip needs zlib and zstd needs libzstd when building the library
+std::unique_ptr<io::ByteSourceBase> openInputFile(const std::string& filename);
+
+// The file if it exists, else its compressed version with suffix .zst or .gz
+std::string findInputFile(const std::string& filename);
+
+#endif // COMPRESSED_INPUT_HPP
@@ -0,0 +1,95 @@
+#include "conflict_map.hpp"
+
+#include <algorithm>
+#include <cstdint>
+
+static const ConflictRecord EMPTY_RECORD = {-1, 0};
+static const size_t MIN_NB_SLOTS = 16;
+
+
+ConflictMap::ConflictMap():
+    nb_conflicts(0),
+    shift(64)
+{ }
+
+const size_t ConflictMap::size() const
+{
+    return nb_conflicts;
+}
+
+// Multiplicative hash, so that the apps with close ids are spread over the slots
+size_t ConflictMap::firstSlot(int app) const
+{
+    return (uint64_t(app) * 0x9E3779B97F4A7C15ull) >> shift;
+}
+
+const int* ConflictMap::find(int app) const
+{
+    if (nb_conflicts == 0)
+    {
+        return nullptr;
+    }
+    size_t mask = records.size() - 1;
+    for (size_t slot = firstSlot(app); ; slot = (slot + 1) & mask)
+    {
+        if (records[slot].app == app)
+        {
+            return &records[slot].nb_tolerated;
+        }
+        if (records[slot].app == -1)
+        {
+            return nullptr;
+        }
+    }
+}
+
+void ConflictMap::addConflict(int app, int nb_tolerated)
+{
+    if (2 * (nb_conflicts + 1) > records.size())
+    {
+        grow();
+    }
+    size_t mask = records.size() - 1;
+    size_t slot = firstSlot(app);
+    while ((records[slot].app != -1) and (records[slot].app != app))
+    {
+        slot = (slot + 1) & mask;
+    }
+    if (records[slot].app == app)
+    {
+        records[slot].nb_tolerated = std::min(nb_tolerated, records[slot].nb_tolerated);
+    }
+    else
+    {
+        records[slot] = {app, nb_tolerated};
+        nb_conflicts += 1;
+    }
+}
+
+void ConflictMap::clear()
+{
+    if (nb_conflicts > 0)
+    {
+        std::fill(records.begin(), records.end(), EMPTY_RECORD);
+        nb_conflicts = 0;
+    }
+}
+
+void ConflictMap::grow()
+{
+    std::vector<ConflictRecord> old_records(std::max(MIN_NB_SLOTS, 2 * records.size()), EMPTY_RECORD);
+    old_records.swap(records);
+    shift = 64;
+    for (size_t nb_slots = records.size(); nb_slots > 1; nb_slots /= 2)
+    {
+        shift -= 1;
+    }
+    nb_conflicts = 0;
+    for (const ConflictRecord& record : old_records)
+    {
+        if (record.app != -1)
+        {
+            addConflict(record.app, record.nb_tolerated);
+        }
+    }
+}
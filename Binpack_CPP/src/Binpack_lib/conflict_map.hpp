@@ -0,0 +1,40 @@
+#ifndef CONFLICT_MAP_HPP
+#define CONFLICT_MAP_HPP
+
+#include <cstddef>
+#include <vector>
+
+
+// Number of replicas of an app tolerated by the apps packed in a bin
+struct ConflictRecord
+{
+    int app; // Internal id of the app, -1 for an empty slot
+    int nb_tolerated;
+};
+
+// Conflicts of the apps packed in a bin, keyed by the internal id of the apps
+// The records are stored by open addressing in a single array, which is kept
+// by clear() and reused by the copy assignment, so the bins reused by a
+// BinArena do not allocate for their conflicts
+class ConflictMap
+{
+public:
+    ConflictMap();
+
+    const size_t size() const;
+    // Replicas of the app tolerated in the bin, nullptr if there is no conflict
+    const int* find(int app) const;
+    // The app tolerates the min of nb_tolerated and of its previous value
+    void addConflict(int app, int nb_tolerated);
+    void clear(); // Keeps the array of the records
+
+private:
+    size_t firstSlot(int app) const;
+    void grow();
+
+    std::vector<ConflictRecord> records; // Power of two size, at most half full
+    size_t nb_conflicts;
+    unsigned int shift; // 64 - log2 of the number of slots
+};
+
+#endif // CONFLICT_MAP_HPP
@@ -0,0 +1,221 @@
+#include "fixed_series.hpp"
+
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+
+SeriesPrecision parseSeriesPrecision(const std::string& name)
+{
+    if (name == "float")
+    {
+        return SeriesPrecision::Float;
+    }
+    else if (name == "fixed32")
+    {
+        return SeriesPrecision::Fixed32;
+    }
+    else if (name == "fixed16")
+    {
+        return SeriesPrecision::Fixed16;
+    }
+    throw std::runtime_error("Unknown series precision: " + name);
+}
+
+const uint32_t getUnitsPerResource(SeriesPrecision precision, float capacity)
+{
+    double max_units;
+    switch (precision)
+    {
+    case SeriesPrecision::Fixed16:
+        max_units = UINT16_MAX;
+        break;
+    case SeriesPrecision::Fixed32:
+        max_units = UINT32_MAX;
+        break;
+    default:
+        throw std::runtime_error("No fixed-point scale for float series");
+    }
+    if (!(capacity > 0.0) or (capacity > max_units))
+    {
+        throw std::runtime_error("Bin capacity " + std::to_string(capacity) + " out of the range of the fixed-point series");
+    }
+    uint32_t units = 1;
+    while ((double)capacity * units * 2 <= max_units)
+    {
+        units *= 2;
+    }
+    return units;
+}
+
+
+// Comparisons by blocks without early exit inside a block, so that they are vectorized
+template<typename T>
+static bool fitsValues(const T* item, const T* residual, size_t size)
+{
+    const size_t block = 32;
+    size_t t = 0;
+    for (; t + block <= size; t += block)
+    {
+        int over = 0;
+        for (size_t k = 0; k < block; ++k)
+        {
+            over |= (item[t+k] > residual[t+k]);
+        }
+        if (over)
+        {
+            return false;
+        }
+    }
+    for (; t < size; ++t)
+    {
+        if (item[t] > residual[t])
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+template<typename T>
+static void subtractValues(const T* item, T* residual, size_t size)
+{
+    for (size_t t = 0; t < size; ++t)
+    {
+        residual[t] -= item[t];
+    }
+}
+
+template<typename T>
+static void valuesToResource(const T* units, size_t size, double units_per_resource, std::vector<float>& values)
+{
+    values.resize(size);
+    for (size_t t = 0; t < size; ++t)
+    {
+        values[t] = (float)(units[t] / units_per_resource);
+    }
+}
+
+
+FixedSeries::FixedSeries():
+    precision(SeriesPrecision::Float),
+    units_per_resource(0),
+    nb_values(0),
+    total_units(0)
+{ }
+
+FixedSeries::FixedSeries(size_t size, float capacity, SeriesPrecision precision)
+{
+    reset(size, capacity, precision);
+}
+
+void FixedSeries::reset(size_t size, float capacity, SeriesPrecision precision)
+{
+    this->precision = precision;
+    units_per_resource = getUnitsPerResource(precision, capacity);
+    nb_values = size;
+    // Exact, the capacity is less than the max integer of the precision
+    uint32_t full = (uint32_t)std::floor((double)capacity * units_per_resource);
+    if (precision == SeriesPrecision::Fixed16)
+    {
+        values16.assign(size, full);
+        values32.clear();
+    }
+    else
+    {
+        values32.assign(size, full);
+        values16.clear();
+    }
+    total_units = (uint64_t)size * full;
+}
+
+FixedSeries::FixedSeries(const float* usage, size_t size, float capacity, SeriesPrecision precision):
+    precision(precision),
+    units_per_resource(getUnitsPerResource(precision, capacity)),
+    nb_values(size),
+    total_units(0)
+{
+    // The apps are filtered so that their usage is at most the capacity
+    const double full = std::floor((double)capacity * units_per_resource);
+    if (precision == SeriesPrecision::Fixed16)
+    {
+        values16.resize(size);
+    }
+    else
+    {
+        values32.resize(size);
+    }
+    for (size_t t = 0; t < size; ++t)
+    {
+        double units = std::ceil((double)usage[t] * units_per_resource);
+        uint32_t value = (units <= 0.0) ? 0 : ((units >= full) ? (uint32_t)full : (uint32_t)units);
+        if (precision == SeriesPrecision::Fixed16)
+        {
+            values16[t] = value;
+        }
+        else
+        {
+            values32[t] = value;
+        }
+        total_units += value;
+    }
+}
+
+const size_t FixedSeries::size() const
+{
+    return nb_values;
+}
+
+const SeriesPrecision FixedSeries::getPrecision() const
+{
+    return precision;
+}
+
+const uint64_t FixedSeries::getTotalUnits() const
+{
+    return total_units;
+}
+
+bool FixedSeries::fits(const FixedSeries& item) const
+{
+    if ((item.precision != precision) or (item.units_per_resource != units_per_resource) or
+        (item.nb_values != nb_values))
+    {
+        throw std::runtime_error("Fixed-point series of different precisions, scales or sizes");
+    }
+    if (precision == SeriesPrecision::Fixed16)
+    {
+        return fitsValues(item.values16.data(), values16.data(), nb_values);
+    }
+    return fitsValues(item.values32.data(), values32.data(), nb_values);
+}
+
+void FixedSeries::subtract(const FixedSeries& item)
+{
+    if (precision == SeriesPrecision::Fixed16)
+    {
+        subtractValues(item.values16.data(), values16.data(), nb_values);
+    }
+    else
+    {
+        subtractValues(item.values32.data(), values32.data(), nb_values);
+    }
+    total_units -= item.total_units;
+}
+
+void FixedSeries::toResource(std::vector<float>& values) const
+{
+    if (precision == SeriesPrecision::Fixed16)
+    {
+        valuesToResource(values16.data(), nb_values, units_per_resource, values);
+    }
+    else
+    {
+        valuesToResource(values32.data(), nb_values, units_per_resource, values);
+    }
+}
+
+const float FixedSeries::unitsToResource(uint64_t nb_units) const
+{
+    return (float)((double)nb_units / units_per_resource);
+}
@@ -0,0 +1,65 @@
+#ifndef FIXED_SERIES_HPP
+#define FIXED_SERIES_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+
+// Representation of the series used by the fit checks of the TS bins
+enum class SeriesPrecision
+{
+    Float,   // The float series are compared and subtracted as they are
+    Fixed32, // Integer series scaled to the bin capacity, stored in 32 bits
+    Fixed16  // Same in 16 bits, half the memory traffic of floats
+};
+
+// Precision named float, fixed32 or fixed16, throws std::runtime_error otherwise
+SeriesPrecision parseSeriesPrecision(const std::string& name);
+
+// Number of units of one resource unit: the largest power of two such that
+// the whole capacity fits in the integers of the precision, so that the
+// values with few fractional bits (e.g. 0.5, 0.25) are exact
+const uint32_t getUnitsPerResource(SeriesPrecision precision, float capacity);
+
+
+// Time series in fixed point, in units of 1 / getUnitsPerResource(precision, capacity)
+// The values are stored in 16 or 32 bits, the sums and comparisons are
+// exact so the fit decisions do not depend on the order of the additions
+class FixedSeries
+{
+public:
+    FixedSeries();
+    // Whole capacity at each time step, for the residual of an empty bin
+    FixedSeries(size_t size, float capacity, SeriesPrecision precision);
+    // Same as the constructor above, keeping the memory of the values
+    void reset(size_t size, float capacity, SeriesPrecision precision);
+    // Usage rounded up to the next unit, so that a fit check never accepts
+    // an item that does not fit with the exact values
+    FixedSeries(const float* usage, size_t size, float capacity, SeriesPrecision precision);
+
+    const size_t size() const;
+    const SeriesPrecision getPrecision() const;
+    const uint64_t getTotalUnits() const; // Sum of the values
+
+    // True if item <= this at each time step, both scaled to the same capacity
+    bool fits(const FixedSeries& item) const;
+    // this -= item, the item must fit
+    void subtract(const FixedSeries& item);
+
+    // Values converted back to the resource
+    void toResource(std::vector<float>& values) const;
+    // Number of units converted back to the resource
+    const float unitsToResource(uint64_t nb_units) const;
+
+private:
+    SeriesPrecision precision;
+    uint32_t units_per_resource;
+    size_t nb_values;
+    uint64_t total_units;
+    std::vector<uint16_t> values16; // Only the one of the precision is used
+    std::vector<uint32_t> values32;
+};
+
+#endif // FIXED_SERIES_HPP
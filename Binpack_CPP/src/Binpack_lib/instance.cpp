@@ -1,41 +1,243 @@
 #include "instance.hpp"
+#include "binary_instance.hpp"
+#include "compressed_input.hpp"
+#include "instance_delta.hpp"
+#include "instance_loader.hpp"
 
 #define CSV_IO_NO_THREAD // Disable multithreading in csv.h
 #include "csv.h" // From https://github.com/ben-strasser/fast-cpp-csv-parser
 
 #include <iostream>
-#include <sstream>
 #include <algorithm>
+#include <memory>
 #include <stdexcept>
 
 using namespace io; // From csv.h
 
-void my_trim(std::string& s)
+void throwFieldParseError(const char* field_name, std::string_view str,
+                          size_t pos, unsigned row, const char* expected)
 {
-    s.erase(std::remove(s.begin(), s.end(), '('), s.end());
-    s.erase(std::remove(s.begin(), s.end(), ' '), s.end());
-    s.erase(std::remove(s.begin(), s.end(), ')'), s.end());
+    std::string s = "Malformed " + std::string(field_name) + " at row " + std::to_string(row);
+    s += ", column " + std::to_string(pos + 1) + ": expected " + expected;
+    if (pos < str.size())
+    {
+        s += " but found '" + std::string(1, str[pos]) + "'";
+    }
+    else
+    {
+        s += " but found the end of the list";
+    }
+    throw std::runtime_error(s);
 }
 
-AffinityMap constructAffinitiyMap(std::string& aff_str)
+InstanceLoadMode parseInstanceLoadMode(const std::string& name)
 {
-    AffinityMap aff_map;
-    std::string app_b, strk;
-    std::istringstream splitStream(aff_str);
-    while(std::getline(splitStream, app_b, ','))
+    if (name == "sequential")
+    {
+        return InstanceLoadMode::Sequential;
+    }
+    else if (name == "pipelined")
+    {
+        return InstanceLoadMode::Pipelined;
+    }
+    else if (name == "chunked")
     {
-        my_trim(app_b);
-        std::getline(splitStream, strk, ',');
-        my_trim(strk);
-        aff_map[app_b] = stoi(strk);
+        return InstanceLoadMode::Chunked;
     }
-    return aff_map;
+    throw std::runtime_error("Unknown load mode: " + name);
 }
 
+void parseAffinityEdges(std::string_view aff_str, unsigned row, AppIdTable& ids, std::vector<AffinityEdge>& edges)
+{
+    parseAffinityList(aff_str, row, [&ids, &edges](std::string_view app_b, int k) {
+        edges.push_back({ids.intern(app_b), k});
+    });
+}
 
+void parseAffinityList(std::string_view aff_str, unsigned row, AffinityList& aff_list)
+{
+    parseAffinityList(aff_str, row, [&aff_list](std::string_view app_b, int k) {
+        aff_list.emplace_back(app_b, k);
+    });
+}
+
+int AppIdTable::intern(std::string_view app_id)
+{
+    std::string s(app_id);
+    auto it = index.find(s);
+    if (it != index.end())
+    {
+        return it->second;
+    }
+    int id = names.size();
+    index.insert({s, id});
+    names.push_back(std::move(s));
+    return id;
+}
+
+const size_t AppIdTable::size() const
+{
+    return names.size();
+}
+
+const std::string& AppIdTable::getName(int id) const
+{
+    return names[id];
+}
+
+// The affinities are the ones of the file, or of a file of its family
+static void checkAffinitiesFile(const BinaryInstanceFile& file, const BinaryInstanceFile& affinities,
+                                const std::string& id)
+{
+    BinaryInstanceKind kind = affinities.getHeader().kind;
+    if ((&affinities != &file) and
+        (((kind != BinaryInstanceKind::Affinities) and (kind != file.getHeader().kind)) or
+         (affinities.getNbApps() != file.getNbApps())))
+    {
+        throw std::runtime_error("Affinities of instance " + id + " do not match the apps of its baseline");
+    }
+}
+
+// The file ids of the arrays are the indexes in app_ids
+template<typename Arrays>
+static void internArrayIds(const Arrays& arrays, const std::string& id, InstanceLoadState& state)
+{
+    for (size_t i = 0; i < arrays.nb_apps + arrays.nb_other_ids; ++i)
+    {
+        if (state.ids.intern(arrays.app_ids[i]) != (int)i)
+        {
+            throw std::runtime_error("Application " + arrays.app_ids[i] + " given twice to instance " + id);
+        }
+    }
+}
+
+template<typename Arrays>
+static void addArrayAffinities(const Arrays& arrays, size_t app, const std::string& id, InstanceLoadState& state)
+{
+    for (size_t e = arrays.edge_offsets[app]; e < arrays.edge_offsets[app+1]; ++e)
+    {
+        int target = arrays.edge_targets[e];
+        if ((target < 0) or ((size_t)target >= arrays.nb_apps + arrays.nb_other_ids))
+        {
+            throw std::runtime_error("Affinity of application " + arrays.app_ids[app] + " of instance " + id +
+                                     " with an unknown application " + std::to_string(target));
+        }
+        state.edges.push_back({target, arrays.edge_values[e]});
+    }
+}
+
+// App order[k] gets the internal id k
+template<typename AppList>
+static void renumberApps(AppList& app_list, AffinityGraph& graph)
+{
+    std::vector<int> order = computeLocalityOrder(graph, app_list.size());
+    AppList apps;
+    apps.reserve(app_list.size());
+    for (size_t k = 0; k < app_list.size(); ++k)
+    {
+        apps.push_back(app_list[order[k]]);
+        apps.back()->setInternalId(k);
+    }
+    app_list.swap(apps);
+    graph.renumberNodes(order);
+}
+
+const std::string getFileIdName(const InstanceLoadState& state, int file_id)
+{
+    if (state.file != nullptr)
+    {
+        return state.file->getAppId(file_id);
+    }
+    return state.ids.getName(file_id);
+}
+
+std::vector<int> computeInternalIds(const InstanceLoadState& state, size_t nb_apps, size_t& nb_kept_ids)
+{
+    size_t nb_ids = std::max(state.ids.size(), state.nb_file_ids);
+    std::vector<int> new_ids(nb_ids, -1);
+    for (size_t i = 0; i < nb_apps; ++i)
+    {
+        new_ids[state.app_file_ids[i]] = i;
+    }
+    for (int file_id : state.to_remove)
+    {
+        new_ids[file_id] = -2;
+    }
+
+    // Ids only referenced in affinity lists are kept after the applications
+    int next_id = nb_apps;
+    for (int& new_id : new_ids)
+    {
+        if (new_id == -1)
+        {
+            new_id = next_id++;
+        }
+    }
+    nb_kept_ids = next_id;
+    for (int& new_id : new_ids)
+    {
+        if (new_id == -2)
+        {
+            new_id = next_id++;
+        }
+    }
+    return new_ids;
+}
+
+
+
+Instance2D::Instance2D(std::string id, int bin_cpu_capacity, int bin_memory_capacity,
+                       std::string& filename, InstanceLoadMode load_mode)
+{
+    this->id = id;
+    this->bin_cpu_capacity = bin_cpu_capacity;
+    this->bin_mem_capacity = bin_memory_capacity;
+    sum_cpu = 0;
+    sum_mem = 0;
+    total_replicas = 0;
+    node_index_built = false;
+
+    InstanceLoadState state;
+    std::unique_ptr<BinaryInstanceFile> file; // Its ids are read until the apps are finalized
+    if (isBinaryInstanceFile(filename))
+    {
+        file.reset(new BinaryInstanceFile(filename));
+        loadBinary(*file, *file, state);
+    }
+    else if (load_mode != InstanceLoadMode::Sequential)
+    {
+        loadCSVParallel(filename, load_mode, state);
+    }
+    else
+    {
+        loadCSV(filename, state);
+    }
+    finalizeApplications(state);
+}
+
+Instance2D::Instance2D(std::string id, int bin_cpu_capacity, int bin_memory_capacity,
+                       const BinaryInstanceFile& file):
+    Instance2D(id, bin_cpu_capacity, bin_memory_capacity, file, file)
+{ }
+
+Instance2D::Instance2D(std::string id, int bin_cpu_capacity, int bin_memory_capacity,
+                       const BinaryInstanceFile& baseline, const BinaryInstanceFile& affinities)
+{
+    this->id = id;
+    this->bin_cpu_capacity = bin_cpu_capacity;
+    this->bin_mem_capacity = bin_memory_capacity;
+    sum_cpu = 0;
+    sum_mem = 0;
+    total_replicas = 0;
+    node_index_built = false;
+
+    InstanceLoadState state;
+    loadBinary(baseline, affinities, state);
+    finalizeApplications(state);
+}
 
 Instance2D::Instance2D(std::string id, int bin_cpu_capacity, int bin_memory_capacity,
-                       std::string& filename)
+                       const InstanceArrays2D& arrays)
 {
     this->id = id;
     this->bin_cpu_capacity = bin_cpu_capacity;
@@ -43,72 +245,461 @@ Instance2D::Instance2D(std::string id, int bin_cpu_capacity, int bin_memory_capa
     sum_cpu = 0;
     sum_mem = 0;
     total_replicas = 0;
+    node_index_built = false;
+
+    InstanceLoadState state;
+    loadArrays(arrays, state);
+    finalizeApplications(state);
+}
 
+void Instance2D::loadCSV(std::string& filename, InstanceLoadState& state)
+{
     // Reading the CSV file
-    CSVReader<6, trim_chars<'[', ']'>, no_quote_escape<'\t'>> reader(filename);
+    CSVReader<6, trim_chars<'[', ']'>, no_quote_escape<'\t'>> reader(filename, openInputFile(filename));
     reader.read_header(ignore_extra_column, "app_id", "nb_instances", "core", "memory", "inter_degree", "inter_aff");
     std::string app_id("");
     std::string aff_str("");
     int nb_rep, nb_cpus, nb_memory, degree;
 
-    // Applications that do not fit in the bins must be removed
-    // from the list and from the affinity maps
-    std::vector<std::string> to_remove;
-
-    // Mapps for each app id its affinity_in_map
-    std::unordered_map<std::string, AffinityMap> maps_in;
-
-    int internal_id = 0;
     // For each row create one Application
     while(reader.read_row(app_id, nb_rep, nb_cpus, nb_memory, degree, aff_str))
     {
+        int file_id = state.ids.intern(app_id);
+
         // Make sure the replicas can be allocated to bins
-        if ( (nb_cpus <= bin_cpu_capacity) and (nb_memory <= bin_memory_capacity) )
+        if ( (nb_cpus <= bin_cpu_capacity) and (nb_memory <= bin_mem_capacity) )
+        {
+            // Retrieve the affinities from the affinity string
+            parseAffinityEdges(aff_str, reader.get_file_line(), state.ids, state.edges);
+            addApplication(app_id, file_id, nb_rep, nb_cpus, nb_memory, degree, state);
+        }
+        else
+        {
+            // Else a replica does not fit in a bin, drop the application
+            state.to_remove.push_back(file_id);
+        }
+    }
+}
+
+void Instance2D::loadCSVParallel(std::string& filename, InstanceLoadMode load_mode, InstanceLoadState& state)
+{
+    auto parse_row = [this](const InstanceRow& row, AppRecord2D& record) { parseRecord(row, record); };
+    auto assemble = [this, &state](AppRecord2D& record) { addRecord(record, state); };
+    if (load_mode == InstanceLoadMode::Pipelined)
+    {
+        loadRowsPipelined<AppRecord2D>(filename, getLoaderThreads(), parse_row, assemble);
+    }
+    else
+    {
+        loadRowsChunked<AppRecord2D>(filename, getLoaderThreads(), parse_row, assemble);
+    }
+}
+
+void Instance2D::parseRecord(const InstanceRow& row, AppRecord2D& record) const
+{
+    record.app_id = row.fields[COL_APP_ID];
+    record.nb_rep = parseIntField(row, COL_NB_INSTANCES);
+    record.nb_cpus = parseIntField(row, COL_CORE);
+    record.nb_memory = parseIntField(row, COL_MEMORY);
+    record.degree = parseIntField(row, COL_INTER_DEGREE);
+
+    // Make sure the replicas can be allocated to bins
+    record.fits = (record.nb_cpus <= bin_cpu_capacity) and (record.nb_memory <= bin_mem_capacity);
+    if (record.fits)
+    {
+        parseAffinityList(row.fields[COL_INTER_AFF], row.file_line, record.aff_list_out);
+    }
+}
+
+void Instance2D::addRecord(AppRecord2D& record, InstanceLoadState& state)
+{
+    int file_id = state.ids.intern(record.app_id);
+    if (record.fits)
+    {
+        for (auto& pair : record.aff_list_out)
         {
-            // Retrieve the map of affinities from the affinity string
-            AffinityMap aff_map_out = constructAffinitiyMap(aff_str);
-            
-            // Update the in map of other items
-            for(auto pair : aff_map_out)
+            state.edges.push_back({state.ids.intern(pair.first), pair.second});
+        }
+        addApplication(record.app_id, file_id, record.nb_rep, record.nb_cpus, record.nb_memory,
+                       record.degree, state);
+    }
+    else
+    {
+        state.to_remove.push_back(file_id);
+    }
+}
+
+void Instance2D::loadBinary(const BinaryInstanceFile& file, const BinaryInstanceFile& affinities,
+                            InstanceLoadState& state)
+{
+    if (file.getHeader().kind != BinaryInstanceKind::Fixed2D)
+    {
+        throw std::runtime_error("Binary instance file for instance " + id + " does not contain 2D requirements");
+    }
+    checkAffinitiesFile(file, affinities, id);
+
+    // The resources are the ones of the file, the rest of the affinities file
+    const int32_t* nb_replicas = affinities.getNbReplicas();
+    const int32_t* degrees = affinities.getDegrees();
+    const int32_t* cpu_sizes = file.getCPUSizes();
+    const int32_t* mem_sizes = file.getMemSizes();
+    const uint64_t* edge_offsets = affinities.getEdgeOffsets();
+    const uint32_t* edge_targets = affinities.getEdgeTargets();
+    const int32_t* edge_values = affinities.getEdgeValues();
+
+    // The file id of an app is its index in the id table
+    state.nb_file_ids = affinities.getHeader().nb_ids;
+    state.file = &affinities;
+    app_list.reserve(file.getNbApps());
+    for (size_t i = 0; i < file.getNbApps(); ++i)
+    {
+        std::string app_id = affinities.getAppId(i);
+        if ( (cpu_sizes[i] <= bin_cpu_capacity) and (mem_sizes[i] <= bin_mem_capacity) )
+        {
+            for (uint64_t e = edge_offsets[i]; e < edge_offsets[i+1]; ++e)
             {
-                auto it = maps_in.find(pair.first);
-                if (it != maps_in.end())
-                {
-                    maps_in[pair.first][app_id] = pair.second;
-                }
-                else
-                {
-                    maps_in[pair.first] = AffinityMap();
-                    maps_in[pair.first][app_id] = pair.second;
-                }
+                state.edges.push_back({(int)edge_targets[e], edge_values[e]});
             }
+            addApplication(app_id, i, nb_replicas[i], cpu_sizes[i], mem_sizes[i], degrees[i], state);
+        }
+        else
+        {
+            state.to_remove.push_back(i);
+        }
+    }
+}
+
+void Instance2D::loadArrays(const InstanceArrays2D& arrays, InstanceLoadState& state)
+{
+    internArrayIds(arrays, id, state);
+    app_list.reserve(arrays.nb_apps);
+    for (size_t i = 0; i < arrays.nb_apps; ++i)
+    {
+        std::string app_id = arrays.app_ids[i];
+        if ( (arrays.cpu_sizes[i] <= bin_cpu_capacity) and (arrays.mem_sizes[i] <= bin_mem_capacity) )
+        {
+            addArrayAffinities(arrays, i, id, state);
+            addApplication(app_id, i, arrays.nb_replicas[i], arrays.cpu_sizes[i], arrays.mem_sizes[i],
+                           arrays.degrees[i], state);
+        }
+        else
+        {
+            state.to_remove.push_back(i);
+        }
+    }
+}
+
+void Instance2D::addApplication(std::string& app_id, int file_id, int nb_rep, int nb_cpus, int nb_memory,
+                                int degree, InstanceLoadState& state)
+{
+    // Its affinities were appended to state.edges
+    state.edge_offsets.push_back(state.edges.size());
+    state.app_file_ids.push_back(file_id);
+
+    app_list.push_back(new Application2D(app_id, state.internal_id, nb_rep,
+                                         nb_cpus, nb_memory,
+                                         degree));
+    state.internal_id++;
 
-            app_list.push_back(new Application2D(app_id, internal_id, nb_rep,
-                                                 nb_cpus, nb_memory,
-                                                 degree, aff_map_out));
-            internal_id++;
+    sum_cpu += nb_cpus * nb_rep;
+    sum_mem += nb_memory * nb_rep;
+    total_replicas += nb_rep;
+}
 
-            sum_cpu += nb_cpus * nb_rep;
-            sum_mem += nb_memory * nb_rep;
-            total_replicas += nb_rep;
+void Instance2D::finalizeApplications(InstanceLoadState& state)
+{
+    // Switch the affinities to internal ids, the filtered out apps
+    // are removed from the affinities of remaining apps
+    size_t nb_kept_ids;
+    std::vector<int> new_ids = computeInternalIds(state, app_list.size(), nb_kept_ids);
+    for (AffinityEdge& edge : state.edges)
+    {
+        edge.target = new_ids[edge.target];
+    }
+    affinity_graph.build(app_list.size(), nb_kept_ids, state.edge_offsets, state.edges);
+
+    // Keep the string ids that are not apps for the deltas
+    node_names.resize(nb_kept_ids - app_list.size());
+    for (size_t file_id = 0; file_id < new_ids.size(); ++file_id)
+    {
+        if (new_ids[file_id] >= (int)nb_kept_ids)
+        {
+            filtered_names.push_back(getFileIdName(state, file_id));
+        }
+        else if (new_ids[file_id] >= (int)app_list.size())
+        {
+            node_names[new_ids[file_id] - app_list.size()] = getFileIdName(state, file_id);
+        }
+    }
+
+    for (Application2D* app : app_list)
+    {
+        app->setAffinityGraph(&affinity_graph);
+        app->setParams(sum_cpu, sum_mem, total_replicas, bin_cpu_capacity, bin_mem_capacity);
+    }
+    app_table.build(app_list);
+}
+
+
+void Instance2D::applyDeltas(const std::vector<InstanceDelta>& deltas)
+{
+    buildNodeIndex();
+
+    bool totals_changed = false;
+    for (const InstanceDelta& delta : deltas)
+    {
+        if (delta.op == InstanceDeltaOp::Add)
+        {
+            addDeltaApplication(delta);
+            totals_changed = true;
+        }
+        else if (delta.op == InstanceDeltaOp::Remove)
+        {
+            removeDeltaApplication(delta);
+            totals_changed = true;
+        }
+        else if (delta.op == InstanceDeltaOp::SetReplicas)
+        {
+            Application2D* app = app_list[findDeltaApplication(delta.app_id)];
+            int diff = delta.nb_replicas - app->getNbReplicas();
+            sum_cpu += app->getCPUSize() * diff;
+            sum_mem += app->getMemorySize() * diff;
+            total_replicas += diff;
+            app->setNbReplicas(delta.nb_replicas);
+            totals_changed = true;
         }
         else
         {
-            // Else a replica does not fit in a bin, drop the application
-            to_remove.push_back(app_id);
+            setDeltaAffinities(findDeltaApplication(delta.app_id), delta.affinities);
+        }
+    }
+
+    if (totals_changed)
+    {
+        // The sort keys of all apps depend on the totals
+        for (Application2D* app : app_list)
+        {
+            app->setParams(sum_cpu, sum_mem, total_replicas, bin_cpu_capacity, bin_mem_capacity);
+        }
+        app_table.build(app_list);
+    }
+}
+
+void Instance2D::renumberApplications()
+{
+    renumberApps(app_list, affinity_graph);
+    app_table.build(app_list);
+    if (node_index_built)
+    {
+        for (size_t node = 0; node < app_list.size(); ++node)
+        {
+            node_names[node] = app_list[node]->getId();
+            node_index[node_names[node]] = node;
         }
     }
+}
 
-    // Remove the filtered out apps from the affinity map
-    // of remaining apps
+void Instance2D::buildNodeIndex()
+{
+    if (node_index_built)
+    {
+        return;
+    }
+    // Nodes of the affinity graph: the apps then the unknown ids
+    std::vector<std::string> names;
+    names.reserve(app_list.size() + node_names.size());
     for (Application2D* app : app_list)
     {
-        app->setAffinityInMap(maps_in[app->getId()]);
-        app->removeAppsAffinity(to_remove);
-        app->setParams(sum_cpu, sum_mem, total_replicas, bin_cpu_capacity, bin_memory_capacity);
+        names.push_back(app->getId());
+    }
+    names.insert(names.end(), node_names.begin(), node_names.end());
+    node_names.swap(names);
+
+    for (size_t node = 0; node < node_names.size(); ++node)
+    {
+        node_index[node_names[node]] = node;
+    }
+    for (const std::string& name : filtered_names)
+    {
+        node_index[name] = -1;
+    }
+    filtered_names.clear();
+    node_index_built = true;
+}
+
+int Instance2D::findDeltaApplication(const std::string& app_id) const
+{
+    auto it = node_index.find(app_id);
+    if ((it == node_index.end()) or (it->second < 0) or (it->second >= (int)app_list.size()))
+    {
+        throw std::runtime_error("Unknown application " + app_id + " in instance " + id);
     }
+    return it->second;
 }
 
+void Instance2D::addDeltaApplication(const InstanceDelta& delta)
+{
+    auto it = node_index.find(delta.app_id);
+    // Node of an id only referenced in affinity lists until now
+    int node = ((it != node_index.end()) and (it->second >= 0)) ? it->second : -1;
+    if ((node >= 0) and (node < (int)app_list.size()))
+    {
+        throw std::runtime_error("Application " + delta.app_id + " already in instance " + id);
+    }
+
+    // Make sure the replicas can be allocated to bins
+    if ( (delta.nb_cpus > bin_cpu_capacity) or (delta.nb_memory > bin_mem_capacity) )
+    {
+        // Else the app is dropped from the affinity lists
+        if (node >= 0)
+        {
+            affinity_graph.dropInEdges(node);
+            std::vector<int> unused(1, node);
+            removeUnusedNodes(unused);
+        }
+        node_index[delta.app_id] = -1;
+        return;
+    }
+
+    if (node < 0)
+    {
+        node = affinity_graph.addNode();
+        node_names.push_back(delta.app_id);
+        node_index[delta.app_id] = node;
+    }
+    // The first node after the apps becomes the new app
+    int app_id = app_list.size();
+    swapGraphNodes(node, app_id);
+
+    std::string name = delta.app_id;
+    Application2D* app = new Application2D(name, app_id, delta.nb_replicas,
+                                           delta.nb_cpus, delta.nb_memory, delta.degree);
+    app->setAffinityGraph(&affinity_graph);
+    app_list.push_back(app);
+    setDeltaAffinities(app_id, delta.affinities);
+
+    sum_cpu += delta.nb_cpus * delta.nb_replicas;
+    sum_mem += delta.nb_memory * delta.nb_replicas;
+    total_replicas += delta.nb_replicas;
+}
+
+void Instance2D::removeDeltaApplication(const InstanceDelta& delta)
+{
+    int app_id = findDeltaApplication(delta.app_id);
+    Application2D* app = app_list[app_id];
+    sum_cpu -= app->getCPUSize() * app->getNbReplicas();
+    sum_mem -= app->getMemorySize() * app->getNbReplicas();
+    total_replicas -= app->getNbReplicas();
+
+    // Other apps may still reference it, as an unknown id
+    std::vector<int> unused;
+    for (const AffinityEdge& edge : affinity_graph.getOut(app_id))
+    {
+        unused.push_back(edge.target);
+    }
+    std::vector<AffinityEdge> no_edges;
+    affinity_graph.setOut(app_id, no_edges, 0);
+
+    // The last app takes its internal id
+    int last = app_list.size() - 1;
+    swapGraphNodes(app_id, last);
+    std::swap(app_list[app_id], app_list[last]);
+    app_list[app_id]->setInternalId(app_id);
+    app_list.pop_back();
+    delete app;
+
+    for (int& node : unused)
+    {
+        node = (node == app_id) ? last : ((node == last) ? app_id : node);
+    }
+    unused.push_back(last);
+    removeUnusedNodes(unused);
+}
+
+void Instance2D::setDeltaAffinities(int app_id, const AffinityList& affinities)
+{
+    std::vector<int> unused;
+    for (const AffinityEdge& edge : affinity_graph.getOut(app_id))
+    {
+        unused.push_back(edge.target);
+    }
+
+    // Filtered out apps get negative ids, only counted once per app
+    std::unordered_map<std::string, int> filtered;
+    std::vector<AffinityEdge> edges;
+    edges.reserve(affinities.size());
+    for (const auto& pair : affinities)
+    {
+        auto it = node_index.find(pair.first);
+        if (it == node_index.end())
+        {
+            int node = affinity_graph.addNode();
+            node_names.push_back(pair.first);
+            it = node_index.insert({pair.first, node}).first;
+        }
+        if (it->second >= 0)
+        {
+            edges.push_back({it->second, pair.second});
+        }
+        else
+        {
+            int filtered_id = -1 - (int)filtered.insert({pair.first, filtered.size()}).first->second;
+            edges.push_back({filtered_id, pair.second});
+        }
+    }
+    sortAffinityList(edges);
+    auto first_kept = std::find_if(edges.begin(), edges.end(), [](const AffinityEdge& edge) {
+        return edge.target >= 0;
+    });
+    int nb_dropped = first_kept - edges.begin();
+    edges.erase(edges.begin(), first_kept);
+    affinity_graph.setOut(app_id, edges, nb_dropped);
+
+    // Only the degrees of the app and of its old and new targets change,
+    // the table is built again after the deltas that add or remove apps
+    std::vector<int> changed(unused);
+    changed.push_back(app_id);
+    for (const AffinityEdge& edge : affinity_graph.getOut(app_id))
+    {
+        changed.push_back(edge.target);
+    }
+    for (int node : changed)
+    {
+        if ((node < (int)app_list.size()) and (node < (int)app_table.size()))
+        {
+            app_table.setTotalDegree(node, affinity_graph.getTotalDegree(node));
+        }
+    }
+
+    removeUnusedNodes(unused);
+}
+
+void Instance2D::swapGraphNodes(int a, int b)
+{
+    affinity_graph.swapNodes(a, b);
+    std::swap(node_names[a], node_names[b]);
+    node_index[node_names[a]] = a;
+    node_index[node_names[b]] = b;
+}
+
+void Instance2D::removeUnusedNodes(std::vector<int>& nodes)
+{
+    // Removing a node moves the last one, so go from the last ids
+    std::sort(nodes.begin(), nodes.end());
+    nodes.erase(std::unique(nodes.begin(), nodes.end()), nodes.end());
+    for (auto it = nodes.rbegin(); it != nodes.rend(); ++it)
+    {
+        int node = *it;
+        if ((node >= (int)app_list.size()) and affinity_graph.getIn(node).empty())
+        {
+            int last = affinity_graph.getNbNodes() - 1;
+            swapGraphNodes(node, last);
+            node_index.erase(node_names[last]);
+            node_names.pop_back();
+            affinity_graph.removeLastNode();
+        }
+    }
+}
 
 Instance2D::~Instance2D()
 {
@@ -141,6 +732,16 @@ const AppList2D& Instance2D::getApps() const
     return app_list;
 }
 
+const AppTable& Instance2D::getAppTable() const
+{
+    return app_table;
+}
+
+const AffinityGraph& Instance2D::getAffinityGraph() const
+{
+    return affinity_graph;
+}
+
 const int Instance2D::getSumCPU() const
 {
     return sum_cpu;
@@ -162,17 +763,101 @@ const int Instance2D::getTotalReplicas() const
 InstanceTS::InstanceTS(std::string id, int bin_cpu_capacity,
                        int bin_mem_capacity,
                        std::string& filename,
-                       size_t size_series):
+                       size_t size_series,
+                       InstanceLoadMode load_mode,
+                       SeriesStorage storage,
+                       SeriesPrecision precision):
     id(id),
     bin_cpu_capacity(bin_cpu_capacity),
     bin_mem_capacity(bin_mem_capacity),
     TS_size(size_series),
+    storage(storage),
+    precision(precision),
     total_replicas(0),
     sum_cpu_TS(size_series, 0.0),
-    sum_mem_TS(size_series, 0.0)
+    sum_mem_TS(size_series, 0.0),
+    total_sum_cpu_mem(0.0)
+{
+    InstanceLoadState state;
+    if (isBinaryInstanceFile(filename))
+    {
+        std::unique_ptr<BinaryInstanceFile> file = std::make_unique<BinaryInstanceFile>(filename);
+        loadBinary(*file, *file, state);
+        if (storage == SeriesStorage::Mapped)
+        {
+            // The apps reference its series
+            mapped_file = std::move(file);
+        }
+    }
+    else if (load_mode != InstanceLoadMode::Sequential)
+    {
+        loadCSVParallel(filename, load_mode, state);
+    }
+    else
+    {
+        loadCSV(filename, state);
+    }
+    finalizeApplications(state);
+}
+
+InstanceTS::InstanceTS(std::string id, int bin_cpu_capacity,
+                       int bin_mem_capacity,
+                       const BinaryInstanceFile& file,
+                       size_t size_series,
+                       SeriesStorage storage,
+                       SeriesPrecision precision):
+    InstanceTS(id, bin_cpu_capacity, bin_mem_capacity, file, file, size_series, storage, precision)
+{ }
+
+InstanceTS::InstanceTS(std::string id, int bin_cpu_capacity,
+                       int bin_mem_capacity,
+                       const BinaryInstanceFile& baseline,
+                       const BinaryInstanceFile& affinities,
+                       size_t size_series,
+                       SeriesStorage storage,
+                       SeriesPrecision precision):
+    id(id),
+    bin_cpu_capacity(bin_cpu_capacity),
+    bin_mem_capacity(bin_mem_capacity),
+    TS_size(size_series),
+    storage(storage),
+    precision(precision),
+    total_replicas(0),
+    sum_cpu_TS(size_series, 0.0),
+    sum_mem_TS(size_series, 0.0),
+    total_sum_cpu_mem(0.0)
+{
+    InstanceLoadState state;
+    loadBinary(baseline, affinities, state);
+    finalizeApplications(state);
+}
+
+InstanceTS::InstanceTS(std::string id, int bin_cpu_capacity,
+                       int bin_mem_capacity,
+                       const InstanceArraysTS& arrays,
+                       size_t size_series,
+                       SeriesStorage storage,
+                       SeriesPrecision precision):
+    id(id),
+    bin_cpu_capacity(bin_cpu_capacity),
+    bin_mem_capacity(bin_mem_capacity),
+    TS_size(size_series),
+    storage(storage),
+    precision(precision),
+    total_replicas(0),
+    sum_cpu_TS(size_series, 0.0),
+    sum_mem_TS(size_series, 0.0),
+    total_sum_cpu_mem(0.0)
+{
+    InstanceLoadState state;
+    loadArrays(arrays, state);
+    finalizeApplications(state);
+}
+
+void InstanceTS::loadCSV(std::string& filename, InstanceLoadState& state)
 {
     // Reading the CSV file
-    CSVReader<6, trim_chars<'[', ']'>, no_quote_escape<'\t'>> reader(filename);
+    CSVReader<6, trim_chars<'[', ']'>, no_quote_escape<'\t'>> reader(filename, openInputFile(filename));
     reader.read_header(ignore_extra_column, "app_id", "nb_instances", "core", "memory", "inter_degree", "inter_aff");
     std::string app_id("");
     std::string aff_str("");
@@ -180,85 +865,285 @@ InstanceTS::InstanceTS(std::string id, int bin_cpu_capacity,
     std::string mem_usage_str;
     int nb_rep, degree;
 
-    // Applications that do not fit in the bins must be removed
-    // from the list and from the affinity maps
-    std::vector<std::string> to_remove;
+    ResourceTS cpu_usage;
+    ResourceTS mem_usage;
 
-    // Mapps for each app id its affinity_in_map
-    std::unordered_map<std::string, AffinityMap> maps_in;
-
-    float total_sum_cpu_mem = 0.0;
-
-    int internal_id = 0;
     // For each row create one Application
     while(reader.read_row(app_id, nb_rep, cpu_usage_str, mem_usage_str, degree, aff_str))
     {
+        // The buffers are moved into the kept applications
+        cpu_usage.resize(TS_size);
+        mem_usage.resize(TS_size);
         float peak_cpu, sum_cpu;
         float peak_mem, sum_mem;
-        ResourceTS cpu_usage = retrieveResourceTS(cpu_usage_str, peak_cpu, sum_cpu);
-        ResourceTS mem_usage = retrieveResourceTS(mem_usage_str, peak_mem, sum_mem);
+        unsigned row = reader.get_file_line();
+        size_t cpu_size = parseResourceTS(cpu_usage_str, row, cpu_usage.data(), TS_size, peak_cpu, sum_cpu);
+        size_t mem_size = parseResourceTS(mem_usage_str, row, mem_usage.data(), TS_size, peak_mem, sum_mem);
 
-        if( (cpu_usage.size() != size_series) or (mem_usage.size() != size_series))
+        if( (cpu_size != TS_size) or (mem_size != TS_size))
         {
             // Problem in the resource usage of the application!
             std::string s = "Wrong size of resource usage for application " + app_id + ": found sizes ";
-            s += std::to_string(cpu_usage.size()) + " and " + std::to_string(mem_usage.size());
+            s += std::to_string(cpu_size) + " and " + std::to_string(mem_size);
             throw std::runtime_error(s);
         }
 
+        int file_id = state.ids.intern(app_id);
+
         // Make sure the replicas can be allocated to bins
         if ( (peak_cpu <= bin_cpu_capacity) and (peak_mem <= bin_mem_capacity) )
         {
-            // Retrieve the map of affinities from the affinity string
-            AffinityMap aff_map_out = constructAffinitiyMap(aff_str);
+            // Retrieve the affinities from the affinity string
+            parseAffinityEdges(aff_str, row, state.ids, state.edges);
+            addApplication(new ApplicationTS(app_id, state.internal_id, nb_rep, TS_size,
+                                             std::move(cpu_usage), std::move(mem_usage),
+                                             peak_cpu, peak_mem, degree),
+                           file_id, sum_cpu, sum_mem, state);
+        }
+        else
+        {
+            // Else a replica does not fit in a bin, drop the application
+            state.to_remove.push_back(file_id);
+        }
+    }
+}
 
-            // Update the in map of other items
-            for(auto pair : aff_map_out)
+void InstanceTS::loadCSVParallel(std::string& filename, InstanceLoadMode load_mode, InstanceLoadState& state)
+{
+    auto parse_row = [this](const InstanceRow& row, AppRecordTS& record) { parseRecord(row, record); };
+    auto assemble = [this, &state](AppRecordTS& record) { addRecord(record, state); };
+    if (load_mode == InstanceLoadMode::Pipelined)
+    {
+        loadRowsPipelined<AppRecordTS>(filename, getLoaderThreads(), parse_row, assemble);
+    }
+    else
+    {
+        loadRowsChunked<AppRecordTS>(filename, getLoaderThreads(), parse_row, assemble);
+    }
+}
+
+void InstanceTS::parseRecord(const InstanceRow& row, AppRecordTS& record) const
+{
+    record.app_id = row.fields[COL_APP_ID];
+    record.nb_rep = parseIntField(row, COL_NB_INSTANCES);
+    record.degree = parseIntField(row, COL_INTER_DEGREE);
+
+    record.cpu_usage.resize(TS_size);
+    record.mem_usage.resize(TS_size);
+    size_t cpu_size = parseResourceTS(row.fields[COL_CORE], row.file_line,
+                                      record.cpu_usage.data(), TS_size, record.peak_cpu, record.sum_cpu);
+    size_t mem_size = parseResourceTS(row.fields[COL_MEMORY], row.file_line,
+                                      record.mem_usage.data(), TS_size, record.peak_mem, record.sum_mem);
+    if( (cpu_size != TS_size) or (mem_size != TS_size))
+    {
+        // Problem in the resource usage of the application!
+        std::string s = "Wrong size of resource usage for application " + record.app_id + ": found sizes ";
+        s += std::to_string(cpu_size) + " and " + std::to_string(mem_size);
+        throw std::runtime_error(s);
+    }
+
+    // Make sure the replicas can be allocated to bins
+    record.fits = (record.peak_cpu <= bin_cpu_capacity) and (record.peak_mem <= bin_mem_capacity);
+    if (record.fits)
+    {
+        parseAffinityList(row.fields[COL_INTER_AFF], row.file_line, record.aff_list_out);
+    }
+}
+
+void InstanceTS::addRecord(AppRecordTS& record, InstanceLoadState& state)
+{
+    int file_id = state.ids.intern(record.app_id);
+    if (record.fits)
+    {
+        for (auto& pair : record.aff_list_out)
+        {
+            state.edges.push_back({state.ids.intern(pair.first), pair.second});
+        }
+        addApplication(new ApplicationTS(record.app_id, state.internal_id, record.nb_rep, TS_size,
+                                         std::move(record.cpu_usage), std::move(record.mem_usage),
+                                         record.peak_cpu, record.peak_mem, record.degree),
+                       file_id, record.sum_cpu, record.sum_mem, state);
+    }
+    else
+    {
+        state.to_remove.push_back(file_id);
+    }
+}
+
+void InstanceTS::loadBinary(const BinaryInstanceFile& file, const BinaryInstanceFile& affinities,
+                            InstanceLoadState& state)
+{
+    if (file.getHeader().kind != BinaryInstanceKind::TimeSeries)
+    {
+        throw std::runtime_error("Binary instance file for instance " + id + " does not contain time series");
+    }
+    if (file.getTSLength() != TS_size)
+    {
+        std::string s = "Wrong size of resource usage in binary instance " + id + ": found size ";
+        s += std::to_string(file.getTSLength()) + " instead of " + std::to_string(TS_size);
+        throw std::runtime_error(s);
+    }
+    checkAffinitiesFile(file, affinities, id);
+
+    // The resources are the ones of the file, the rest of the affinities file
+    const int32_t* nb_replicas = affinities.getNbReplicas();
+    const int32_t* degrees = affinities.getDegrees();
+    const float* cpu_series = file.getCPUSeries();
+    const float* mem_series = file.getMemSeries();
+    const float* peak_cpu = file.getPeakCPU();
+    const float* peak_mem = file.getPeakMem();
+    const float* sum_cpu = file.getSumCPU();
+    const float* sum_mem = file.getSumMem();
+    const uint64_t* edge_offsets = affinities.getEdgeOffsets();
+    const uint32_t* edge_targets = affinities.getEdgeTargets();
+    const int32_t* edge_values = affinities.getEdgeValues();
+
+    if (storage == SeriesStorage::Mapped)
+    {
+        file.adviseRandomAccess();
+    }
+
+    // The file id of an app is its index in the id table
+    state.nb_file_ids = affinities.getHeader().nb_ids;
+    app_list.reserve(file.getNbApps());
+    for (size_t i = 0; i < file.getNbApps(); ++i)
+    {
+        std::string app_id = affinities.getAppId(i);
+        if ( (peak_cpu[i] <= bin_cpu_capacity) and (peak_mem[i] <= bin_mem_capacity) )
+        {
+            for (uint64_t e = edge_offsets[i]; e < edge_offsets[i+1]; ++e)
+            {
+                state.edges.push_back({(int)edge_targets[e], edge_values[e]});
+            }
+            ApplicationTS* app;
+            if (storage == SeriesStorage::Mapped)
             {
-                auto it = maps_in.find(pair.first);
-                if (it != maps_in.end())
-                {
-                    maps_in[pair.first][app_id] = pair.second;
-                }
-                else
-                {
-                    maps_in[pair.first] = AffinityMap();
-                    maps_in[pair.first][app_id] = pair.second;
-                }
+                app = new ApplicationTS(app_id, state.internal_id, nb_replicas[i],
+                                        SeriesSpan(cpu_series + i*TS_size, TS_size),
+                                        SeriesSpan(mem_series + i*TS_size, TS_size),
+                                        peak_cpu[i], peak_mem[i], degrees[i]);
             }
+            else
+            {
+                app = new ApplicationTS(app_id, state.internal_id, nb_replicas[i], TS_size,
+                                        ResourceTS(cpu_series + i*TS_size, cpu_series + (i+1)*TS_size),
+                                        ResourceTS(mem_series + i*TS_size, mem_series + (i+1)*TS_size),
+                                        peak_cpu[i], peak_mem[i], degrees[i]);
+            }
+            addApplication(app, i, sum_cpu[i], sum_mem[i], state);
+        }
+        else
+        {
+            state.to_remove.push_back(i);
+        }
+    }
+}
+
+// Peak and sum of a series, computed as when it is parsed
+static void computePeakSum(const float* series, size_t size, float& peak, float& sum)
+{
+    peak = 0.0;
+    sum = 0.0;
+    for (size_t t = 0; t < size; ++t)
+    {
+        if (series[t] > peak)
+        {
+            peak = series[t];
+        }
+        sum += series[t];
+    }
+}
 
-            app_list.push_back(new ApplicationTS(app_id, internal_id, nb_rep, size_series,
-                                    cpu_usage, mem_usage,
-                                    peak_cpu, peak_mem,
-                                    degree, aff_map_out));
-            internal_id++;
+void InstanceTS::loadArrays(const InstanceArraysTS& arrays, InstanceLoadState& state)
+{
+    internArrayIds(arrays, id, state);
+    app_list.reserve(arrays.nb_apps);
+    for (size_t i = 0; i < arrays.nb_apps; ++i)
+    {
+        std::string app_id = arrays.app_ids[i];
+        const float* cpu_series = arrays.cpu_series + i*TS_size;
+        const float* mem_series = arrays.mem_series + i*TS_size;
+        float peak_cpu, sum_cpu;
+        float peak_mem, sum_mem;
+        computePeakSum(cpu_series, TS_size, peak_cpu, sum_cpu);
+        computePeakSum(mem_series, TS_size, peak_mem, sum_mem);
 
-            // Update some counters
-            for (int i = 0; i< size_series; ++i)
+        // Make sure the replicas can be allocated to bins
+        if ( (peak_cpu <= bin_cpu_capacity) and (peak_mem <= bin_mem_capacity) )
+        {
+            addArrayAffinities(arrays, i, id, state);
+            ApplicationTS* app;
+            if (storage == SeriesStorage::Mapped)
             {
-                sum_cpu_TS[i] += nb_rep * cpu_usage[i];
-                sum_mem_TS[i] += nb_rep * mem_usage[i];
+                app = new ApplicationTS(app_id, state.internal_id, arrays.nb_replicas[i],
+                                        SeriesSpan(cpu_series, TS_size), SeriesSpan(mem_series, TS_size),
+                                        peak_cpu, peak_mem, arrays.degrees[i]);
             }
-            total_sum_cpu_mem += nb_rep * (sum_cpu + sum_mem);
-            total_replicas += nb_rep;
+            else
+            {
+                app = new ApplicationTS(app_id, state.internal_id, arrays.nb_replicas[i], TS_size,
+                                        ResourceTS(cpu_series, cpu_series + TS_size),
+                                        ResourceTS(mem_series, mem_series + TS_size),
+                                        peak_cpu, peak_mem, arrays.degrees[i]);
+            }
+            addApplication(app, i, sum_cpu, sum_mem, state);
         }
         else
         {
-            // Else a replica does not fit in a bin, drop the application
-            to_remove.push_back(app_id);
+            state.to_remove.push_back(i);
         }
     }
-    // Remove the filtered out apps from the affinity map
-    // of remaining apps
+}
+
+void InstanceTS::addApplication(ApplicationTS* app, int file_id, float sum_cpu, float sum_mem,
+                                InstanceLoadState& state)
+{
+    // Its affinities were appended to state.edges
+    state.edge_offsets.push_back(state.edges.size());
+    state.app_file_ids.push_back(file_id);
+
+    app_list.push_back(app);
+    state.internal_id++;
+
+    // Update some counters
+    int nb_rep = app->getNbReplicas();
+    SeriesSpan cpu_usage = app->getCpuUsage();
+    SeriesSpan mem_usage = app->getMemUsage();
+    for (int i = 0; i< TS_size; ++i)
+    {
+        sum_cpu_TS[i] += nb_rep * cpu_usage[i];
+        sum_mem_TS[i] += nb_rep * mem_usage[i];
+    }
+    total_sum_cpu_mem += nb_rep * (sum_cpu + sum_mem);
+    total_replicas += nb_rep;
+}
+
+void InstanceTS::finalizeApplications(InstanceLoadState& state)
+{
+    // Switch the affinities to internal ids, the filtered out apps
+    // are removed from the affinities of remaining apps
+    size_t nb_kept_ids;
+    std::vector<int> new_ids = computeInternalIds(state, app_list.size(), nb_kept_ids);
+    for (AffinityEdge& edge : state.edges)
+    {
+        edge.target = new_ids[edge.target];
+    }
+    affinity_graph.build(app_list.size(), nb_kept_ids, state.edge_offsets, state.edges);
+
     for (ApplicationTS* app : app_list)
     {
-        app->setAffinityInMap(maps_in[app->getId()]);
-        app->removeAppsAffinity(to_remove);
+        app->setAffinityGraph(&affinity_graph);
         app->setParams(sum_cpu_TS, sum_mem_TS, total_sum_cpu_mem,
                        total_replicas, bin_cpu_capacity, bin_mem_capacity);
+        app->setPrecision(precision);
     }
 }
 
+void InstanceTS::renumberApplications()
+{
+    renumberApps(app_list, affinity_graph);
+}
+
 InstanceTS::~InstanceTS()
 {
     for (ApplicationTS* app : app_list)
@@ -290,11 +1175,21 @@ const AppListTS& InstanceTS::getApps() const
     return app_list;
 }
 
+const AffinityGraph& InstanceTS::getAffinityGraph() const
+{
+    return affinity_graph;
+}
+
 const size_t InstanceTS::getTSLength() const
 {
     return TS_size;
 }
 
+const SeriesPrecision InstanceTS::getSeriesPrecision() const
+{
+    return precision;
+}
+
 const int InstanceTS::getTotalReplicas() const
 {
     return total_replicas;
@@ -311,27 +1206,108 @@ const ResourceTS& InstanceTS::getSumMemTS() const
 }
 
 
-ResourceTS retrieveResourceTS(std::string resource_str, float &peak, float &sum)
+ResourceTS retrieveResourceTS(const std::string& resource_str, float &peak, float &sum)
+{
+    // One value more than the number of separators
+    ResourceTS vect(std::count(resource_str.begin(), resource_str.end(), ',') + 1);
+    size_t size = parseResourceTS(resource_str, 0, vect.data(), vect.size(), peak, sum);
+    vect.resize(size);
+    return vect;
+}
+
+size_t parseResourceTS(std::string_view resource_str, unsigned row,
+                       float* buffer, size_t buffer_size, float &peak, float &sum)
 {
-    ResourceTS vect;
+    const char* data = resource_str.data();
+    const char* end = data + resource_str.size();
+    const char* p = data;
+    size_t nb_values = 0;
     peak = 0.0;
     sum = 0.0;
-    float val;
-    std::string str_val;
-    std::istringstream splitStream(resource_str);
 
-    while(std::getline(splitStream, str_val, ','))
+    while ((p < end) and (*p == ' '))
+    {
+        ++p;
+    }
+    while (p < end)
     {
-        str_val.erase(std::remove(str_val.begin(), str_val.end(), ' '), str_val.end());
-        val = std::stof(str_val);
-        vect.push_back(val);
+        if (*p == '+')
+        {
+            ++p;
+        }
+        float val;
+        auto res = std::from_chars(p, end, val);
+        if (res.ec != std::errc())
+        {
+            throwFieldParseError("resource series", resource_str, p - data, row, "a value");
+        }
+        p = res.ptr;
 
+        if (nb_values < buffer_size)
+        {
+            buffer[nb_values] = val;
+        }
+        nb_values++;
         if (val > peak)
         {
             peak = val;
         }
         sum += val;
 
+        // Separator before the next value
+        while ((p < end) and (*p == ' '))
+        {
+            ++p;
+        }
+        if (p < end)
+        {
+            if (*p != ',')
+            {
+                throwFieldParseError("resource series", resource_str, p - data, row, "','");
+            }
+            ++p;
+            while ((p < end) and (*p == ' '))
+            {
+                ++p;
+            }
+            if (p == end)
+            {
+                // Empty field after a trailing ','
+                throwFieldParseError("resource series", resource_str, p - data, row, "a value");
+            }
+        }
     }
-    return vect;
+    return nb_values;
+}
+
+// Shortest digits giving back the same value, with ".0" for integers as in Python
+template<typename T>
+static void formatValues(std::string& out, const T* values, size_t size)
+{
+    char buffer[32];
+    out += '[';
+    for (size_t t = 0; t < size; ++t)
+    {
+        if (t > 0)
+        {
+            out += ", ";
+        }
+        auto res = std::to_chars(buffer, buffer + sizeof(buffer), values[t]);
+        out.append(buffer, res.ptr);
+        if (std::find_if(buffer, res.ptr, [](char c) { return (c == '.') or (c == 'e') or (c == 'n'); }) == res.ptr)
+        {
+            out += ".0";
+        }
+    }
+    out += ']';
+}
+
+void formatResourceTS(std::string& out, const float* values, size_t size)
+{
+    formatValues(out, values, size);
+}
+
+void formatResourceTS(std::string& out, const double* values, size_t size)
+{
+    formatValues(out, values, size);
 }
@@ -1,25 +1,268 @@
 #ifndef INSTANCE_HPP
 #define INSTANCE_HPP
 
+#include "app_table.hpp"
 #include "application.hpp"
 
+#include <charconv>
+#include <memory>
+#include <string_view>
+#include <unordered_map>
 
-void my_trim(std::string& s);
-AffinityMap constructAffinitiyMap(std::string& aff_str);
+class BinaryInstanceFile;
+struct InstanceRow;
+struct InstanceDelta;
+
+
+// Throw a std::runtime_error locating the malformed part of a field
+[[noreturn]] void throwFieldParseError(const char* field_name, std::string_view str,
+                                       size_t pos, unsigned row, const char* expected);
+
+// Single pass parser of an affinity list "(app_b, k), (app_c, k), ..."
+// (the surrounding brackets are trimmed by the CSV reader)
+// add_edge(app_b, k) is called for each pair in the order of the list,
+// app_b is a view on aff_str so nothing is allocated by the parser
+// Malformed input throws a std::runtime_error with the row and column
+template<typename AddEdge>
+void parseAffinityList(std::string_view aff_str, unsigned row, AddEdge&& add_edge)
+{
+    const char* data = aff_str.data();
+    const size_t size = aff_str.size();
+    size_t pos = 0;
+    auto skip_spaces = [&]() {
+        while ((pos < size) and (data[pos] == ' '))
+        {
+            ++pos;
+        }
+    };
+
+    skip_spaces();
+    while (pos < size)
+    {
+        if (data[pos] != '(')
+        {
+            throwFieldParseError("affinity list", aff_str, pos, row, "'('");
+        }
+        ++pos;
+        skip_spaces();
+
+        size_t id_start = pos;
+        while ((pos < size) and (data[pos] != ',') and (data[pos] != ' ') and (data[pos] != ')'))
+        {
+            ++pos;
+        }
+        if (pos == id_start)
+        {
+            throwFieldParseError("affinity list", aff_str, pos, row, "an application id");
+        }
+        std::string_view app_b(data + id_start, pos - id_start);
+        skip_spaces();
+        if ((pos >= size) or (data[pos] != ','))
+        {
+            throwFieldParseError("affinity list", aff_str, pos, row, "','");
+        }
+        ++pos;
+        skip_spaces();
+
+        int k;
+        auto res = std::from_chars(data + pos, data + size, k);
+        if (res.ec != std::errc())
+        {
+            throwFieldParseError("affinity list", aff_str, pos, row, "an affinity value");
+        }
+        pos = res.ptr - data;
+        skip_spaces();
+        if ((pos >= size) or (data[pos] != ')'))
+        {
+            throwFieldParseError("affinity list", aff_str, pos, row, "')'");
+        }
+        ++pos;
+
+        add_edge(app_b, k);
+
+        // Separator before the next pair
+        skip_spaces();
+        if (pos < size)
+        {
+            if (data[pos] != ',')
+            {
+                throwFieldParseError("affinity list", aff_str, pos, row, "','");
+            }
+            ++pos;
+            skip_spaces();
+            if (pos >= size)
+            {
+                throwFieldParseError("affinity list", aff_str, pos, row, "'('");
+            }
+        }
+    }
+}
+
+// Dense integer ids given to the string ids of an instance file,
+// in order of first appearance
+class AppIdTable
+{
+public:
+    int intern(std::string_view app_id);
+    const size_t size() const;
+    const std::string& getName(int id) const;
+
+private:
+    std::unordered_map<std::string, int> index;
+    std::vector<std::string> names;
+};
+
+// Append the pairs of the affinity list to edges, the ids of the
+// other applications are interned in the table
+void parseAffinityEdges(std::string_view aff_str, unsigned row, AppIdTable& ids, std::vector<AffinityEdge>& edges);
+
+// Pairs (app_b, k) of an affinity list, in the order of the list
+using AffinityList = std::vector<std::pair<std::string, int>>;
+void parseAffinityList(std::string_view aff_str, unsigned row, AffinityList& aff_list);
+
+// Bookkeeping shared by the instance loaders while reading the applications
+// The affinity targets are first file ids (the index of the string id in
+// the file), they are renumbered to the internal ids of the applications
+// once all of them are known, then the affinity graph is built.
+struct InstanceLoadState
+{
+    AppIdTable ids;         // File ids of the CSV files
+    size_t nb_file_ids = 0; // Size of the id table of the binary files
+    const BinaryInstanceFile* file = nullptr; // Id table of the binary files
+
+    // Applications that do not fit in the bins must be removed
+    // from the list and from the affinity lists
+    std::vector<int> to_remove;
+
+    // Affinity lists of the applications, in order
+    std::vector<size_t> edge_offsets = std::vector<size_t>(1, 0);
+    std::vector<AffinityEdge> edges;
+
+    std::vector<int> app_file_ids; // File id of each application
+    int internal_id = 0;
+};
+
+// How the CSV files are read, the binary files are always memory-mapped
+enum class InstanceLoadMode
+{
+    Sequential, // Each row is read, parsed and added in turn
+    Pipelined,  // A reader thread feeds parser threads, rows are added in order
+    Chunked     // The file is split in one chunk of rows per thread, the chunks
+                // are parsed in parallel then merged in order
+};
+
+// Load mode named sequential, pipelined or chunked, throws std::runtime_error otherwise
+InstanceLoadMode parseInstanceLoadMode(const std::string& name);
+// Number of parser threads of the parallel load modes, 0 (the default) for
+// one thread per core
+void setLoaderThreads(unsigned nb_threads);
+
+// Where the series of the apps of an InstanceTS are stored
+enum class SeriesStorage
+{
+    Copied, // Each app owns its series
+    Mapped  // The apps reference the series of the memory-mapped binary file,
+            // the pages are only loaded when the series are read and can be
+            // evicted, or the series arrays of the caller
+            // The series of CSV files are always copied
+};
+
+// Content of one row of a CSV file, built by the parser threads
+struct AppRecord2D
+{
+    std::string app_id;
+    int nb_rep, nb_cpus, nb_memory, degree;
+    bool fits; // Whether a replica fits in a bin, else the app is dropped
+    AffinityList aff_list_out; // Interned in file order when the record is added
+};
+
+struct AppRecordTS
+{
+    std::string app_id;
+    int nb_rep, degree;
+    ResourceTS cpu_usage, mem_usage;
+    float peak_cpu, peak_mem, sum_cpu, sum_mem;
+    bool fits;
+    AffinityList aff_list_out;
+};
+
+// Applications given in arrays owned by the caller, e.g. the state of a
+// cluster, to build an instance without writing and parsing a file
+// Entry i of the arrays is the app app_ids[i], its affinities are the pairs
+// (edge_targets[e], edge_values[e]) for e in [edge_offsets[i], edge_offsets[i+1]),
+// the targets being indexes in app_ids. The apps are filtered as in the files.
+struct InstanceArrays2D
+{
+    size_t nb_apps = 0;
+    size_t nb_other_ids = 0; // Ids after the apps in app_ids, only referenced by affinities
+    const std::string* app_ids = nullptr;
+    const int* nb_replicas = nullptr;
+    const int* cpu_sizes = nullptr;
+    const int* mem_sizes = nullptr;
+    const int* degrees = nullptr;
+    const size_t* edge_offsets = nullptr; // nb_apps + 1 offsets
+    const int* edge_targets = nullptr;
+    const int* edge_values = nullptr;
+};
+
+// Same with the series of app i at [i * size_series, (i+1) * size_series)
+// of the series arrays, the peaks and sums are computed
+struct InstanceArraysTS
+{
+    size_t nb_apps = 0;
+    size_t nb_other_ids = 0;
+    const std::string* app_ids = nullptr;
+    const int* nb_replicas = nullptr;
+    const float* cpu_series = nullptr;
+    const float* mem_series = nullptr;
+    const int* degrees = nullptr;
+    const size_t* edge_offsets = nullptr;
+    const int* edge_targets = nullptr;
+    const int* edge_values = nullptr;
+};
 
 
 class Instance2D
 {
 public:
     Instance2D(std::string id, int bin_cpu_capacity, int bin_memory_capacity,
-               std::string& filename);
+               std::string& filename,
+               InstanceLoadMode load_mode = InstanceLoadMode::Sequential);
+    // Only filter the apps and set their params from an already parsed file
+    Instance2D(std::string id, int bin_cpu_capacity, int bin_memory_capacity,
+               const BinaryInstanceFile& file);
+    // Instance of a family sharing the apps and resources of the baseline,
+    // with the replicas and affinities of its file (see InstanceFamily)
+    Instance2D(std::string id, int bin_cpu_capacity, int bin_memory_capacity,
+               const BinaryInstanceFile& baseline, const BinaryInstanceFile& affinities);
+    // From arrays of the caller, which are only read by the constructor
+    Instance2D(std::string id, int bin_cpu_capacity, int bin_memory_capacity,
+               const InstanceArrays2D& arrays);
 
     virtual ~Instance2D();
 
+    // The apps keep a pointer to the affinity graph of the instance
+    Instance2D(const Instance2D& other) = delete;
+    Instance2D& operator=(const Instance2D& other) = delete;
+
+    // Update the instance in place, in time proportional to the size of the
+    // deltas except the sort keys depending on the totals of the instance
+    // which are refreshed once if the totals changed
+    // Removing an app moves the last app to its internal id
+    void applyDeltas(const std::vector<InstanceDelta>& deltas);
+
+    // Renumber the apps so that the neighbours in the affinity graph get
+    // close internal ids (see computeLocalityOrder), before the algos are
+    // created. The order of the apps changes, so do the solutions when
+    // apps are tied in the sorts of the algos.
+    void renumberApplications();
+
     const std::string& getId() const;
     const int getBinCPUCapacity() const;
     const int getBinMemCapacity() const;
     const AppList2D& getApps() const;
+    const AppTable& getAppTable() const; // Shared by the algos
+    const AffinityGraph& getAffinityGraph() const;
     //const float getLambda() const;
 
     const int getSumCPU() const;
@@ -27,10 +270,39 @@ public:
     const int getTotalReplicas() const;
 
 private:
+    // The file format (CSV or binary) is detected from the content of the file
+    void loadCSV(std::string& filename, InstanceLoadState& state);
+    void loadCSVParallel(std::string& filename, InstanceLoadMode load_mode, InstanceLoadState& state);
+    void loadBinary(const BinaryInstanceFile& file, const BinaryInstanceFile& affinities,
+                    InstanceLoadState& state);
+    void loadArrays(const InstanceArrays2D& arrays, InstanceLoadState& state);
+
+    void parseRecord(const InstanceRow& row, AppRecord2D& record) const;
+    void addRecord(AppRecord2D& record, InstanceLoadState& state);
+    void addApplication(std::string& app_id, int file_id, int nb_rep, int nb_cpus, int nb_memory,
+                        int degree, InstanceLoadState& state);
+    void finalizeApplications(InstanceLoadState& state);
+
+    void buildNodeIndex();
+    int findDeltaApplication(const std::string& app_id) const;
+    void addDeltaApplication(const InstanceDelta& delta);
+    void removeDeltaApplication(const InstanceDelta& delta);
+    void setDeltaAffinities(int app_id, const AffinityList& affinities);
+    void swapGraphNodes(int a, int b);
+    void removeUnusedNodes(std::vector<int>& nodes);
+
     std::string id;       // The instance id
     int bin_cpu_capacity; // The bin capacity for cpu requirements
     int bin_mem_capacity; // The bin capacity for memory requirements
     AppList2D app_list; // The list of Application2D of this instance
+    AppTable app_table; // Sizes and sort keys of the apps, by internal id
+    AffinityGraph affinity_graph; // Affinities of the apps, by internal id
+
+    // Only used to apply deltas, built by the first one
+    std::vector<std::string> node_names; // Unknown ids until the index is built, then all nodes
+    std::vector<std::string> filtered_names; // Filtered out apps
+    std::unordered_map<std::string, int> node_index; // Node of a string id, -1 if filtered out
+    bool node_index_built;
 
     int sum_mem;        // Total mem required by all replicas of apps
     int sum_cpu;        // Total cpu required by all replicas of apps
@@ -43,33 +315,101 @@ class InstanceTS
 {
 public:
     InstanceTS(std::string id, int bin_cpu_capacity, int bin_mem_capacity,
-               std::string& filename, size_t size_series);
+               std::string& filename, size_t size_series,
+               InstanceLoadMode load_mode = InstanceLoadMode::Sequential,
+               SeriesStorage storage = SeriesStorage::Copied,
+               SeriesPrecision precision = SeriesPrecision::Float);
+    // Only filter the apps and set their params from an already parsed file,
+    // with mapped series the file must outlive the instance
+    InstanceTS(std::string id, int bin_cpu_capacity, int bin_mem_capacity,
+               const BinaryInstanceFile& file, size_t size_series,
+               SeriesStorage storage = SeriesStorage::Copied,
+               SeriesPrecision precision = SeriesPrecision::Float);
+    // Instance of a family sharing the apps and resources of the baseline,
+    // with the replicas and affinities of its file (see InstanceFamily)
+    InstanceTS(std::string id, int bin_cpu_capacity, int bin_mem_capacity,
+               const BinaryInstanceFile& baseline, const BinaryInstanceFile& affinities,
+               size_t size_series,
+               SeriesStorage storage = SeriesStorage::Copied,
+               SeriesPrecision precision = SeriesPrecision::Float);
+    // From arrays of the caller, with mapped series the apps reference the
+    // series arrays which must outlive the instance, the other arrays are
+    // only read by the constructor
+    InstanceTS(std::string id, int bin_cpu_capacity, int bin_mem_capacity,
+               const InstanceArraysTS& arrays, size_t size_series,
+               SeriesStorage storage = SeriesStorage::Copied,
+               SeriesPrecision precision = SeriesPrecision::Float);
 
     virtual ~InstanceTS();
 
+    InstanceTS(const InstanceTS& other) = delete;
+    InstanceTS& operator=(const InstanceTS& other) = delete;
+
+    // Same as Instance2D::renumberApplications()
+    void renumberApplications();
+
     const std::string& getId() const;
     const int getBinCPUCapacity() const;
     const int getBinMemCapacity() const;
     const AppListTS& getApps() const;
+    const AffinityGraph& getAffinityGraph() const;
     const size_t getTSLength() const;
+    const SeriesPrecision getSeriesPrecision() const; // Of the apps and of the bins of the algos
 
     const int getTotalReplicas() const;
     const ResourceTS& getSumCPUTS() const;
     const ResourceTS& getSumMemTS() const;
 
 private:
+    // The file format (CSV or binary) is detected from the content of the file
+    void loadCSV(std::string& filename, InstanceLoadState& state);
+    void loadCSVParallel(std::string& filename, InstanceLoadMode load_mode, InstanceLoadState& state);
+    void loadBinary(const BinaryInstanceFile& file, const BinaryInstanceFile& affinities,
+                    InstanceLoadState& state);
+    void loadArrays(const InstanceArraysTS& arrays, InstanceLoadState& state);
+
+    void parseRecord(const InstanceRow& row, AppRecordTS& record) const;
+    void addRecord(AppRecordTS& record, InstanceLoadState& state);
+    void addApplication(ApplicationTS* app, int file_id, float sum_cpu, float sum_mem,
+                        InstanceLoadState& state);
+    void finalizeApplications(InstanceLoadState& state);
+
     std::string id;
     int bin_cpu_capacity;
     int bin_mem_capacity;
     AppListTS app_list;
+    AffinityGraph affinity_graph;
     size_t TS_size;
+    SeriesStorage storage;
+    SeriesPrecision precision;
+    std::unique_ptr<BinaryInstanceFile> mapped_file; // Binary file opened by the instance with mapped series
 
     int total_replicas;
     ResourceTS sum_cpu_TS; // Sum of all applications cpu usage
     ResourceTS sum_mem_TS; // Sum of all applications memory usage
+    float total_sum_cpu_mem;
 };
 
-ResourceTS retrieveResourceTS(std::string resource_str, float &peak, float &sum);
+// String id of a file id
+const std::string getFileIdName(const InstanceLoadState& state, int file_id);
+
+// New id of each file id: the internal id of the applications, then the
+// ids only referenced in affinity lists and last the removed applications
+// The nb_kept_ids first ids are kept in the affinity lists
+std::vector<int> computeInternalIds(const InstanceLoadState& state, size_t nb_apps, size_t& nb_kept_ids);
+
+ResourceTS retrieveResourceTS(const std::string& resource_str, float &peak, float &sum);
+
+// Single pass parser of a series "v1, v2, ..." computing its peak and sum
+// The values are written in buffer, only the first buffer_size are stored
+// Returns the number of values found in the series
+size_t parseResourceTS(std::string_view resource_str, unsigned row,
+                       float* buffer, size_t buffer_size, float &peak, float &sum);
+
+// Python representation "[v1, v2, ...]" of a series, as in the generated
+// CSV files, appended to out
+void formatResourceTS(std::string& out, const float* values, size_t size);
+void formatResourceTS(std::string& out, const double* values, size_t size);
 
 
 #endif // INSTANCE_HPP
@@ -0,0 +1,120 @@
+#include "instance_cache.hpp"
+
+#include <cerrno>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+uint64_t hashFile(const std::string& filename)
+{
+    std::ifstream f(filename, std::ios::binary);
+    if (!f.is_open())
+    {
+        throw std::runtime_error("Cannot open file " + filename);
+    }
+
+    uint64_t hash = 14695981039346656037ULL;
+    std::vector<char> block(1 << 20);
+    while (f)
+    {
+        f.read(block.data(), block.size());
+        std::streamsize count = f.gcount();
+        for (std::streamsize i = 0; i < count; ++i)
+        {
+            hash ^= (unsigned char)block[i];
+            hash *= 1099511628211ULL;
+        }
+    }
+    return hash;
+}
+
+
+InstanceCache::InstanceCache(const std::string& cache_dir):
+    cache_dir(cache_dir)
+{
+    if (!cache_dir.empty() and (mkdir(cache_dir.c_str(), 0755) != 0) and (errno != EEXIST))
+    {
+        throw std::runtime_error("Cannot create cache directory " + cache_dir);
+    }
+}
+
+const BinaryInstanceFile& InstanceCache::get2D(const std::string& filename)
+{
+    return get(filename, BinaryInstanceKind::Fixed2D);
+}
+
+const BinaryInstanceFile& InstanceCache::getTS(const std::string& filename)
+{
+    return get(filename, BinaryInstanceKind::TimeSeries);
+}
+
+void InstanceCache::clear()
+{
+    files.clear();
+}
+
+const BinaryInstanceFile& InstanceCache::get(const std::string& filename, BinaryInstanceKind kind)
+{
+    auto key = std::make_pair(filename, kind);
+    auto it = files.find(key);
+    if (it == files.end())
+    {
+        BinaryInstanceFile* file;
+        if (isBinaryInstanceFile(filename))
+        {
+            // Already in binary format, nothing to parse
+            file = new BinaryInstanceFile(filename);
+        }
+        else
+        {
+            file = parse(filename, kind);
+        }
+        it = files.emplace(key, std::unique_ptr<BinaryInstanceFile>(file)).first;
+    }
+    return *it->second;
+}
+
+BinaryInstanceFile* InstanceCache::parse(const std::string& filename, BinaryInstanceKind kind)
+{
+    std::string cache_file;
+    if (!cache_dir.empty())
+    {
+        char hash_str[17];
+        std::snprintf(hash_str, sizeof(hash_str), "%016llx", (unsigned long long)hashFile(filename));
+        cache_file = cache_dir + "/" + hash_str;
+        cache_file += (kind == BinaryInstanceKind::Fixed2D) ? ".2D.bin" : ".TS.bin";
+
+        if (isBinaryInstanceFile(cache_file))
+        {
+            try
+            {
+                return new BinaryInstanceFile(cache_file);
+            }
+            catch (const std::runtime_error&)
+            {
+                // Written by another version of the format, parse again
+            }
+        }
+    }
+
+    std::vector<char> buffer = (kind == BinaryInstanceKind::Fixed2D) ?
+        buildInstance2DBinary(filename) : buildInstanceTSBinary(filename);
+
+    if (!cache_file.empty())
+    {
+        // Concurrent runs may parse the same file, only complete files are renamed
+        std::string tmp_file = cache_file + ".tmp" + std::to_string(getpid());
+        writeBinaryInstance(buffer, tmp_file);
+        if (std::rename(tmp_file.c_str(), cache_file.c_str()) != 0)
+        {
+            std::remove(tmp_file.c_str());
+            throw std::runtime_error("Cannot write cache file " + cache_file);
+        }
+    }
+    return new BinaryInstanceFile(std::move(buffer), filename);
+}
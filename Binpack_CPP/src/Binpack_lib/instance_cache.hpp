@@ -0,0 +1,41 @@
+#ifndef INSTANCE_CACHE_HPP
+#define INSTANCE_CACHE_HPP
+
+#include "binary_instance.hpp"
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+
+
+// Cache of the capacity-independent content of instance files
+// Each CSV file is parsed once into the binary instance format, the
+// instances built from the cache for given bin capacities then only
+// filter the apps too large for the bins and set the params of the others.
+// Without cache directory the parsed files are kept in memory, else they
+// are also stored in the directory, named after the hash of the CSV file,
+// so that they are reused by later runs with other bin capacities.
+class InstanceCache
+{
+public:
+    InstanceCache(const std::string& cache_dir = "");
+
+    const BinaryInstanceFile& get2D(const std::string& filename);
+    const BinaryInstanceFile& getTS(const std::string& filename);
+
+    void clear(); // Release the files kept in memory
+
+private:
+    const BinaryInstanceFile& get(const std::string& filename, BinaryInstanceKind kind);
+    BinaryInstanceFile* parse(const std::string& filename, BinaryInstanceKind kind);
+
+    std::string cache_dir;
+    std::map<std::pair<std::string, BinaryInstanceKind>, std::unique_ptr<BinaryInstanceFile>> files;
+};
+
+// FNV-1a hash of the content of a file
+uint64_t hashFile(const std::string& filename);
+
+#endif // INSTANCE_CACHE_HPP
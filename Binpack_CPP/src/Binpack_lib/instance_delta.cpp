@@ -0,0 +1,87 @@
+#include "instance_delta.hpp"
+#include "compressed_input.hpp"
+#include "instance_loader.hpp"
+
+#define CSV_IO_NO_THREAD // Disable multithreading in csv.h
+#include "csv.h" // From https://github.com/ben-strasser/fast-cpp-csv-parser
+
+#include <cstring>
+#include <stdexcept>
+
+
+// Split the op column from the columns of the instance files
+static std::string_view splitOpColumn(std::string_view& line)
+{
+    size_t end = line.find('\t');
+    if (end == std::string_view::npos)
+    {
+        std::string_view op = line;
+        line = std::string_view();
+        return op;
+    }
+    std::string_view op = line.substr(0, end);
+    line.remove_prefix(end + 1);
+    return op;
+}
+
+std::vector<InstanceDelta> readInstanceDeltas(const std::string& filename)
+{
+    io::LineReader in(filename, openInputFile(filename));
+    char* line = in.next_line();
+    if (line == nullptr)
+    {
+        throw std::runtime_error("Missing header line in file " + filename);
+    }
+    std::string_view header_line(line);
+    if (splitOpColumn(header_line) != "op")
+    {
+        throw std::runtime_error("Missing column op in file " + filename);
+    }
+    InstanceHeader header = parseInstanceHeader(header_line, filename);
+
+    std::vector<InstanceDelta> deltas;
+    InstanceRow row;
+    while ((line = in.next_line()) != nullptr)
+    {
+        std::string_view row_line(line);
+        if (row_line.empty())
+        {
+            continue;
+        }
+        unsigned file_line = in.get_file_line();
+        std::string_view op = splitOpColumn(row_line);
+        splitInstanceRow(row_line, file_line, header, row);
+
+        InstanceDelta delta;
+        delta.app_id = row.fields[COL_APP_ID];
+        if (op == "add")
+        {
+            delta.op = InstanceDeltaOp::Add;
+            delta.nb_replicas = parseIntField(row, COL_NB_INSTANCES);
+            delta.nb_cpus = parseIntField(row, COL_CORE);
+            delta.nb_memory = parseIntField(row, COL_MEMORY);
+            delta.degree = parseIntField(row, COL_INTER_DEGREE);
+            parseAffinityList(row.fields[COL_INTER_AFF], file_line, delta.affinities);
+        }
+        else if (op == "remove")
+        {
+            delta.op = InstanceDeltaOp::Remove;
+        }
+        else if (op == "replicas")
+        {
+            delta.op = InstanceDeltaOp::SetReplicas;
+            delta.nb_replicas = parseIntField(row, COL_NB_INSTANCES);
+        }
+        else if (op == "affinities")
+        {
+            delta.op = InstanceDeltaOp::SetAffinities;
+            parseAffinityList(row.fields[COL_INTER_AFF], file_line, delta.affinities);
+        }
+        else
+        {
+            throw std::runtime_error("Unknown delta operation '" + std::string(op) + "' at row " + std::to_string(file_line));
+        }
+        deltas.push_back(std::move(delta));
+    }
+    return deltas;
+}
@@ -0,0 +1,38 @@
+#ifndef INSTANCE_DELTA_HPP
+#define INSTANCE_DELTA_HPP
+
+#include "instance.hpp"
+
+#include <string>
+#include <vector>
+
+
+enum class InstanceDeltaOp
+{
+    Add,          // New application, with all its columns
+    Remove,       // Application leaving the instance
+    SetReplicas,  // New number of replicas
+    SetAffinities // New affinity list
+};
+
+// One change of an instance, applied with Instance2D::applyDeltas
+struct InstanceDelta
+{
+    InstanceDeltaOp op;
+    std::string app_id;
+    int nb_replicas = 0;
+    int nb_cpus = 0;
+    int nb_memory = 0;
+    int degree = 0;
+    AffinityList affinities; // Pairs (app_b, k) in the order of the list
+};
+
+// Delta files are TAB-separated CSV files with the columns of the instance
+// files preceded by an "op" column: add, remove, replicas or affinities
+// Only the columns used by the operation are read, the others may be empty:
+//   add: all columns, remove: app_id, replicas: app_id and nb_instances,
+//   affinities: app_id and inter_aff
+// The deltas are applied in the order of the file
+std::vector<InstanceDelta> readInstanceDeltas(const std::string& filename);
+
+#endif // INSTANCE_DELTA_HPP
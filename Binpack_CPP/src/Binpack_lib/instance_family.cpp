@@ -0,0 +1,89 @@
+#include "instance_family.hpp"
+
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+
+// Fully parsed CSV file of the kind
+static std::vector<char> buildInstanceBinary(const std::string& filename, BinaryInstanceKind kind)
+{
+    return (kind == BinaryInstanceKind::Fixed2D) ?
+        buildInstance2DBinary(filename) : buildInstanceTSBinary(filename);
+}
+
+InstanceFamily::InstanceFamily(BinaryInstanceKind kind):
+    kind(kind),
+    resources(nullptr),
+    baseline_hashed(false),
+    baseline_resources_hash(0)
+{ }
+
+const BinaryInstanceFile& InstanceFamily::loadAffinities(const std::string& filename)
+{
+    if (baseline == nullptr)
+    {
+        if (isBinaryInstanceFile(filename))
+        {
+            baseline.reset(new BinaryInstanceFile(filename));
+        }
+        else
+        {
+            baseline.reset(new BinaryInstanceFile(buildInstanceBinary(filename, kind), filename));
+            baseline_resources_hash = hashResourceColumns(filename);
+            baseline_hashed = true;
+        }
+        if (baseline->getHeader().kind != kind)
+        {
+            throw std::runtime_error("Baseline " + filename + " of the instance family has the wrong kind");
+        }
+        affinities.reset();
+        resources = baseline.get();
+        return *baseline;
+    }
+
+    if (isBinaryInstanceFile(filename))
+    {
+        // A binary file already has all its columns
+        affinities.reset(new BinaryInstanceFile(filename));
+        if (affinities->getHeader().kind != kind)
+        {
+            throw std::runtime_error("Instance file " + filename + " of the instance family has the wrong kind");
+        }
+        resources = affinities.get();
+        return *affinities;
+    }
+
+    if (baseline_hashed)
+    {
+        uint64_t resources_hash;
+        affinities.reset(new BinaryInstanceFile(buildAffinitiesBinary(filename, *baseline, resources_hash), filename));
+        if (resources_hash == baseline_resources_hash)
+        {
+            resources = baseline.get();
+            return *affinities;
+        }
+    }
+    // The resources differ from the baseline, or cannot be compared with it
+    affinities.reset(new BinaryInstanceFile(buildInstanceBinary(filename, kind), filename));
+    resources = affinities.get();
+    return *affinities;
+}
+
+const BinaryInstanceFile& InstanceFamily::getBaseline() const
+{
+    if (baseline == nullptr)
+    {
+        throw std::runtime_error("No baseline loaded in the instance family");
+    }
+    return *baseline;
+}
+
+const BinaryInstanceFile& InstanceFamily::getResources() const
+{
+    if (resources == nullptr)
+    {
+        throw std::runtime_error("No baseline loaded in the instance family");
+    }
+    return *resources;
+}
@@ -0,0 +1,42 @@
+#ifndef INSTANCE_FAMILY_HPP
+#define INSTANCE_FAMILY_HPP
+
+#include "binary_instance.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+
+// Instance files sharing the same apps and resource columns, which only
+// differ by their replicas and affinities, as the density instances
+// generated from a baseline dataset
+// The first file loaded is fully parsed as the baseline, then only the ids,
+// replicas and affinities of the other files are parsed. The instances are
+// built from the resources and the affinities of their file, e.g. with
+// mapped series all TS instances share the series of the baseline.
+// The raw resource columns of the CSV files are hashed: a file whose
+// resources differ from the baseline, or any CSV file after a binary
+// baseline, is fully parsed and keeps its own resources.
+class InstanceFamily
+{
+public:
+    InstanceFamily(BinaryInstanceKind kind);
+
+    // Affinities of a file of the family, valid until the next call
+    const BinaryInstanceFile& loadAffinities(const std::string& filename);
+    const BinaryInstanceFile& getBaseline() const; // After the first file
+    // Resources of the last file loaded: the baseline, or the file itself
+    // when its resources differ, valid until the next call
+    const BinaryInstanceFile& getResources() const;
+
+private:
+    BinaryInstanceKind kind;
+    std::unique_ptr<BinaryInstanceFile> baseline;
+    std::unique_ptr<BinaryInstanceFile> affinities;
+    const BinaryInstanceFile* resources;
+    bool baseline_hashed;            // Whether the baseline is a CSV file
+    uint64_t baseline_resources_hash; // See hashResourceColumns
+};
+
+#endif // INSTANCE_FAMILY_HPP
@@ -0,0 +1,525 @@
+#include "instance_generator.hpp"
+#include "instance.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <map>
+#include <stdexcept>
+
+
+// Keep affinity distribution of the TClab dataset
+static const int AFFINITY_VALUES[] = {0, 2, 1, 3, 4};
+static const double AFFINITY_WEIGHTS[] = {13144, 6556, 3992, 361, 25};
+
+
+GeneratorRandom::GeneratorRandom(uint64_t seed)
+{
+    this->seed(seed);
+}
+
+void GeneratorRandom::seed(uint64_t seed)
+{
+    engine.seed(seed);
+    has_spare_normal = false;
+    spare_normal = 0.0;
+}
+
+uint64_t GeneratorRandom::below(uint64_t n)
+{
+    // Rejection of the last incomplete range to avoid modulo bias
+    uint64_t limit = std::mt19937_64::max() - (std::mt19937_64::max() % n);
+    uint64_t x = engine();
+    while (x >= limit)
+    {
+        x = engine();
+    }
+    return x % n;
+}
+
+double GeneratorRandom::uniform()
+{
+    return (engine() >> 11) * 0x1.0p-53;
+}
+
+double GeneratorRandom::normal(double mu, double sigma)
+{
+    // Box-Muller transform, the second value is kept for the next call
+    if (has_spare_normal)
+    {
+        has_spare_normal = false;
+        return mu + sigma * spare_normal;
+    }
+    double u1 = 1.0 - uniform(); // In (0, 1] for the log
+    double u2 = uniform();
+    double r = std::sqrt(-2.0 * std::log(u1));
+    double theta = 2.0 * M_PI * u2;
+    spare_normal = r * std::sin(theta);
+    has_spare_normal = true;
+    return mu + sigma * r * std::cos(theta);
+}
+
+size_t GeneratorRandom::weighted(const std::vector<double>& cumulative_weights)
+{
+    double x = uniform() * cumulative_weights.back();
+    size_t i = std::upper_bound(cumulative_weights.begin(), cumulative_weights.end(), x) - cumulative_weights.begin();
+    return std::min(i, cumulative_weights.size() - 1);
+}
+
+uint64_t deriveSeed(uint64_t seed, uint64_t stream)
+{
+    // splitmix64 finalizer
+    uint64_t z = seed + (stream + 1) * 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+
+AffinityGraphClass affinityGraphClassFromName(const std::string& name)
+{
+    if (name == "arbitrary")
+    {
+        return AffinityGraphClass::Arbitrary;
+    }
+    else if (name == "normal")
+    {
+        return AffinityGraphClass::Normal;
+    }
+    else if (name == "threshold")
+    {
+        return AffinityGraphClass::Threshold;
+    }
+    throw std::runtime_error("Unknown graph class: " + name);
+}
+
+const std::string affinityGraphClassName(AffinityGraphClass graph_class)
+{
+    switch (graph_class)
+    {
+        case AffinityGraphClass::Arbitrary:
+            return "arbitrary";
+        case AffinityGraphClass::Normal:
+            return "normal";
+        case AffinityGraphClass::Threshold:
+            return "threshold";
+    }
+    return "";
+}
+
+
+// Keep the first occurrence of each target, in the order of the list
+static void removeRepeatedTargets(std::vector<uint32_t>& list)
+{
+    std::vector<std::pair<uint32_t, uint32_t>> sorted; // (target, position)
+    sorted.reserve(list.size());
+    for (size_t pos = 0; pos < list.size(); ++pos)
+    {
+        sorted.push_back({list[pos], (uint32_t)pos});
+    }
+    std::sort(sorted.begin(), sorted.end());
+    std::vector<char> keep(list.size(), 0);
+    for (size_t k = 0; k < sorted.size(); ++k)
+    {
+        if ((k == 0) or (sorted[k].first != sorted[k-1].first))
+        {
+            keep[sorted[k].second] = 1;
+        }
+    }
+    size_t nb_kept = 0;
+    for (size_t pos = 0; pos < list.size(); ++pos)
+    {
+        if (keep[pos])
+        {
+            list[nb_kept++] = list[pos];
+        }
+    }
+    list.resize(nb_kept);
+}
+
+// int(density * n * (n-1)) distinct arcs picked uniformly, the arcs of each
+// node are in the order they were picked
+static std::vector<std::vector<uint32_t>> arbitraryArcs(size_t n, double density, GeneratorRandom& rng)
+{
+    std::vector<std::vector<uint32_t>> neighbours(n);
+    size_t target_nb_arcs = (size_t)(density * n * (n-1));
+    size_t nb_arcs = 0;
+    std::vector<size_t> old_sizes(n, 0);
+    while (nb_arcs < target_nb_arcs)
+    {
+        // Pick the missing arcs at once then drop the arcs already present,
+        // which gives the same arcs as dropping them one at a time
+        size_t nb_missing = target_nb_arcs - nb_arcs;
+        while (nb_missing > 0)
+        {
+            uint32_t i = rng.below(n);
+            uint32_t j = rng.below(n);
+            if (i == j)
+            {
+                // Avoid self-loop
+                continue;
+            }
+            neighbours[i].push_back(j);
+            nb_missing--;
+        }
+
+        nb_arcs = 0;
+        for (size_t i = 0; i < n; ++i)
+        {
+            if (neighbours[i].size() != old_sizes[i])
+            {
+                removeRepeatedTargets(neighbours[i]);
+                old_sizes[i] = neighbours[i].size();
+            }
+            nb_arcs += neighbours[i].size();
+        }
+    }
+    return neighbours;
+}
+
+static std::vector<std::vector<uint32_t>> arbitraryGraph(size_t n, double density, GeneratorRandom& rng)
+{
+    if (density <= 0.5)
+    {
+        return arbitraryArcs(n, density, rng);
+    }
+
+    // Generate graph with density (1-density) and get its complement
+    std::vector<std::vector<uint32_t>> complement = arbitraryArcs(n, 1.0 - density, rng);
+    std::vector<std::vector<uint32_t>> neighbours(n);
+    std::vector<char> present(n, 0);
+    for (size_t i = 0; i < n; ++i)
+    {
+        for (uint32_t j : complement[i])
+        {
+            present[j] = 1;
+        }
+        neighbours[i].reserve(n - 1 - complement[i].size());
+        for (size_t j = 0; j < n; ++j)
+        {
+            if ((j != i) and !present[j])
+            {
+                neighbours[i].push_back(j);
+            }
+        }
+        for (uint32_t j : complement[i])
+        {
+            present[j] = 0;
+        }
+        std::vector<uint32_t>().swap(complement[i]);
+    }
+    return neighbours;
+}
+
+// The degree of each app follows N(n*density, n*density/2) rounded as in
+// Python, its neighbours are picked uniformly without replacement
+static std::vector<std::vector<uint32_t>> normalGraph(size_t n, double density, GeneratorRandom& rng)
+{
+    std::vector<std::vector<uint32_t>> neighbours(n);
+    double mu = n * density;
+    double sigma = mu / 2.0;
+
+    std::vector<uint32_t> picked(n, 0); // Last node that picked each node, plus 1
+    std::vector<uint32_t> pool;
+    for (size_t a = 0; a < n; ++a)
+    {
+        double degree_value = std::nearbyint(rng.normal(mu, sigma)); // Ties to even
+        size_t degree = 0;
+        if (degree_value > 0)
+        {
+            degree = std::min((double)(n - 1), degree_value);
+        }
+
+        std::vector<uint32_t>& list = neighbours[a];
+        list.reserve(degree);
+        if (2 * degree <= n - 1)
+        {
+            // Few neighbours: reject the nodes already picked
+            picked[a] = a + 1; // Avoid self-loop
+            while (list.size() < degree)
+            {
+                uint32_t b = rng.below(n);
+                if (picked[b] != a + 1)
+                {
+                    picked[b] = a + 1;
+                    list.push_back(b);
+                }
+            }
+        }
+        else
+        {
+            // Partial Fisher-Yates shuffle of the other nodes
+            pool.clear();
+            for (size_t b = 0; b < n; ++b)
+            {
+                if (b != a)
+                {
+                    pool.push_back(b);
+                }
+            }
+            for (size_t k = 0; k < degree; ++k)
+            {
+                std::swap(pool[k], pool[k + rng.below(pool.size() - k)]);
+                list.push_back(pool[k]);
+            }
+        }
+    }
+    return neighbours;
+}
+
+// Arc u->v when (v_out[u] + v_in[v]) / 2 <= real_d, with real_d corrected
+// for the expected density, the neighbours are sorted by id
+static std::vector<std::vector<uint32_t>> thresholdGraph(size_t n, double density, GeneratorRandom& rng)
+{
+    std::vector<double> v_in(n);
+    std::vector<double> v_out(n);
+    for (double& v : v_in)
+    {
+        v = rng.uniform();
+    }
+    for (double& v : v_out)
+    {
+        v = rng.uniform();
+    }
+
+    // Correct parameter d for expected density
+    double real_d;
+    if (density <= 0.5)
+    {
+        real_d = (1.0 + std::sqrt(1 + 8.0 * n * (n-1) * density)) / (4.0 * n);
+    }
+    else
+    {
+        real_d = 1.0 + (1 - std::sqrt(1 + 8.0 * n * (n-1) * (1 - density))) / (4.0 * n);
+    }
+
+    // The targets of u are a prefix of the nodes sorted by v_in
+    std::vector<uint32_t> by_v_in(n);
+    for (size_t v = 0; v < n; ++v)
+    {
+        by_v_in[v] = v;
+    }
+    std::stable_sort(by_v_in.begin(), by_v_in.end(), [&v_in](uint32_t a, uint32_t b) {
+        return v_in[a] < v_in[b];
+    });
+
+    std::vector<std::vector<uint32_t>> neighbours(n);
+    for (size_t u = 0; u < n; ++u)
+    {
+        auto last = std::partition_point(by_v_in.begin(), by_v_in.end(), [&](uint32_t v) {
+            return ((v_out[u] + v_in[v]) / 2.0) <= real_d;
+        });
+        std::vector<uint32_t>& list = neighbours[u];
+        list.reserve(last - by_v_in.begin());
+        for (auto it = by_v_in.begin(); it != last; ++it)
+        {
+            if (*it != u)
+            {
+                list.push_back(*it);
+            }
+        }
+        std::sort(list.begin(), list.end());
+    }
+    return neighbours;
+}
+
+
+InstanceGenerator::InstanceGenerator(const std::string& baseline_filename, BinaryInstanceKind kind, uint64_t seed):
+    kind(kind),
+    rng(seed)
+{
+    if (isBinaryInstanceFile(baseline_filename))
+    {
+        baseline = std::make_unique<BinaryInstanceFile>(baseline_filename);
+    }
+    else
+    {
+        std::vector<char> buffer = (kind == BinaryInstanceKind::Fixed2D) ?
+            buildInstance2DBinary(baseline_filename) :
+            buildInstanceTSBinary(baseline_filename);
+        baseline = std::make_unique<BinaryInstanceFile>(std::move(buffer), baseline_filename);
+    }
+    if (baseline->getHeader().kind != kind)
+    {
+        throw std::runtime_error("Wrong kind of instance in baseline file " + baseline_filename);
+    }
+    if (baseline->getNbApps() == 0)
+    {
+        throw std::runtime_error("No application in baseline file " + baseline_filename);
+    }
+
+    // Keep replica distribution of the baseline
+    std::map<int, size_t> replica_counts;
+    const int32_t* nb_replicas = baseline->getNbReplicas();
+    for (size_t i = 0; i < baseline->getNbApps(); ++i)
+    {
+        replica_counts[nb_replicas[i]]++;
+    }
+    double total = 0.0;
+    for (const auto& count : replica_counts)
+    {
+        total += count.second;
+        replica_values.push_back(count.first);
+        replica_weights.push_back(total);
+    }
+
+    total = 0.0;
+    for (double weight : AFFINITY_WEIGHTS)
+    {
+        total += weight;
+        affinity_weights.push_back(total);
+    }
+}
+
+void InstanceGenerator::seed(uint64_t seed)
+{
+    rng.seed(seed);
+}
+
+const size_t InstanceGenerator::getBaselineSize() const
+{
+    return baseline->getNbApps();
+}
+
+void InstanceGenerator::appendApp(BinaryInstanceColumns& cols, size_t row, int nb_replicas) const
+{
+    cols.addApp(std::to_string(cols.nb_replicas.size() + 1));
+    cols.nb_replicas.push_back(nb_replicas);
+    cols.degrees.push_back(0);
+    if (kind == BinaryInstanceKind::Fixed2D)
+    {
+        cols.cpu_sizes.push_back(baseline->getCPUSizes()[row]);
+        cols.mem_sizes.push_back(baseline->getMemSizes()[row]);
+    }
+    else
+    {
+        size_t TS_size = baseline->getTSLength();
+        const float* cpu = baseline->getCPUSeries() + row * TS_size;
+        const float* mem = baseline->getMemSeries() + row * TS_size;
+        cols.cpu_series.insert(cols.cpu_series.end(), cpu, cpu + TS_size);
+        cols.mem_series.insert(cols.mem_series.end(), mem, mem + TS_size);
+        cols.peak_cpu.push_back(baseline->getPeakCPU()[row]);
+        cols.peak_mem.push_back(baseline->getPeakMem()[row]);
+        cols.sum_cpu.push_back(baseline->getSumCPU()[row]);
+        cols.sum_mem.push_back(baseline->getSumMem()[row]);
+    }
+    cols.edge_offsets.push_back(cols.edge_values.size());
+}
+
+BinaryInstanceColumns InstanceGenerator::sampleApps(size_t nb_apps)
+{
+    std::vector<size_t> rows(nb_apps);
+    for (size_t& row : rows)
+    {
+        row = rng.below(baseline->getNbApps());
+    }
+
+    BinaryInstanceColumns cols;
+    for (size_t row : rows)
+    {
+        appendApp(cols, row, replica_values[rng.weighted(replica_weights)]);
+    }
+    return cols;
+}
+
+BinaryInstanceColumns InstanceGenerator::baselineApps()
+{
+    BinaryInstanceColumns cols;
+    for (size_t row = 0; row < baseline->getNbApps(); ++row)
+    {
+        appendApp(cols, row, baseline->getNbReplicas()[row]);
+    }
+    return cols;
+}
+
+void InstanceGenerator::addAffinities(BinaryInstanceColumns& cols, AffinityGraphClass graph_class, double density)
+{
+    size_t n = cols.nb_replicas.size();
+    switch (graph_class)
+    {
+        case AffinityGraphClass::Arbitrary:
+            setAffinities(cols, arbitraryGraph(n, density, rng));
+            break;
+        case AffinityGraphClass::Normal:
+            setAffinities(cols, normalGraph(n, density, rng));
+            break;
+        case AffinityGraphClass::Threshold:
+            setAffinities(cols, thresholdGraph(n, density, rng));
+            break;
+    }
+}
+
+void InstanceGenerator::setAffinities(BinaryInstanceColumns& cols, const std::vector<std::vector<uint32_t>>& neighbours)
+{
+    size_t nb_edges = 0;
+    for (const std::vector<uint32_t>& list : neighbours)
+    {
+        nb_edges += list.size();
+    }
+
+    // The apps are the first ids of the table, so app i is the target i
+    cols.edge_offsets.assign(1, 0);
+    cols.edge_targets.clear();
+    cols.edge_target_ids.clear();
+    cols.edge_values.clear();
+    cols.edge_targets.reserve(nb_edges);
+    cols.edge_values.reserve(nb_edges);
+    for (size_t i = 0; i < neighbours.size(); ++i)
+    {
+        cols.degrees[i] = neighbours[i].size();
+        for (uint32_t j : neighbours[i])
+        {
+            cols.edge_targets.push_back(j);
+            cols.edge_values.push_back(AFFINITY_VALUES[rng.weighted(affinity_weights)]);
+        }
+        cols.edge_offsets.push_back(cols.edge_values.size());
+    }
+}
+
+std::vector<char> InstanceGenerator::build(BinaryInstanceColumns& cols) const
+{
+    return buildBinaryInstance(cols, kind, (kind == BinaryInstanceKind::Fixed2D) ? 0 : baseline->getTSLength());
+}
+
+
+void InstanceGenerator::writeCSV(const BinaryInstanceColumns& cols, const std::string& filename) const
+{
+    std::ofstream f(filename, std::ios_base::trunc);
+    if (!f.is_open())
+    {
+        throw std::runtime_error("Cannot write file " + filename);
+    }
+    f << "app_id\tnb_instances\tcore\tmemory\tinter_degree\tinter_aff\n";
+
+    size_t TS_size = baseline->getTSLength();
+    std::string line;
+    for (size_t i = 0; i < cols.nb_replicas.size(); ++i)
+    {
+        line = cols.ids[i] + '\t' + std::to_string(cols.nb_replicas[i]) + '\t';
+        if (kind == BinaryInstanceKind::Fixed2D)
+        {
+            line += std::to_string(cols.cpu_sizes[i]) + '\t' + std::to_string(cols.mem_sizes[i]);
+        }
+        else
+        {
+            formatResourceTS(line, cols.cpu_series.data() + i * TS_size, TS_size);
+            line += '\t';
+            formatResourceTS(line, cols.mem_series.data() + i * TS_size, TS_size);
+        }
+        line += '\t' + std::to_string(cols.degrees[i]) + "\t[";
+        for (uint64_t e = cols.edge_offsets[i]; e < cols.edge_offsets[i+1]; ++e)
+        {
+            if (e > cols.edge_offsets[i])
+            {
+                line += ", ";
+            }
+            line += '(' + cols.ids[cols.edge_targets[e]] + ", " + std::to_string(cols.edge_values[e]) + ')';
+        }
+        line += "]\n";
+        f << line;
+    }
+    if (!f)
+    {
+        throw std::runtime_error("Cannot write file " + filename);
+    }
+}
@@ -0,0 +1,91 @@
+#ifndef INSTANCE_GENERATOR_HPP
+#define INSTANCE_GENERATOR_HPP
+
+#include "binary_instance.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+
+// Seeded random source of the generator, the distributions are computed
+// here so that an instance only depends on the seed and not on the
+// implementation of the standard library
+class GeneratorRandom
+{
+public:
+    GeneratorRandom(uint64_t seed);
+
+    void seed(uint64_t seed);
+    uint64_t below(uint64_t n); // Uniform in [0, n)
+    double uniform();           // Uniform in [0, 1)
+    double normal(double mu, double sigma);
+    // Index i picked with weight cumulative_weights[i] - cumulative_weights[i-1]
+    size_t weighted(const std::vector<double>& cumulative_weights);
+
+private:
+    std::mt19937_64 engine;
+    bool has_spare_normal;
+    double spare_normal;
+};
+
+// Independent seed for each stream (instance) of a base seed
+uint64_t deriveSeed(uint64_t seed, uint64_t stream);
+
+
+// Graph classes of the generated affinities, as in data/generation_scripts/graph_utils.py
+enum class AffinityGraphClass
+{
+    Arbitrary, // Uniformly picked arcs
+    Normal,    // Out degree of each app following a normal distribution
+    Threshold  // Arc u->v when (v_out[u] + v_in[v]) / 2 is under a threshold
+};
+
+AffinityGraphClass affinityGraphClassFromName(const std::string& name);
+const std::string affinityGraphClassName(AffinityGraphClass graph_class);
+
+
+// Generator of the higher density and large scale instances from a TClab
+// baseline dataset (CSV or binary file), the C++ version of the scripts
+// generate_higher_density.py and generate_large_scale.py
+// The generated apps are named 1..n and the same seed always gives the
+// same instances, which are either written as CSV files or built in
+// memory in the binary format to load Instance2D/InstanceTS objects
+class InstanceGenerator
+{
+public:
+    InstanceGenerator(const std::string& baseline_filename, BinaryInstanceKind kind, uint64_t seed);
+
+    void seed(uint64_t seed);
+    const size_t getBaselineSize() const;
+
+    // Large scale: nb_apps rows picked uniformly in the baseline, with
+    // a number of replicas following the distribution of the baseline
+    BinaryInstanceColumns sampleApps(size_t nb_apps);
+    // Higher density: all rows of the baseline with their replicas
+    BinaryInstanceColumns baselineApps();
+
+    // Add affinities of the given graph class and density to apps without affinities
+    void addAffinities(BinaryInstanceColumns& cols, AffinityGraphClass graph_class, double density);
+
+    // Binary instance in memory, to be wrapped in a BinaryInstanceFile
+    std::vector<char> build(BinaryInstanceColumns& cols) const;
+    // TAB-separated CSV file in the format of the Python scripts
+    void writeCSV(const BinaryInstanceColumns& cols, const std::string& filename) const;
+
+private:
+    void appendApp(BinaryInstanceColumns& cols, size_t row, int nb_replicas) const;
+    void setAffinities(BinaryInstanceColumns& cols, const std::vector<std::vector<uint32_t>>& neighbours);
+
+    BinaryInstanceKind kind;
+    std::unique_ptr<BinaryInstanceFile> baseline;
+    GeneratorRandom rng;
+
+    std::vector<int> replica_values; // Distribution of the replicas in the baseline
+    std::vector<double> replica_weights; // Cumulative
+    std::vector<double> affinity_weights; // Cumulative, for the values 0..4
+};
+
+#endif // INSTANCE_GENERATOR_HPP
@@ -0,0 +1,307 @@
+#include "instance_loader.hpp"
+#include "compressed_input.hpp"
+
+#define CSV_IO_NO_THREAD // Disable multithreading in csv.h
+#include "csv.h" // From https://github.com/ben-strasser/fast-cpp-csv-parser
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+
+static const char* const INSTANCE_COLUMN_NAMES[NB_INSTANCE_COLUMNS] = {
+    "app_id", "nb_instances", "core", "memory", "inter_degree", "inter_aff"
+};
+
+// Same trimming as trim_chars<'[', ']'> of csv.h
+static std::string_view trimField(std::string_view field)
+{
+    size_t begin = 0;
+    size_t end = field.size();
+    while ((begin < end) and ((field[begin] == '[') or (field[begin] == ']')))
+    {
+        begin++;
+    }
+    while ((end > begin) and ((field[end-1] == '[') or (field[end-1] == ']')))
+    {
+        end--;
+    }
+    return field.substr(begin, end - begin);
+}
+
+InstanceHeader parseInstanceHeader(std::string_view line, const std::string& filename)
+{
+    InstanceHeader header;
+    bool found[NB_INSTANCE_COLUMNS] = {false};
+    size_t begin = 0;
+    while (begin <= line.size())
+    {
+        size_t end = line.find('\t', begin);
+        if (end == std::string_view::npos)
+        {
+            end = line.size();
+        }
+        int column = -1;
+        std::string_view name = trimField(line.substr(begin, end - begin));
+        for (int c = 0; c < NB_INSTANCE_COLUMNS; ++c)
+        {
+            if (name == INSTANCE_COLUMN_NAMES[c])
+            {
+                if (found[c])
+                {
+                    throw std::runtime_error("Duplicated column " + std::string(name) + " in file " + filename);
+                }
+                found[c] = true;
+                column = c;
+            }
+        }
+        header.column_at.push_back(column);
+        begin = end + 1;
+    }
+
+    for (int c = 0; c < NB_INSTANCE_COLUMNS; ++c)
+    {
+        if (!found[c])
+        {
+            throw std::runtime_error("Missing column " + std::string(INSTANCE_COLUMN_NAMES[c]) + " in file " + filename);
+        }
+    }
+    return header;
+}
+
+void splitInstanceRow(std::string_view line, unsigned file_line,
+                      const InstanceHeader& header, InstanceRow& row)
+{
+    row.file_line = file_line;
+
+    const size_t nb_columns = header.column_at.size();
+    size_t position = 0;
+    size_t begin = 0;
+    while (begin <= line.size())
+    {
+        size_t end = line.find('\t', begin);
+        if (end == std::string_view::npos)
+        {
+            end = line.size();
+        }
+        if (position == nb_columns)
+        {
+            throw std::runtime_error("Too many columns at row " + std::to_string(file_line));
+        }
+        int column = header.column_at[position];
+        if (column >= 0)
+        {
+            row.fields[column] = trimField(line.substr(begin, end - begin));
+        }
+        position++;
+        begin = end + 1;
+    }
+    if (position != nb_columns)
+    {
+        throw std::runtime_error("Too few columns at row " + std::to_string(file_line));
+    }
+}
+
+int parseIntField(const InstanceRow& row, InstanceColumn column)
+{
+    std::string_view field = row.fields[column];
+    int val;
+    auto res = std::from_chars(field.data(), field.data() + field.size(), val);
+    if ((res.ec != std::errc()) or (res.ptr != field.data() + field.size()))
+    {
+        std::string s = "Invalid integer '" + std::string(field) + "' in column ";
+        s += std::string(INSTANCE_COLUMN_NAMES[column]) + " at row " + std::to_string(row.file_line);
+        throw std::runtime_error(s);
+    }
+    return val;
+}
+
+// Set by setLoaderThreads, 0 for one thread per core
+static unsigned loader_threads = 0;
+
+void setLoaderThreads(unsigned nb_threads)
+{
+    loader_threads = nb_threads;
+}
+
+unsigned getLoaderThreads()
+{
+    if (loader_threads > 0)
+    {
+        return loader_threads;
+    }
+    unsigned nb_threads = std::thread::hardware_concurrency();
+    return (nb_threads > 0) ? nb_threads : 1;
+}
+
+
+/* ================================================ */
+/* ================================================ */
+/* ================================================ */
+InstanceFileReader::InstanceFileReader(const std::string& filename):
+    in(new io::LineReader(filename, openInputFile(filename))),
+    nb_batches(0)
+{
+    char* line = in->next_line();
+    if (line == nullptr)
+    {
+        throw std::runtime_error("Missing header line in file " + filename);
+    }
+    header = parseInstanceHeader(line, filename);
+}
+
+InstanceFileReader::~InstanceFileReader()
+{ }
+
+const InstanceHeader& InstanceFileReader::getHeader() const
+{
+    return header;
+}
+
+bool InstanceFileReader::readBatch(RowBatch& batch, size_t max_rows)
+{
+    batch.text.clear();
+    batch.ends.clear();
+    batch.first_line = in->get_file_line() + 1;
+
+    char* line;
+    while ((batch.ends.size() < max_rows) and ((line = in->next_line()) != nullptr))
+    {
+        batch.text.append(line, std::strlen(line));
+        batch.ends.push_back(batch.text.size());
+    }
+    if (batch.ends.empty())
+    {
+        return false;
+    }
+    batch.index = nb_batches++;
+    return true;
+}
+
+
+/* ================================================ */
+/* ================================================ */
+/* ================================================ */
+InstanceFileContent readInstanceFile(const std::string& filename, size_t nb_chunks)
+{
+    InstanceFileContent content;
+    if (detectCompression(filename) == InputCompression::None)
+    {
+        std::ifstream f(filename, std::ios::binary | std::ios::ate);
+        if (!f.is_open())
+        {
+            throw std::runtime_error("Cannot open file " + filename);
+        }
+        content.text.resize(f.tellg());
+        f.seekg(0);
+        f.read(&content.text[0], content.text.size());
+    }
+    else
+    {
+        // Size unknown before decompressing
+        std::unique_ptr<io::ByteSourceBase> source = openInputFile(filename);
+        const int block_size = 1 << 20;
+        int count;
+        do
+        {
+            size_t size = content.text.size();
+            content.text.resize(size + block_size);
+            count = source->read(&content.text[size], block_size);
+            content.text.resize(size + count);
+        } while (count == block_size);
+    }
+
+    const size_t size = content.text.size();
+    size_t header_end = content.text.find('\n');
+    if (size == 0)
+    {
+        throw std::runtime_error("Missing header line in file " + filename);
+    }
+    if (header_end == std::string::npos)
+    {
+        header_end = size;
+    }
+    std::string_view header_line(content.text.data(), header_end);
+    if (!header_line.empty() and (header_line.back() == '\r'))
+    {
+        header_line.remove_suffix(1);
+    }
+    content.header = parseInstanceHeader(header_line, filename);
+
+    // Chunks of similar size, each one ending after a line break
+    const size_t data_begin = std::min(header_end + 1, size);
+    const size_t chunk_size = (size - data_begin) / std::max<size_t>(nb_chunks, 1) + 1;
+    content.chunk_bounds.push_back(data_begin);
+    while (content.chunk_bounds.back() < size)
+    {
+        size_t end = content.chunk_bounds.back() + chunk_size;
+        if (end >= size)
+        {
+            end = size;
+        }
+        else
+        {
+            end = content.text.find('\n', end - 1);
+            end = (end == std::string::npos) ? size : end + 1;
+        }
+        content.chunk_bounds.push_back(end);
+    }
+    if (content.chunk_bounds.size() == 1)
+    {
+        // No rows, one empty chunk
+        content.chunk_bounds.push_back(size);
+    }
+    return content;
+}
+
+std::vector<std::string_view> splitLines(const std::string& text, size_t begin, size_t end)
+{
+    std::vector<std::string_view> lines;
+    while (begin < end)
+    {
+        const char* line_break = static_cast<const char*>(std::memchr(text.data() + begin, '\n', end - begin));
+        size_t line_end = (line_break != nullptr) ? line_break - text.data() : end;
+        std::string_view line(text.data() + begin, line_end - begin);
+
+        // Handle windows \r\n line breaks
+        if (!line.empty() and (line.back() == '\r'))
+        {
+            line.remove_suffix(1);
+        }
+        lines.push_back(line);
+        begin = line_end + 1;
+    }
+    return lines;
+}
+
+void runChunks(size_t nb_chunks, const std::function<void(size_t)>& work)
+{
+    std::vector<std::exception_ptr> errors(nb_chunks);
+    std::vector<std::thread> threads;
+    for (size_t c = 0; c < nb_chunks; ++c)
+    {
+        threads.emplace_back([&work, &errors, c]() {
+            try
+            {
+                work(c);
+            }
+            catch (...)
+            {
+                errors[c] = std::current_exception();
+            }
+        });
+    }
+    for (std::thread& t : threads)
+    {
+        t.join();
+    }
+    for (std::exception_ptr& e : errors)
+    {
+        if (e)
+        {
+            std::rethrow_exception(e);
+        }
+    }
+}
@@ -0,0 +1,366 @@
+#ifndef INSTANCE_LOADER_HPP
+#define INSTANCE_LOADER_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace io { class LineReader; } // From csv.h
+
+
+// Columns read from the instance files, in the order of InstanceRow::fields
+enum InstanceColumn
+{
+    COL_APP_ID = 0,
+    COL_NB_INSTANCES,
+    COL_CORE,
+    COL_MEMORY,
+    COL_INTER_DEGREE,
+    COL_INTER_AFF,
+    NB_INSTANCE_COLUMNS
+};
+
+// Position of each column in the file, found from the header line
+struct InstanceHeader
+{
+    // Column read at each position of the file, -1 for the extra ones
+    std::vector<int> column_at;
+};
+
+// Fields of one row, as views on the line with '[' and ']' trimmed
+struct InstanceRow
+{
+    unsigned file_line;
+    std::string_view fields[NB_INSTANCE_COLUMNS];
+};
+
+InstanceHeader parseInstanceHeader(std::string_view line, const std::string& filename);
+void splitInstanceRow(std::string_view line, unsigned file_line,
+                      const InstanceHeader& header, InstanceRow& row);
+int parseIntField(const InstanceRow& row, InstanceColumn column);
+
+// Number of parser threads used by the parallel loaders
+unsigned getLoaderThreads();
+
+
+// Consecutive raw rows of a file, concatenated in text
+struct RowBatch
+{
+    size_t index;              // Position of the batch in the file
+    unsigned first_line;       // File line of the first row
+    std::string text;
+    std::vector<size_t> ends;  // End of each row in text
+};
+
+// Reads the header then batches of raw rows of a TAB-separated instance file
+class InstanceFileReader
+{
+public:
+    InstanceFileReader(const std::string& filename);
+    ~InstanceFileReader();
+
+    const InstanceHeader& getHeader() const;
+
+    // Returns false at the end of the file
+    bool readBatch(RowBatch& batch, size_t max_rows);
+
+private:
+    std::unique_ptr<io::LineReader> in;
+    InstanceHeader header;
+    size_t nb_batches;
+};
+
+
+// Blocking FIFO queue of bounded size
+// close() wakes up all waiting threads: push() then fails and pop()
+// fails once the queue is empty
+template<typename T>
+class BoundedQueue
+{
+public:
+    BoundedQueue(size_t max_size):
+        max_size(max_size),
+        closed(false)
+    { }
+
+    bool push(T&& item)
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        not_full.wait(lock, [this]() { return closed or (items.size() < max_size); });
+        if (closed)
+        {
+            return false;
+        }
+        items.push_back(std::move(item));
+        not_empty.notify_one();
+        return true;
+    }
+
+    bool pop(T& item)
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        not_empty.wait(lock, [this]() { return closed or !items.empty(); });
+        if (items.empty())
+        {
+            return false;
+        }
+        item = std::move(items.front());
+        items.pop_front();
+        not_full.notify_one();
+        return true;
+    }
+
+    void close()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        closed = true;
+        not_full.notify_all();
+        not_empty.notify_all();
+    }
+
+private:
+    size_t max_size;
+    bool closed;
+    std::deque<T> items;
+    std::mutex mutex;
+    std::condition_variable not_full;
+    std::condition_variable not_empty;
+};
+
+// First exception raised by one of the threads of a loader
+class LoaderError
+{
+public:
+    void set(std::exception_ptr e)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!error)
+        {
+            error = e;
+        }
+    }
+
+    void rethrow()
+    {
+        if (error)
+        {
+            std::rethrow_exception(error);
+        }
+    }
+
+private:
+    std::exception_ptr error;
+    std::mutex mutex;
+};
+
+
+constexpr size_t LOADER_BATCH_ROWS = 256;
+
+// Pipelined reading of a CSV instance file:
+//   - a reader thread pushes batches of raw rows in a bounded queue
+//   - nb_workers threads call parse_row(row, record) on each row
+//   - the calling thread calls assemble(record) in the order of the file
+// The first exception raised by any stage is rethrown once all threads stopped
+template<typename Record, typename ParseRow, typename Assemble>
+void loadRowsPipelined(const std::string& filename, unsigned nb_workers,
+                       ParseRow parse_row, Assemble assemble)
+{
+    struct ParsedBatch
+    {
+        size_t index;
+        std::vector<Record> records;
+        std::exception_ptr error;
+    };
+
+    InstanceFileReader reader(filename);
+    const InstanceHeader& header = reader.getHeader();
+    BoundedQueue<RowBatch> raw_queue(2 * nb_workers);
+    BoundedQueue<ParsedBatch> parsed_queue(2 * nb_workers);
+    LoaderError error;
+
+    std::thread reader_thread([&]() {
+        try
+        {
+            RowBatch batch;
+            while (reader.readBatch(batch, LOADER_BATCH_ROWS))
+            {
+                if (!raw_queue.push(std::move(batch)))
+                {
+                    break;
+                }
+                batch = RowBatch();
+            }
+        }
+        catch (...)
+        {
+            error.set(std::current_exception());
+            parsed_queue.close();
+        }
+        raw_queue.close();
+    });
+
+    std::atomic<unsigned> nb_running(nb_workers);
+    std::vector<std::thread> workers;
+    for (unsigned w = 0; w < nb_workers; ++w)
+    {
+        workers.emplace_back([&]() {
+            try
+            {
+                RowBatch batch;
+                InstanceRow row;
+                while (raw_queue.pop(batch))
+                {
+                    ParsedBatch parsed;
+                    parsed.index = batch.index;
+                    try
+                    {
+                        parsed.records.resize(batch.ends.size());
+                        size_t begin = 0;
+                        for (size_t i = 0; i < batch.ends.size(); ++i)
+                        {
+                            std::string_view line(batch.text.data() + begin, batch.ends[i] - begin);
+                            splitInstanceRow(line, batch.first_line + i, header, row);
+                            parse_row(row, parsed.records[i]);
+                            begin = batch.ends[i];
+                        }
+                    }
+                    catch (...)
+                    {
+                        // Raised when the batch is assembled, so that the
+                        // error of the first malformed row is reported
+                        parsed.error = std::current_exception();
+                    }
+                    if (!parsed_queue.push(std::move(parsed)))
+                    {
+                        break;
+                    }
+                }
+            }
+            catch (...)
+            {
+                error.set(std::current_exception());
+                raw_queue.close();
+                parsed_queue.close();
+            }
+            if (--nb_running == 0)
+            {
+                parsed_queue.close();
+            }
+        });
+    }
+
+    // Assembly stage, batches may arrive out of order
+    try
+    {
+        std::map<size_t, ParsedBatch> pending;
+        size_t next_index = 0;
+        ParsedBatch parsed;
+        while (parsed_queue.pop(parsed))
+        {
+            pending.emplace(parsed.index, std::move(parsed));
+            auto it = pending.begin();
+            while ((it != pending.end()) and (it->first == next_index))
+            {
+                if (it->second.error)
+                {
+                    std::rethrow_exception(it->second.error);
+                }
+                for (Record& record : it->second.records)
+                {
+                    assemble(record);
+                }
+                it = pending.erase(it);
+                next_index++;
+            }
+        }
+    }
+    catch (...)
+    {
+        error.set(std::current_exception());
+        raw_queue.close();
+        parsed_queue.close();
+    }
+
+    reader_thread.join();
+    for (std::thread& worker : workers)
+    {
+        worker.join();
+    }
+    error.rethrow();
+}
+
+
+// Rows of a whole CSV instance file loaded in memory
+struct InstanceFileContent
+{
+    std::string text;
+    InstanceHeader header;
+    std::vector<size_t> chunk_bounds; // Chunks of rows, split at line boundaries
+};
+
+// Read the file and split its rows in at most nb_chunks chunks of similar size
+InstanceFileContent readInstanceFile(const std::string& filename, size_t nb_chunks);
+
+// Rows of text between begin and end, without the line breaks
+std::vector<std::string_view> splitLines(const std::string& text, size_t begin, size_t end);
+
+// Call work(c) for each chunk c in its own thread
+// If some chunks fail, the error of the first one in the file is rethrown
+void runChunks(size_t nb_chunks, const std::function<void(size_t)>& work);
+
+// Chunked reading of a CSV instance file:
+//   - the file is read at once and split in one chunk per thread
+//   - each thread calls parse_row(row, record) on the rows of its chunk
+//   - the calling thread calls assemble(record) in the order of the file
+template<typename Record, typename ParseRow, typename Assemble>
+void loadRowsChunked(const std::string& filename, unsigned nb_threads,
+                     ParseRow parse_row, Assemble assemble)
+{
+    InstanceFileContent content = readInstanceFile(filename, nb_threads);
+    const size_t nb_chunks = content.chunk_bounds.size() - 1;
+
+    std::vector<std::vector<std::string_view>> lines(nb_chunks);
+    runChunks(nb_chunks, [&](size_t c) {
+        lines[c] = splitLines(content.text, content.chunk_bounds[c], content.chunk_bounds[c+1]);
+    });
+
+    // The header is the first line of the file
+    std::vector<unsigned> first_line(nb_chunks, 2);
+    for (size_t c = 1; c < nb_chunks; ++c)
+    {
+        first_line[c] = first_line[c-1] + lines[c-1].size();
+    }
+
+    std::vector<std::vector<Record>> records(nb_chunks);
+    runChunks(nb_chunks, [&](size_t c) {
+        InstanceRow row;
+        records[c].resize(lines[c].size());
+        for (size_t i = 0; i < lines[c].size(); ++i)
+        {
+            splitInstanceRow(lines[c][i], first_line[c] + i, content.header, row);
+            parse_row(row, records[c][i]);
+        }
+    });
+
+    // Merge the chunks in the order of the file
+    for (std::vector<Record>& chunk : records)
+    {
+        for (Record& record : chunk)
+        {
+            assemble(record);
+        }
+        std::vector<Record>().swap(chunk);
+    }
+}
+
+#endif // INSTANCE_LOADER_HPP
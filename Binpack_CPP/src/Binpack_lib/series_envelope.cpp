@@ -0,0 +1,142 @@
+#include "series_envelope.hpp"
+
+#include <algorithm>
+
+
+SeriesEnvelope::SeriesEnvelope():
+    nb_values(0),
+    with_max(false)
+{ }
+
+SeriesEnvelope::SeriesEnvelope(const float* values, size_t size, bool with_max):
+    nb_values(size),
+    with_max(with_max)
+{
+    level_offsets.push_back(0);
+    size_t nb_windows = size;
+    do
+    {
+        nb_windows = (nb_windows + WINDOW - 1) / WINDOW;
+        level_offsets.push_back(level_offsets.back() + nb_windows);
+    } while (nb_windows > 1);
+
+    mins.resize(level_offsets.back());
+    if (with_max)
+    {
+        maxs.resize(level_offsets.back());
+    }
+    update(values);
+}
+
+void SeriesEnvelope::update(const float* values)
+{
+    if (nb_values == 0)
+    {
+        return;
+    }
+
+    // Level 0 from the values, then each level from the previous one
+    const float* prev_mins = values;
+    const float* prev_maxs = values;
+    size_t prev_size = nb_values;
+    for (size_t l = 0; l + 1 < level_offsets.size(); ++l)
+    {
+        float* level_mins = mins.data() + level_offsets[l];
+        float* level_maxs = with_max ? maxs.data() + level_offsets[l] : nullptr;
+        for (size_t w = 0; w < level_offsets[l+1] - level_offsets[l]; ++w)
+        {
+            size_t first = w * WINDOW;
+            size_t last = std::min(first + WINDOW, prev_size);
+            level_mins[w] = *std::min_element(prev_mins + first, prev_mins + last);
+            if (with_max)
+            {
+                level_maxs[w] = *std::max_element(prev_maxs + first, prev_maxs + last);
+            }
+        }
+        prev_mins = level_mins;
+        prev_maxs = level_maxs;
+        prev_size = level_offsets[l+1] - level_offsets[l];
+    }
+}
+
+void SeriesEnvelope::subtract(float value)
+{
+    for (float& min : mins)
+    {
+        min -= value;
+    }
+    for (float& max : maxs)
+    {
+        max -= value;
+    }
+}
+
+const size_t SeriesEnvelope::getNbLevels() const
+{
+    return level_offsets.empty() ? 0 : level_offsets.size() - 1;
+}
+
+const float SeriesEnvelope::getMin() const
+{
+    return mins.back();
+}
+
+bool SeriesEnvelope::windowFits(size_t level, size_t window, const float* item,
+                                const SeriesEnvelope& residual_envelope, const float* residual) const
+{
+    size_t w = level_offsets[level] + window;
+    if (maxs[w] <= residual_envelope.mins[w])
+    {
+        return true;
+    }
+    if (level == 0)
+    {
+        size_t last = std::min((window + 1) * WINDOW, nb_values);
+        for (size_t t = window * WINDOW; t < last; ++t)
+        {
+            if (item[t] > residual[t])
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+    size_t last = std::min((window + 1) * WINDOW, level_offsets[level] - level_offsets[level-1]);
+    for (size_t child = window * WINDOW; child < last; ++child)
+    {
+        if (!windowFits(level - 1, child, item, residual_envelope, residual))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool seriesMayFit(const SeriesEnvelope& item_envelope, const SeriesEnvelope& residual_envelope)
+{
+    // The residual is below the whole item somewhere in a window, coarse levels first
+    const std::vector<float>& item_mins = item_envelope.mins;
+    const std::vector<float>& residual_mins = residual_envelope.mins;
+    for (size_t l = item_envelope.getNbLevels(); l-- > 0; )
+    {
+        for (size_t w = item_envelope.level_offsets[l]; w < item_envelope.level_offsets[l+1]; ++w)
+        {
+            if (item_mins[w] > residual_mins[w])
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+bool seriesFits(const SeriesEnvelope& item_envelope, const float* item,
+                const SeriesEnvelope& residual_envelope, const float* residual)
+{
+    if (item_envelope.nb_values == 0)
+    {
+        return true;
+    }
+    size_t top = item_envelope.getNbLevels() - 1;
+    return item_envelope.windowFits(top, 0, item, residual_envelope, residual);
+}
@@ -0,0 +1,54 @@
+#ifndef SERIES_ENVELOPE_HPP
+#define SERIES_ENVELOPE_HPP
+
+#include <cstddef>
+#include <vector>
+
+
+// Minimum, and optionally maximum, of a time series over windows of
+// increasing sizes: the windows of level 0 cover WINDOW time steps, each
+// window of level l+1 covers WINDOW windows of level l, and the last level
+// has a single window
+class SeriesEnvelope
+{
+public:
+    static const size_t WINDOW = 8;
+
+    SeriesEnvelope();
+    SeriesEnvelope(const float* values, size_t size, bool with_max);
+
+    // Compute the windows again after a change of the values
+    void update(const float* values);
+    // Same as update after values[t] -= value at each time step, the float
+    // rounding is monotonic so the windows keep the same min and max
+    void subtract(float value);
+
+    const size_t getNbLevels() const;
+    const float getMin() const; // Min of the whole series
+
+private:
+    friend bool seriesMayFit(const SeriesEnvelope& item_envelope, const SeriesEnvelope& residual_envelope);
+    friend bool seriesFits(const SeriesEnvelope& item_envelope, const float* item,
+                           const SeriesEnvelope& residual_envelope, const float* residual);
+
+    bool windowFits(size_t level, size_t window, const float* item,
+                    const SeriesEnvelope& residual_envelope, const float* residual) const;
+
+    size_t nb_values;
+    bool with_max;
+    std::vector<size_t> level_offsets; // Windows of level l: [level_offsets[l], level_offsets[l+1])
+    std::vector<float> mins;
+    std::vector<float> maxs;
+};
+
+// False if the min of the item is above the min of the residual in a
+// window, then item[t] > residual[t] at some time step of the window
+bool seriesMayFit(const SeriesEnvelope& item_envelope, const SeriesEnvelope& residual_envelope);
+
+// True if item[t] <= residual[t] at each time step, where the item envelope
+// has the maximums: the windows where the max of the item is at most the
+// min of the residual fit without comparing their time steps
+bool seriesFits(const SeriesEnvelope& item_envelope, const float* item,
+                const SeriesEnvelope& residual_envelope, const float* residual);
+
+#endif // SERIES_ENVELOPE_HPP
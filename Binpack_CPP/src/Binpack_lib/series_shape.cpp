@@ -0,0 +1,55 @@
+#include "series_shape.hpp"
+
+
+SeriesShape::SeriesShape():
+    kind(SeriesShapeKind::General)
+{ }
+
+SeriesShape::SeriesShape(const float* series, size_t size):
+    kind(SeriesShapeKind::General)
+{
+    if (size == 0)
+    {
+        return;
+    }
+
+    // Stop as soon as there are too many runs
+    const size_t max_runs = (size + MIN_RUN_LENGTH - 1) / MIN_RUN_LENGTH;
+    for (size_t t = 1; t < size; ++t)
+    {
+        if (series[t] != series[t-1])
+        {
+            if (run_ends.size() + 1 >= max_runs)
+            {
+                run_ends.clear();
+                run_values.clear();
+                return;
+            }
+            run_ends.push_back(t);
+            run_values.push_back(series[t-1]);
+        }
+    }
+    run_ends.push_back(size);
+    run_values.push_back(series[size-1]);
+    kind = (run_ends.size() == 1) ? SeriesShapeKind::Constant : SeriesShapeKind::PiecewiseConstant;
+}
+
+const SeriesShapeKind SeriesShape::getKind() const
+{
+    return kind;
+}
+
+const size_t SeriesShape::getNbRuns() const
+{
+    return run_ends.size();
+}
+
+const size_t SeriesShape::getRunEnd(size_t run) const
+{
+    return run_ends[run];
+}
+
+const float SeriesShape::getRunValue(size_t run) const
+{
+    return run_values[run];
+}
@@ -0,0 +1,39 @@
+#ifndef SERIES_SHAPE_HPP
+#define SERIES_SHAPE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+
+// Class of a time series, detected when the apps are loaded
+enum class SeriesShapeKind
+{
+    Constant,          // A single value
+    PiecewiseConstant, // At most 1 run of equal values per MIN_RUN_LENGTH time steps
+    General
+};
+
+// Runs of equal values of a series, for the kernels specialized by shape:
+// run r has the value getRunValue(r) on [getRunEnd(r-1), getRunEnd(r))
+// Only the constant and piecewise-constant series keep their runs
+class SeriesShape
+{
+public:
+    static const size_t MIN_RUN_LENGTH = 4;
+
+    SeriesShape();
+    SeriesShape(const float* series, size_t size);
+
+    const SeriesShapeKind getKind() const;
+    const size_t getNbRuns() const;
+    const size_t getRunEnd(size_t run) const;
+    const float getRunValue(size_t run) const;
+
+private:
+    SeriesShapeKind kind;
+    std::vector<uint32_t> run_ends;
+    std::vector<float> run_values;
+};
+
+#endif // SERIES_SHAPE_HPP
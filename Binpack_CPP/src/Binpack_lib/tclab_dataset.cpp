@@ -0,0 +1,365 @@
+#include "tclab_dataset.hpp"
+#include "binary_instance.hpp"
+#include "compressed_input.hpp"
+#include "instance.hpp"
+
+#define CSV_IO_NO_THREAD // Disable multithreading in csv.h
+#include "csv.h" // From https://github.com/ben-strasser/fast-cpp-csv-parser
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <fstream>
+#include <stdexcept>
+
+
+static std::string rowPosition(const std::string& filename, unsigned row)
+{
+    return " at row " + std::to_string(row) + " of file " + filename;
+}
+
+// Comma-separated fields of a line, at least nb_fields
+static void splitFields(std::string_view line, size_t nb_fields, std::vector<std::string_view>& fields,
+                        const std::string& filename, unsigned row)
+{
+    fields.clear();
+    size_t start = 0;
+    while (true)
+    {
+        size_t end = line.find(',', start);
+        if (end == std::string_view::npos)
+        {
+            fields.push_back(line.substr(start));
+            break;
+        }
+        fields.push_back(line.substr(start, end - start));
+        start = end + 1;
+    }
+    if (fields.size() < nb_fields)
+    {
+        throw std::runtime_error("Missing columns" + rowPosition(filename, row));
+    }
+}
+
+static int parseInt(std::string_view field, const std::string& filename, unsigned row)
+{
+    int value;
+    auto res = std::from_chars(field.data(), field.data() + field.size(), value);
+    if ((res.ec != std::errc()) or (res.ptr != field.data() + field.size()))
+    {
+        throw std::runtime_error("Malformed integer '" + std::string(field) + "'" + rowPosition(filename, row));
+    }
+    return value;
+}
+
+// Number N of an id "app_N"
+static int parseAppId(std::string_view field, const std::string& filename, unsigned row)
+{
+    size_t sep = field.find('_');
+    if (sep == std::string_view::npos)
+    {
+        throw std::runtime_error("Malformed app id '" + std::string(field) + "'" + rowPosition(filename, row));
+    }
+    return parseInt(field.substr(sep + 1), filename, row);
+}
+
+// Series "v1|v2|..." appended to values, returns its peak
+static double parseSeries(std::string_view field, std::vector<double>& values,
+                          const std::string& filename, unsigned row)
+{
+    const char* p = field.data();
+    const char* end = p + field.size();
+    double peak = 0.0;
+    bool first = true;
+    while (true)
+    {
+        double value;
+        auto res = std::from_chars(p, end, value);
+        if ((res.ec != std::errc()) or ((res.ptr != end) and (*res.ptr != '|')))
+        {
+            throw std::runtime_error("Malformed resource series '" + std::string(field) + "'" + rowPosition(filename, row));
+        }
+        values.push_back(value);
+        if (first or (value > peak))
+        {
+            peak = value;
+        }
+        first = false;
+        if (res.ptr == end)
+        {
+            break;
+        }
+        p = res.ptr + 1;
+    }
+    return peak;
+}
+
+
+TClabDataset::TClabDataset(const std::string& resources_filename,
+                           const std::string& deployment_filename,
+                           const std::string& interference_filename)
+{
+    readResources(resources_filename);
+    readDeployment(deployment_filename);
+    readInterference(interference_filename);
+}
+
+void TClabDataset::readResources(const std::string& filename)
+{
+    io::LineReader in(filename, openInputFile(filename));
+    std::vector<std::string_view> fields;
+    cpu_offsets.assign(1, 0);
+    mem_offsets.assign(1, 0);
+    char* line;
+    while ((line = in.next_line()) != nullptr)
+    {
+        std::string_view line_view(line);
+        if (line_view.empty())
+        {
+            continue;
+        }
+        unsigned row = in.get_file_line();
+        splitFields(line_view, 3, fields, filename, row);
+
+        int app_id = parseAppId(fields[0], filename, row);
+        if (!app_index.insert({app_id, app_ids.size()}).second)
+        {
+            throw std::runtime_error("Duplicate app id " + std::string(fields[0]) + rowPosition(filename, row));
+        }
+        app_ids.push_back(app_id);
+
+        // For the 2D fixed resource requirement
+        core.push_back((int)std::ceil(parseSeries(fields[1], cpu_usage, filename, row)));
+        memory.push_back((int)std::ceil(parseSeries(fields[2], mem_usage, filename, row)));
+        cpu_offsets.push_back(cpu_usage.size());
+        mem_offsets.push_back(mem_usage.size());
+    }
+}
+
+void TClabDataset::readDeployment(const std::string& filename)
+{
+    // One line per replica, the apps without replicas keep 0
+    io::LineReader in(filename, openInputFile(filename));
+    std::vector<std::string_view> fields;
+    nb_replicas.assign(app_ids.size(), 0);
+    char* line;
+    while ((line = in.next_line()) != nullptr)
+    {
+        std::string_view line_view(line);
+        if (line_view.empty())
+        {
+            continue;
+        }
+        unsigned row = in.get_file_line();
+        splitFields(line_view, 2, fields, filename, row);
+        auto it = app_index.find(parseAppId(fields[1], filename, row));
+        if (it != app_index.end())
+        {
+            nb_replicas[it->second]++;
+        }
+    }
+}
+
+void TClabDataset::readInterference(const std::string& filename)
+{
+    // Pairs of the apps in the dataset, grouped by app_a in the order of the file
+    io::LineReader in(filename, openInputFile(filename));
+    std::vector<std::string_view> fields;
+    std::vector<size_t> sources;
+    std::vector<int> targets;
+    std::vector<int> values;
+    char* line;
+    while ((line = in.next_line()) != nullptr)
+    {
+        std::string_view line_view(line);
+        if (line_view.empty())
+        {
+            continue;
+        }
+        unsigned row = in.get_file_line();
+        splitFields(line_view, 3, fields, filename, row);
+        int app_a = parseAppId(fields[0], filename, row);
+        int app_b = parseAppId(fields[1], filename, row);
+        int k = parseInt(fields[2], filename, row);
+        auto it = app_index.find(app_a);
+        if ((app_a == app_b) or (it == app_index.end()))
+        {
+            // Avoid self-loop
+            continue;
+        }
+        sources.push_back(it->second);
+        targets.push_back(app_b);
+        values.push_back(k);
+    }
+
+    // Stable counting sort by source
+    aff_offsets.assign(app_ids.size() + 1, 0);
+    for (size_t source : sources)
+    {
+        aff_offsets[source + 1]++;
+    }
+    for (size_t i = 0; i < app_ids.size(); ++i)
+    {
+        aff_offsets[i+1] += aff_offsets[i];
+    }
+    std::vector<size_t> next(aff_offsets.begin(), aff_offsets.end() - 1);
+    aff_targets.resize(targets.size());
+    aff_values.resize(values.size());
+    for (size_t e = 0; e < sources.size(); ++e)
+    {
+        size_t pos = next[sources[e]]++;
+        aff_targets[pos] = targets[e];
+        aff_values[pos] = values[e];
+    }
+}
+
+const size_t TClabDataset::getNbApps() const
+{
+    return app_ids.size();
+}
+
+const size_t TClabDataset::getTSLength() const
+{
+    size_t TS_size = app_ids.empty() ? 0 : cpu_offsets[1];
+    for (size_t i = 0; i < app_ids.size(); ++i)
+    {
+        size_t cpu_size = cpu_offsets[i+1] - cpu_offsets[i];
+        size_t mem_size = mem_offsets[i+1] - mem_offsets[i];
+        if ((cpu_size != TS_size) or (mem_size != TS_size))
+        {
+            std::string s = "Wrong size of resource usage for application " + std::to_string(app_ids[i]) + ": found sizes ";
+            s += std::to_string(cpu_size) + " and " + std::to_string(mem_size) + ", expected " + std::to_string(TS_size);
+            throw std::runtime_error(s);
+        }
+    }
+    return TS_size;
+}
+
+
+void TClabDataset::appendAffinities(std::string& line, size_t app) const
+{
+    line += std::to_string(aff_offsets[app+1] - aff_offsets[app]) + "\t[";
+    for (size_t e = aff_offsets[app]; e < aff_offsets[app+1]; ++e)
+    {
+        if (e > aff_offsets[app])
+        {
+            line += ", ";
+        }
+        line += '(' + std::to_string(aff_targets[e]) + ", " + std::to_string(aff_values[e]) + ')';
+    }
+    line += "]\n";
+}
+
+void TClabDataset::writeCSV2D(const std::string& filename) const
+{
+    std::ofstream f(filename, std::ios_base::trunc);
+    if (!f.is_open())
+    {
+        throw std::runtime_error("Cannot write file " + filename);
+    }
+    f << "app_id\tnb_instances\tcore\tmemory\tinter_degree\tinter_aff\n";
+    std::string line;
+    for (size_t i = 0; i < app_ids.size(); ++i)
+    {
+        line = std::to_string(app_ids[i]) + '\t' + std::to_string(nb_replicas[i]) + '\t';
+        line += std::to_string(core[i]) + '\t' + std::to_string(memory[i]) + '\t';
+        appendAffinities(line, i);
+        f << line;
+    }
+    if (!f)
+    {
+        throw std::runtime_error("Cannot write file " + filename);
+    }
+}
+
+void TClabDataset::writeCSVTS(const std::string& filename) const
+{
+    std::ofstream f(filename, std::ios_base::trunc);
+    if (!f.is_open())
+    {
+        throw std::runtime_error("Cannot write file " + filename);
+    }
+    f << "app_id\tnb_instances\tcore\tmemory\tinter_degree\tinter_aff\n";
+    std::string line;
+    for (size_t i = 0; i < app_ids.size(); ++i)
+    {
+        line = std::to_string(app_ids[i]) + '\t' + std::to_string(nb_replicas[i]) + '\t';
+        formatResourceTS(line, cpu_usage.data() + cpu_offsets[i], cpu_offsets[i+1] - cpu_offsets[i]);
+        line += '\t';
+        formatResourceTS(line, mem_usage.data() + mem_offsets[i], mem_offsets[i+1] - mem_offsets[i]);
+        line += '\t';
+        appendAffinities(line, i);
+        f << line;
+    }
+    if (!f)
+    {
+        throw std::runtime_error("Cannot write file " + filename);
+    }
+}
+
+
+// Series in single precision with its peak and sum, as parseResourceTS
+static void appendSeriesColumns(const double* values, size_t size, std::vector<float>& series,
+                                std::vector<float>& peaks, std::vector<float>& sums)
+{
+    float peak = 0.0;
+    float sum = 0.0;
+    for (size_t t = 0; t < size; ++t)
+    {
+        float val = values[t];
+        series.push_back(val);
+        if (val > peak)
+        {
+            peak = val;
+        }
+        sum += val;
+    }
+    peaks.push_back(peak);
+    sums.push_back(sum);
+}
+
+static void addEdgeColumns(BinaryInstanceColumns& cols, const std::vector<size_t>& aff_offsets,
+                           const std::vector<int>& aff_targets, const std::vector<int>& aff_values)
+{
+    // Once all apps are in the id table, the other targets are appended after them
+    for (size_t i = 0; i + 1 < aff_offsets.size(); ++i)
+    {
+        for (size_t e = aff_offsets[i]; e < aff_offsets[i+1]; ++e)
+        {
+            cols.edge_targets.push_back(cols.internId(std::to_string(aff_targets[e])));
+            cols.edge_values.push_back(aff_values[e]);
+        }
+        cols.edge_offsets.push_back(cols.edge_values.size());
+    }
+}
+
+std::vector<char> TClabDataset::build2D() const
+{
+    BinaryInstanceColumns cols;
+    for (size_t i = 0; i < app_ids.size(); ++i)
+    {
+        cols.addApp(std::to_string(app_ids[i]));
+        cols.nb_replicas.push_back(nb_replicas[i]);
+        cols.degrees.push_back(aff_offsets[i+1] - aff_offsets[i]);
+        cols.cpu_sizes.push_back(core[i]);
+        cols.mem_sizes.push_back(memory[i]);
+    }
+    addEdgeColumns(cols, aff_offsets, aff_targets, aff_values);
+    return buildBinaryInstance(cols, BinaryInstanceKind::Fixed2D, 0);
+}
+
+std::vector<char> TClabDataset::buildTS() const
+{
+    size_t TS_size = getTSLength();
+    BinaryInstanceColumns cols;
+    for (size_t i = 0; i < app_ids.size(); ++i)
+    {
+        cols.addApp(std::to_string(app_ids[i]));
+        cols.nb_replicas.push_back(nb_replicas[i]);
+        cols.degrees.push_back(aff_offsets[i+1] - aff_offsets[i]);
+        appendSeriesColumns(cpu_usage.data() + cpu_offsets[i], TS_size, cols.cpu_series, cols.peak_cpu, cols.sum_cpu);
+        appendSeriesColumns(mem_usage.data() + mem_offsets[i], TS_size, cols.mem_series, cols.peak_mem, cols.sum_mem);
+    }
+    addEdgeColumns(cols, aff_offsets, aff_targets, aff_values);
+    return buildBinaryInstance(cols, BinaryInstanceKind::TimeSeries, TS_size);
+}
@@ -0,0 +1,64 @@
+#ifndef TCLAB_DATASET_HPP
+#define TCLAB_DATASET_HPP
+
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+
+// Dataset of the applications joined from the raw TClab tables, the C++
+// version of data/generation_scripts/generate_TClab_dataset.py
+// The tables are comma-separated files without header, with ids "app_N":
+//   - app_resources.csv: app_id, cpu usage "v1|v2|...", memory usage "v1|v2|..."
+//   - instance_deployment.csv: inst_id, app_id, machine_id (one line per replica)
+//   - app_interference.csv: app_a, app_b, k (app_a tolerates k replicas of app_b)
+// Each table is streamed once and joined on the app ids with hash indexes.
+// The apps are the lines of app_resources.csv, named N, in the same order.
+class TClabDataset
+{
+public:
+    TClabDataset(const std::string& resources_filename,
+                 const std::string& deployment_filename,
+                 const std::string& interference_filename);
+
+    const size_t getNbApps() const;
+
+    // TAB-separated datasets in the format of TClab_dataset_2D.csv and
+    // TClab_dataset_TS.csv, the 2D requirements are the peaks rounded up
+    void writeCSV2D(const std::string& filename) const;
+    void writeCSVTS(const std::string& filename) const;
+
+    // Same datasets in the binary instance format
+    std::vector<char> build2D() const;
+    std::vector<char> buildTS() const;
+
+private:
+    void readResources(const std::string& filename);
+    void readDeployment(const std::string& filename);
+    void readInterference(const std::string& filename);
+
+    void appendAffinities(std::string& line, size_t app) const;
+    const size_t getTSLength() const; // Size of all series, else exception
+
+    std::vector<int> app_ids;
+    std::unordered_map<int, size_t> app_index; // App id to position
+
+    // Series of app i: [offsets[i], offsets[i+1]) in cpu_usage and mem_usage
+    std::vector<size_t> cpu_offsets;
+    std::vector<size_t> mem_offsets;
+    std::vector<double> cpu_usage;
+    std::vector<double> mem_usage;
+    std::vector<int> core;
+    std::vector<int> memory;
+
+    std::vector<int> nb_replicas;
+
+    // Affinities (app_b, k) of app i in [aff_offsets[i], aff_offsets[i+1])
+    // in the order of app_interference.csv, without self-loops
+    std::vector<size_t> aff_offsets;
+    std::vector<int> aff_targets;
+    std::vector<int> aff_values;
+};
+
+#endif // TCLAB_DATASET_HPP
@@ -1,6 +1,7 @@
 #include "algos2D.hpp"
 
 #include <algorithm> // For stable_sort
+#include <numeric> // For iota
 #include <iostream>
 #include <unordered_map>
 #include <cmath> // For exp
@@ -160,22 +161,18 @@ AlgoFit2D::AlgoFit2D(const Instance2D &instance):
     norm_sum_mem(sum_mem/bin_mem_capacity),
     next_bin_index(0),
     curr_bin_index(0),
+    app_list(instance.getApps()),
+    app_table(instance.getAppTable()),
+    app_measures(instance.getApps().size()),
+    apps(instance.getApps().size()),
     solved(false)
 {
-    apps = AppList2D(instance.getApps());
+    std::iota(apps.begin(), apps.end(), 0);
     bins = BinList2D(0);
 }
 
 AlgoFit2D::~AlgoFit2D()
-{
-    for (Bin2D* bin : bins)
-    {
-        if (bin != nullptr)
-        {
-            delete bin;
-        }
-    }
-}
+{ } // The bins are freed with bin_arena
 
 bool AlgoFit2D::isSolved() const
 {
@@ -203,9 +200,14 @@ BinList2D AlgoFit2D::getBinsCopy() const
     return new_bins;
 }
 
+std::vector<int> AlgoFit2D::getReplicaBins() const
+{
+    return computeReplicaBins(bins, app_list);
+}
+
 const AppList2D& AlgoFit2D::getApps() const
 {
-    return apps;
+    return app_list;
 }
 
 const int AlgoFit2D::getBinCPUCapacity() const
@@ -223,35 +225,42 @@ const std::string& AlgoFit2D::getInstanceName() const
     return instance_name;
 }
 
-void AlgoFit2D::setSolution(BinList2D& bins)
+void AlgoFit2D::setSolution(const BinList2D& bins)
 {
     clearSolution();
-    this->bins = bins;
+    // The bins are copied in bin_arena, the id of a copy is its position
+    // as for the bins created by the algo
+    for (const Bin2D* bin : bins)
+    {
+        Bin2D* copy = bin_arena.get(bin_arena.createCopy(*bin));
+        copy->setId(next_bin_index);
+        this->bins.push_back(copy);
+        next_bin_index += 1;
+    }
     solved = true;
 }
 
 void AlgoFit2D::clearSolution()
 {
     solved = false;
-    for (Bin2D* bin : bins)
-    {
-        if (bin != nullptr)
-        {
-            delete bin;
-        }
-    }
+    bin_arena.reset(); // The bins are kept for the next solution
     bins.clear();
     next_bin_index = 0;
 }
 
+Bin2D* AlgoFit2D::newBin(int id)
+{
+    return bin_arena.get(bin_arena.create(id, bin_cpu_capacity, bin_mem_capacity));
+}
+
 void AlgoFit2D::createNewBin()
 {
-    bins.push_back(new Bin2D(next_bin_index, bin_cpu_capacity, bin_mem_capacity));
+    bins.push_back(newBin(next_bin_index));
     next_bin_index += 1;
 }
 
 // Generic algorithm based on first fit
-void AlgoFit2D::allocateBatch(AppList2D::iterator first_app, AppList2D::iterator end_batch)
+void AlgoFit2D::allocateBatch(AppIndexList::iterator first_app, AppIndexList::iterator end_batch)
 {
     Bin2D* curr_bin = nullptr;
     bool allocated = false;
@@ -260,16 +269,17 @@ void AlgoFit2D::allocateBatch(AppList2D::iterator first_app, AppList2D::iterator
     auto curr_app_it = first_app;
     while(curr_app_it != end_batch)
     {
-        Application2D * app = *curr_app_it;
+        Application2D * app = app_list[*curr_app_it];
         curr_bin_index = 0;
 
-        for (int j = 0; j < app->getNbReplicas(); ++j)
+        for (int j = 0; j < app_table.getNbReplicas(*curr_app_it); ++j)
         {
             sortBins();
 
             allocated = false;
             while (!allocated)
             {
+                curr_bin_index = findCandidateBin(app, curr_bin_index);
                 if (curr_bin_index >= next_bin_index)
                 {
                     // Create a new bin
@@ -287,7 +297,7 @@ void AlgoFit2D::allocateBatch(AppList2D::iterator first_app, AppList2D::iterator
                 if (checkItemToBin(app, curr_bin))
                 {
                     // This depends whether to update conflicts/affinities of the bin
-                    addItemToBin(app, j, curr_bin);
+                    addItemToBin(app, curr_bin);
                     allocated = true;
                 }
                 else
@@ -300,6 +310,10 @@ void AlgoFit2D::allocateBatch(AppList2D::iterator first_app, AppList2D::iterator
     }
 }
 
+int AlgoFit2D::findCandidateBin(Application2D* app, int first_bin) const
+{
+    return first_bin;
+}
 
 // Solve the whole instance at once
 // The hint is an estimate on the number of bins to allocate
@@ -335,8 +349,8 @@ int AlgoFit2D::solvePerBatch(int batch_size, int hint_nb_bins)
     }
 
     int remaining_apps = apps.size();
-    AppList2D::iterator curr_app_it;
-    AppList2D::iterator stop_it = apps.begin();
+    AppIndexList::iterator curr_app_it;
+    AppIndexList::iterator stop_it = apps.begin();
     while(remaining_apps > batch_size)
     {
         curr_app_it = stop_it;
@@ -363,18 +377,46 @@ Algo2DFF::Algo2DFF(const Instance2D &instance):
     AlgoFit2D(instance)
 { }
 
-void Algo2DFF::sortApps(AppList2D::iterator first_app, AppList2D::iterator end_it) { }
+void Algo2DFF::sortApps(AppIndexList::iterator first_app, AppIndexList::iterator end_it) { }
 void Algo2DFF::sortBins() { }
 
+void Algo2DFF::setSolution(const BinList2D& bins)
+{
+    AlgoFit2D::setSolution(bins); // Clears bin_pool
+    for (Bin2D* bin : this->bins)
+    {
+        bin_pool.addBin(bin->getAvailableCPUCap(), bin->getAvailableMemCap());
+    }
+}
+
+void Algo2DFF::clearSolution()
+{
+    AlgoFit2D::clearSolution();
+    bin_pool.clear();
+}
+
+void Algo2DFF::createNewBin()
+{
+    AlgoFit2D::createNewBin();
+    bin_pool.addBin(bin_cpu_capacity, bin_mem_capacity);
+}
+
+int Algo2DFF::findCandidateBin(Application2D* app, int first_bin) const
+{
+    return bin_pool.findFirstFit(first_bin, app->getCPUSize(), app->getMemorySize());
+}
+
 bool Algo2DFF::checkItemToBin(Application2D* app, Bin2D* bin) const
 {
     return (bin->doesItemFit(app->getCPUSize(), app->getMemorySize())) and (bin->isAffinityCompliant(app));
 }
 
-void Algo2DFF::addItemToBin(Application2D* app, int replica_id, Bin2D* bin)
+void Algo2DFF::addItemToBin(Application2D* app, Bin2D* bin)
 {
     bin->addNewConflict(app);
-    bin->addItem(app, replica_id);
+    bin->addItem(app);
+    // The id of the bin is its position in bins and bin_pool
+    bin_pool.setAvailable(bin->getId(), bin->getAvailableCPUCap(), bin->getAvailableMemCap());
 }
 
 /************ First Fit Decreasing Degree Affinity *********/
@@ -382,9 +424,9 @@ Algo2DFFDDegree::Algo2DFFDDegree(const Instance2D &instance):
     Algo2DFF(instance)
 { }
 
-void Algo2DFFDDegree::sortApps(AppList2D::iterator first_app, AppList2D::iterator end_it)
+void Algo2DFFDDegree::sortApps(AppIndexList::iterator first_app, AppIndexList::iterator end_it)
 {
-    stable_sort(first_app, end_it, application2D_comparator_total_degree_decreasing);
+    app_table.sortDecreasing(first_app, end_it, AppSortKey::TotalDegree);
 }
 
 
@@ -394,9 +436,9 @@ Algo2DFFDAvg::Algo2DFFDAvg(const Instance2D &instance):
     Algo2DFF(instance)
 { }
 
-void Algo2DFFDAvg::sortApps(AppList2D::iterator first_app, AppList2D::iterator end_it)
+void Algo2DFFDAvg::sortApps(AppIndexList::iterator first_app, AppIndexList::iterator end_it)
 {
-    stable_sort(first_app, end_it, application2D_comparator_avg_size_decreasing);
+    app_table.sortDecreasing(first_app, end_it, AppSortKey::AvgSize);
 }
 
 
@@ -405,9 +447,9 @@ Algo2DFFDAvgExpo::Algo2DFFDAvgExpo(const Instance2D &instance):
     Algo2DFF(instance)
 { }
 
-void Algo2DFFDAvgExpo::sortApps(AppList2D::iterator first_app, AppList2D::iterator end_it)
+void Algo2DFFDAvgExpo::sortApps(AppIndexList::iterator first_app, AppIndexList::iterator end_it)
 {
-    stable_sort(first_app, end_it, application2D_comparator_avgexpo_size_decreasing);
+    app_table.sortDecreasing(first_app, end_it, AppSortKey::AvgExpo);
 }
 
 
@@ -416,9 +458,9 @@ Algo2DFFDMax::Algo2DFFDMax(const Instance2D &instance):
     Algo2DFF(instance)
 { }
 
-void Algo2DFFDMax::sortApps(AppList2D::iterator first_app, AppList2D::iterator end_it)
+void Algo2DFFDMax::sortApps(AppIndexList::iterator first_app, AppIndexList::iterator end_it)
 {
-    stable_sort(first_app, end_it, application2D_comparator_max_size_decreasing);
+    app_table.sortDecreasing(first_app, end_it, AppSortKey::MaxSize);
 }
 
 
@@ -427,9 +469,9 @@ Algo2DFFDSurrogate::Algo2DFFDSurrogate(const Instance2D &instance):
     Algo2DFF(instance)
 { }
 
-void Algo2DFFDSurrogate::sortApps(AppList2D::iterator first_app, AppList2D::iterator end_it)
+void Algo2DFFDSurrogate::sortApps(AppIndexList::iterator first_app, AppIndexList::iterator end_it)
 {
-    stable_sort(first_app, end_it, application2D_comparator_surrogate_size_decreasing);
+    app_table.sortDecreasing(first_app, end_it, AppSortKey::Surrogate);
 }
 
 
@@ -438,9 +480,9 @@ Algo2DFFDExtendedSum::Algo2DFFDExtendedSum(const Instance2D &instance):
     Algo2DFF(instance)
 { }
 
-void Algo2DFFDExtendedSum::sortApps(AppList2D::iterator first_app, AppList2D::iterator end_it)
+void Algo2DFFDExtendedSum::sortApps(AppIndexList::iterator first_app, AppIndexList::iterator end_it)
 {
-    stable_sort(first_app, end_it, application2D_comparator_extsum_size_decreasing);
+    app_table.sortDecreasing(first_app, end_it, AppSortKey::ExtSum);
 }
 
 
@@ -454,9 +496,9 @@ Algo2DBFDAvg::Algo2DBFDAvg(const Instance2D &instance):
     AlgoFit2D(instance)
 { }
 
-void Algo2DBFDAvg::sortApps(AppList2D::iterator first_app, AppList2D::iterator end_it)
+void Algo2DBFDAvg::sortApps(AppIndexList::iterator first_app, AppIndexList::iterator end_it)
 {
-    stable_sort(first_app, end_it, application2D_comparator_avg_size_decreasing);
+    app_table.sortDecreasing(first_app, end_it, AppSortKey::AvgSize);
 }
 
 void Algo2DBFDAvg::sortBins() {
@@ -471,10 +513,10 @@ bool Algo2DBFDAvg::checkItemToBin(Application2D* app, Bin2D* bin) const
     return (bin->doesItemFit(app->getCPUSize(), app->getMemorySize())) and (bin->isAffinityCompliant(app));
 }
 
-void Algo2DBFDAvg::addItemToBin(Application2D* app, int replica_id, Bin2D* bin)
+void Algo2DBFDAvg::addItemToBin(Application2D* app, Bin2D* bin)
 {
     bin->addNewConflict(app);
-    bin->addItem(app, replica_id);
+    bin->addItem(app);
 
     updateBinMeasure(bin);
 }
@@ -492,9 +534,9 @@ Algo2DBFDMax::Algo2DBFDMax(const Instance2D &instance):
     Algo2DBFDAvg(instance)
 { }
 
-void Algo2DBFDMax::sortApps(AppList2D::iterator first_app, AppList2D::iterator end_it)
+void Algo2DBFDMax::sortApps(AppIndexList::iterator first_app, AppIndexList::iterator end_it)
 {
-    stable_sort(first_app, end_it, application2D_comparator_max_size_decreasing);
+    app_table.sortDecreasing(first_app, end_it, AppSortKey::MaxSize);
 }
 
 void Algo2DBFDMax::updateBinMeasure(Bin2D *bin)
@@ -512,9 +554,9 @@ Algo2DBFDAvgExpo::Algo2DBFDAvgExpo(const Instance2D &instance):
     total_residual_mem(0)
 { }
 
-void Algo2DBFDAvgExpo::sortApps(AppList2D::iterator first_app, AppList2D::iterator end_it)
+void Algo2DBFDAvgExpo::sortApps(AppIndexList::iterator first_app, AppIndexList::iterator end_it)
 {
-    stable_sort(first_app, end_it, application2D_comparator_avgexpo_size_decreasing);
+    app_table.sortDecreasing(first_app, end_it, AppSortKey::AvgExpo);
 }
 
 void Algo2DBFDAvgExpo::sortBins() {
@@ -526,17 +568,17 @@ void Algo2DBFDAvgExpo::sortBins() {
 void Algo2DBFDAvgExpo::createNewBin()
 {
     //std::cout << "Opening a new bin of index " << next_bin_id << std::endl; //TODO remove
-    bins.push_back(new Bin2D(next_bin_index, bin_cpu_capacity, bin_mem_capacity));
+    bins.push_back(newBin(next_bin_index));
     next_bin_index += 1;
 
     total_residual_cpu += bin_cpu_capacity;
     total_residual_mem += bin_mem_capacity;
 }
 
-void Algo2DBFDAvgExpo::addItemToBin(Application2D *app, int replica_id, Bin2D *bin)
+void Algo2DBFDAvgExpo::addItemToBin(Application2D *app, Bin2D *bin)
 {
     bin->addNewConflict(app);
-    bin->addItem(app, replica_id);
+    bin->addItem(app);
 
     total_residual_cpu -= app->getCPUSize();
     total_residual_mem -= app->getMemorySize();
@@ -563,9 +605,9 @@ Algo2DBFDSurrogate::Algo2DBFDSurrogate(const Instance2D &instance):
     Algo2DBFDAvgExpo(instance)
 { }
 
-void Algo2DBFDSurrogate::sortApps(AppList2D::iterator first_app, AppList2D::iterator end_it)
+void Algo2DBFDSurrogate::sortApps(AppIndexList::iterator first_app, AppIndexList::iterator end_it)
 {
-    stable_sort(first_app, end_it, application2D_comparator_surrogate_size_decreasing);
+    app_table.sortDecreasing(first_app, end_it, AppSortKey::Surrogate);
 }
 
 void Algo2DBFDSurrogate::sortBins() {
@@ -592,9 +634,9 @@ Algo2DBFDExtendedSum::Algo2DBFDExtendedSum(const Instance2D &instance):
     Algo2DBFDAvgExpo(instance)
 { }
 
-void Algo2DBFDExtendedSum::sortApps(AppList2D::iterator first_app, AppList2D::iterator end_it)
+void Algo2DBFDExtendedSum::sortApps(AppIndexList::iterator first_app, AppIndexList::iterator end_it)
 {
-    stable_sort(first_app, end_it, application2D_comparator_extsum_size_decreasing);
+    app_table.sortDecreasing(first_app, end_it, AppSortKey::ExtSum);
 }
 
 void Algo2DBFDExtendedSum::sortBins() {
@@ -676,7 +718,7 @@ Algo2DNodeCount::Algo2DNodeCount(const Instance2D &instance):
     AlgoFit2D(instance)
 { }
 
-void Algo2DNodeCount::sortApps(AppList2D::iterator first_app, AppList2D::iterator end_it) { }
+void Algo2DNodeCount::sortApps(AppIndexList::iterator first_app, AppIndexList::iterator end_it) { }
 void Algo2DNodeCount::sortBins() { }
 
 bool Algo2DNodeCount::checkItemToBin(Application2D* app, Bin2D* bin) const
@@ -684,61 +726,63 @@ bool Algo2DNodeCount::checkItemToBin(Application2D* app, Bin2D* bin) const
     return (bin->doesItemFit(app->getCPUSize(), app->getMemorySize())) and (bin->isAffinityCompliant(app));
 }
 
-void Algo2DNodeCount::addItemToBin(Application2D* app, int replica_id, Bin2D* bin)
+void Algo2DNodeCount::addItemToBin(Application2D* app, Bin2D* bin)
 {
     bin->addNewConflict(app);
-    bin->addItem(app, replica_id);
+    bin->addItem(app);
 }
 
 
-void Algo2DNodeCount::allocateBatch(AppList2D::iterator first_app, AppList2D::iterator end_batch)
+void Algo2DNodeCount::allocateBatch(AppIndexList::iterator first_app, AppIndexList::iterator end_batch)
 {
     Bin2D* curr_bin = nullptr;
     bool allocated = false;
 
     //First sort the items in decreasing degree
-    std::stable_sort(first_app, end_batch, application2D_comparator_total_degree_decreasing);
+    app_table.sortDecreasing(first_app, end_batch, AppSortKey::TotalDegree);
 
     // Brutal way to keep track of possible candidates, can probably be optimised
     // Stores for each app id the set of bin candidates (in which a replica can be packed)
     // The allocateBatch function can be called with a partial allocation of apps into bins
     // So initiate the list of bin candidates accordingly
-    std::unordered_map<std::string, std::vector<int>> bin_candidates;
-    for (Application2D* app : apps)
+    // Both are indexed by the internal id of the apps
+    std::vector<std::vector<int>> bin_candidates(apps.size());
+    for (int app_id : apps)
     {
         std::vector<int> v;
         for(Bin2D* bin : bins)
         {
-            if(checkItemToBin(app, bin))
+            if(checkItemToBin(app_list[app_id], bin))
             {
                 v.push_back(bin->getId());
             }
         }
-        bin_candidates[app->getId()] = v;
+        bin_candidates[app_id] = v;
     }
 
     auto current_app = first_app;
-    std::string current_app_id;
+    int current_app_id;
     auto end_list = end_batch;
     while(current_app != end_list)
     {
-        current_app_id = (*current_app)->getId();
+        current_app_id = *current_app;
+        Application2D* app = app_list[current_app_id];
         // Pack current app into bins
         std::vector<Bin2D*> bins_set; // The set of bins in which this item is packed
         auto next_app = current_app+1;
 
         auto bin_index_it = bin_candidates[current_app_id].begin();
-        for (int j = 0; j < (*current_app)->getNbReplicas(); ++j)
+        for (int j = 0; j < app_table.getNbReplicas(current_app_id); ++j)
         {
             // First try bin candidates
             allocated = false;
             while ( (!allocated) and bin_index_it != bin_candidates[current_app_id].end())
             {
                 curr_bin = bins.at(*bin_index_it);
-                if (checkItemToBin((*current_app), curr_bin))
+                if (checkItemToBin(app, curr_bin))
                 {
                     // This depends whether to update conflicts/affinities of the bin
-                    addItemToBin((*current_app), j, curr_bin);
+                    addItemToBin(app, curr_bin);
                     allocated = true;
 
                     // Update the bins set
@@ -757,7 +801,7 @@ void Algo2DNodeCount::allocateBatch(AppList2D::iterator first_app, AppList2D::it
             if (!allocated)
             {
                 // Create a new bin and pack the replica in it
-                curr_bin = new Bin2D(next_bin_index, bin_cpu_capacity, bin_mem_capacity);
+                curr_bin = newBin(next_bin_index);
                 bins.push_back(curr_bin);
 
                 // This is a quick safe guard to avoid infinite loops and running out of memory
@@ -770,8 +814,8 @@ void Algo2DNodeCount::allocateBatch(AppList2D::iterator first_app, AppList2D::it
                 // Add this bin to the candidates of all remaining apps
                 for (auto it = next_app; it != end_list; ++it)
                 {
-                    bin_candidates[(*it)->getId()].push_back(next_bin_index);
-                    (*it)->setMeasure(bin_candidates[(*it)->getId()].size());
+                    bin_candidates[*it].push_back(next_bin_index);
+                    app_measures.setMeasure(*it, bin_candidates[*it].size());
                 }
                 bin_candidates[current_app_id].push_back(next_bin_index);
 
@@ -782,52 +826,60 @@ void Algo2DNodeCount::allocateBatch(AppList2D::iterator first_app, AppList2D::it
                 bin_index_it--;
 
                 // Ths bin is empty, pack the replica
-                addItemToBin((*current_app), j, curr_bin);
+                addItemToBin(app, curr_bin);
                 bins_set.push_back(curr_bin);
             }
 
         } // End for: All replicas of this item were packed
-        (*current_app)->setFullyPacked(true);
+        app_measures.setFullyPacked(current_app_id, true);
 
         // Update the set of bin candidates of each adjacent item and their specific degree
-        for (auto pair : (*current_app)->getAffinityInMap())
+        for (const AffinityEdge& edge : app->getAffinityIn())
         {
-            Application2D* app = getApp2D(apps, pair.first);
-            if (!app->isFullyPacked()) // Otherwise don't need to update
+            if (edge.target >= (int)app_list.size())
+            {
+                continue; // Not an app of the instance
+            }
+            Application2D* adj_app = app_list[edge.target];
+            if (!app_measures.isFullyPacked(edge.target)) // Otherwise don't need to update
             {
                 for (Bin2D* bin : bins_set)
                 {
-                    std::vector<int>& bin_vect = bin_candidates[pair.first];
-                    if (!checkItemToBin(app, bin))
+                    std::vector<int>& bin_vect = bin_candidates[edge.target];
+                    if (!checkItemToBin(adj_app, bin))
                     {
                         // The adjacent item can no longer be packed, remove the bin from its candidates
                         auto it = std::find(bin_vect.begin(), bin_vect.end(), bin->getId());
                         if (it != bin_vect.end())
                         {
                             bin_vect.erase(it);
-                            app->setMeasure(bin_vect.size());
+                            app_measures.setMeasure(edge.target, bin_vect.size());
                         }
                     }
 
                 }
             }
         }
-        for (auto pair : (*current_app)->getAffinityOutMap())
+        for (const AffinityEdge& edge : app->getAffinityOut())
         {
-            Application2D* app = getApp2D(apps, pair.first);
-            if(!app->isFullyPacked())
+            if (edge.target >= (int)app_list.size())
+            {
+                continue; // Not an app of the instance
+            }
+            Application2D* adj_app = app_list[edge.target];
+            if(!app_measures.isFullyPacked(edge.target))
             {
                 for (Bin2D* bin : bins_set)
                 {
-                    std::vector<int>& bin_vect = bin_candidates[pair.first];
-                    if (!checkItemToBin(app, bin))
+                    std::vector<int>& bin_vect = bin_candidates[edge.target];
+                    if (!checkItemToBin(adj_app, bin))
                     {
                         // The adjacent item can no longer be packed, remove the bin from its candidates
                         auto it = std::find(bin_vect.begin(), bin_vect.end(), bin->getId());
                         if (it != bin_vect.end())
                         {
                             bin_vect.erase(it);
-                            app->setMeasure(bin_vect.size());
+                            app_measures.setMeasure(edge.target, bin_vect.size());
                         }
                     }
 
@@ -836,7 +888,7 @@ void Algo2DNodeCount::allocateBatch(AppList2D::iterator first_app, AppList2D::it
         }
         // Then bubble up the item of smallest degree (smallest number of bin candidates)
         // And advance the item iterator
-        bubble_apps2D_up(next_app, end_list, application2D_comparator_measure_increasing);
+        app_measures.bubbleMeasureUp(next_app, end_list, true);
 
         current_app = next_app;
     }
@@ -857,35 +909,32 @@ bool Algo2DBinFFDDotProduct::isBinFilled(Bin2D* bin)
          or (bin->getAvailableMemCap() == 0));
 }
 
-void Algo2DBinFFDDotProduct::computeMeasures(AppList2D::iterator start_list, AppList2D::iterator end_list, Bin2D *bin)
+void Algo2DBinFFDDotProduct::computeMeasures(AppIndexList::iterator start_list, AppIndexList::iterator end_list, Bin2D *bin)
 {
     for(auto it = start_list; it != end_list; ++it)
     {
-        Application2D * app = *it;
         // Use normalized values of app size and bin residual capacity
-        float measure = (app->getNormalizedCPU() * bin->getAvailableCPUCap()) / bin->getMaxCPUCap();
-        measure += (app->getNormalizedMemory() * bin->getAvailableMemCap()) / bin->getMaxMemCap();
-        app->setMeasure(measure);
+        float measure = (app_table.getNormalizedCPU(*it) * bin->getAvailableCPUCap()) / bin->getMaxCPUCap();
+        measure += (app_table.getNormalizedMemory(*it) * bin->getAvailableMemCap()) / bin->getMaxMemCap();
+        app_measures.setMeasure(*it, measure);
     }
 }
 
 Bin2D* Algo2DBinFFDDotProduct::createNewBinRet()
 {
-    Bin2D* bin = new Bin2D(next_bin_index, bin_cpu_capacity, bin_mem_capacity);
-    next_bin_index += 1;
-    bins.push_back(bin);
-    return bin;
+    createNewBin();
+    return bins.back();
 }
 
-void Algo2DBinFFDDotProduct::allocateBatch(AppList2D::iterator first_app, AppList2D::iterator end_batch)
+void Algo2DBinFFDDotProduct::allocateBatch(AppIndexList::iterator first_app, AppIndexList::iterator end_batch)
 {
-    std::unordered_map<std::string, int> next_id_replicas;
+    std::unordered_map<int, int> next_id_replicas;
     int nb_apps = end_batch - first_app;
     next_id_replicas.reserve(nb_apps);// Stores the id of the next replica to pack for each application
 
     for(auto it = first_app; it != end_batch; ++it)
     {
-        next_id_replicas[(*it)->getId()] = 0;
+        next_id_replicas[*it] = 0;
     }
 
     Bin2D* curr_bin = nullptr;
@@ -912,20 +961,21 @@ void Algo2DBinFFDDotProduct::allocateBatch(AppList2D::iterator first_app, AppLis
         {
             // Re-order the list following the measure
             computeMeasures(current_app_it, end_list, curr_bin);
-            bubble_apps2D_up(current_app_it, end_list, application2D_comparator_measure_decreasing);
+            app_measures.bubbleMeasureUp(current_app_it, end_list, false);
 
             // Retrieve the next application to pack
-            Application2D* app = *current_app_it;
+            int app_id = *current_app_it;
+            Application2D* app = app_list[app_id];
 
             // Try to pack as much replicas as possible
-            int replica_id = next_id_replicas[app->getId()];
+            int replica_id = next_id_replicas[app_id];
 
             bool could_pack = true;
-            while ( (replica_id < app->getNbReplicas()) and could_pack)
+            while ( (replica_id < app_table.getNbReplicas(app_id)) and could_pack)
             {
                 if (checkItemToBin(app, curr_bin))
                 {
-                    addItemToBin(app, replica_id, curr_bin);
+                    addItemToBin(app, curr_bin);
                     replica_id +=1;
                 }
                 else
@@ -934,10 +984,10 @@ void Algo2DBinFFDDotProduct::allocateBatch(AppList2D::iterator first_app, AppLis
                 }
             }
 
-            next_id_replicas[app->getId()] = replica_id;
+            next_id_replicas[app_id] = replica_id;
 
             // If no more replicas to pack, put the app in the fully packed zone
-            if (replica_id >= app->getNbReplicas())
+            if (replica_id >= app_table.getNbReplicas(app_id))
             {
                 std::iter_swap(next_treated_app_it, current_app_it);
                 next_treated_app_it++;
@@ -961,15 +1011,14 @@ Algo2DBinFFDDotDivision::Algo2DBinFFDDotDivision(const Instance2D &instance):
     Algo2DBinFFDDotProduct(instance)
 { }
 
-void Algo2DBinFFDDotDivision::computeMeasures(AppList2D::iterator start_list, AppList2D::iterator end_list, Bin2D *bin)
+void Algo2DBinFFDDotDivision::computeMeasures(AppIndexList::iterator start_list, AppIndexList::iterator end_list, Bin2D *bin)
 {
     for(auto it = start_list; it != end_list; ++it)
     {
-        Application2D * app = *it;
         // Use normalized values of app size and bin residual capacity
-        float measure = (app->getNormalizedCPU() * bin->getMaxCPUCap()) / bin->getAvailableCPUCap();
-        measure += (app->getNormalizedMemory() * bin->getMaxMemCap()) / bin->getAvailableMemCap();
-        app->setMeasure(measure);
+        float measure = (app_table.getNormalizedCPU(*it) * bin->getMaxCPUCap()) / bin->getAvailableCPUCap();
+        measure += (app_table.getNormalizedMemory(*it) * bin->getMaxMemCap()) / bin->getAvailableMemCap();
+        app_measures.setMeasure(*it, measure);
     }
 }
 
@@ -979,18 +1028,17 @@ Algo2DBinFFDL2Norm::Algo2DBinFFDL2Norm(const Instance2D &instance):
     Algo2DBinFFDDotProduct(instance)
 { }
 
-void Algo2DBinFFDL2Norm::computeMeasures(AppList2D::iterator start_list, AppList2D::iterator end_list, Bin2D *bin)
+void Algo2DBinFFDL2Norm::computeMeasures(AppIndexList::iterator start_list, AppIndexList::iterator end_list, Bin2D *bin)
 {
     for(auto it = start_list; it != end_list; ++it)
     {
-        Application2D * app = *it;
         // Use normalized values of app size and bin residual capacity
-        float a = (bin->getAvailableCPUCap() / bin->getMaxCPUCap()) - app->getNormalizedCPU();
-        float b = (bin->getAvailableMemCap() / bin->getMaxMemCap()) - app->getNormalizedMemory();
+        float a = (bin->getAvailableCPUCap() / bin->getMaxCPUCap()) - app_table.getNormalizedCPU(*it);
+        float b = (bin->getAvailableMemCap() / bin->getMaxMemCap()) - app_table.getNormalizedMemory(*it);
         float measure = a*a + b*b;
 
         // Minus sign to have reverse order
-        app->setMeasure(-measure);
+        app_measures.setMeasure(*it, -measure);
     }
 }
 
@@ -1005,9 +1053,7 @@ Algo2DBinFFDFitness::Algo2DBinFFDFitness(const Instance2D &instance):
 
 Bin2D* Algo2DBinFFDFitness::createNewBinRet()
 {
-    Bin2D* bin = new Bin2D(next_bin_index, bin_cpu_capacity, bin_mem_capacity);
-    next_bin_index += 1;
-    bins.push_back(bin);
+    Bin2D* bin = Algo2DBinFFDDotProduct::createNewBinRet();
 
     total_residual_cpu += bin_cpu_capacity;
     total_residual_mem += bin_mem_capacity;
@@ -1015,25 +1061,23 @@ Bin2D* Algo2DBinFFDFitness::createNewBinRet()
     return bin;
 }
 
-void Algo2DBinFFDFitness::addItemToBin(Application2D *app, int replica_id, Bin2D *bin)
+void Algo2DBinFFDFitness::addItemToBin(Application2D *app, Bin2D *bin)
 {
-    bin->addNewConflict(app);
-    bin->addItem(app, replica_id);
+    Algo2DFF::addItemToBin(app, bin);
 
     total_residual_cpu -= app->getCPUSize();
     total_residual_mem -= app->getMemorySize();
 }
 
 
-void Algo2DBinFFDFitness::computeMeasures(AppList2D::iterator start_list, AppList2D::iterator end_list, Bin2D *bin)
+void Algo2DBinFFDFitness::computeMeasures(AppIndexList::iterator start_list, AppIndexList::iterator end_list, Bin2D *bin)
 {
     for(auto it = start_list; it != end_list; ++it)
     {
-        Application2D * app = *it;
-        float a = (app->getNormalizedCPU() * bin->getAvailableCPUCap()) / (norm_sum_cpu * total_residual_cpu);
-        float b = (app->getNormalizedMemory() * bin->getAvailableMemCap()) / (norm_sum_mem * total_residual_mem);
+        float a = (app_table.getNormalizedCPU(*it) * bin->getAvailableCPUCap()) / (norm_sum_cpu * total_residual_cpu);
+        float b = (app_table.getNormalizedMemory(*it) * bin->getAvailableMemCap()) / (norm_sum_mem * total_residual_mem);
 
-        app->setMeasure(a+b);
+        app_measures.setMeasure(*it, a+b);
     }
 }
 
@@ -1057,7 +1101,7 @@ int Algo2DSpreadWFDAvg::solveInstanceSpread(int LB_bins, int UB_bins)
     }
 
     // Store the current solution
-    BinList2D best_bins = getBinsCopy();
+    saveBestSolution();
     int best_sol = UB_bins;
     int low_bound = LB_bins;
     int target_bins;
@@ -1071,15 +1115,7 @@ int Algo2DSpreadWFDAvg::solveInstanceSpread(int LB_bins, int UB_bins)
         {
             // Update the best solution
             best_sol = target_bins;
-            for (Bin2D* bin : best_bins)
-            {
-                if (bin != nullptr)
-                {
-                    delete bin;
-                }
-            }
-            best_bins.clear();
-            best_bins = getBinsCopy();
+            saveBestSolution();
         }
         else
         {
@@ -1087,7 +1123,7 @@ int Algo2DSpreadWFDAvg::solveInstanceSpread(int LB_bins, int UB_bins)
             low_bound = target_bins+1;
         }
     }
-    setSolution(best_bins);
+    restoreBestSolution();
     return best_sol;
 }
 
@@ -1102,9 +1138,9 @@ bool Algo2DSpreadWFDAvg::trySolve(int nb_bins)
     auto current_app_it = apps.begin();
     while(current_app_it != apps.end())
     {
-        Application2D * app = *current_app_it;
+        Application2D * app = app_list[*current_app_it];
         curr_bin_index = 0;
-        int replica_index = app->getNbReplicas()-1;
+        int replica_index = app_table.getNbReplicas(*current_app_it)-1;
         while(replica_index >= 0) // There are still replicas to pack
         {
             bool replica_packed = false;
@@ -1114,7 +1150,7 @@ bool Algo2DSpreadWFDAvg::trySolve(int nb_bins)
                 curr_bin = bins.at(curr_bin_index);
                 if (checkItemToBin(app, curr_bin))
                 {
-                    addItemToBin(app, replica_index, curr_bin);
+                    addItemToBin(app, curr_bin);
                     updateBinMeasure(curr_bin);
                     replica_packed = true;
                     replica_index -= 1;
@@ -1146,12 +1182,31 @@ bool Algo2DSpreadWFDAvg::trySolve(int nb_bins)
     return true;
 }
 
+void Algo2DSpreadWFDAvg::saveBestSolution()
+{
+    // Copied in the bins of best_arena, which keep their containers
+    best_arena.reset();
+    best_bins.clear();
+    for (Bin2D* bin : bins)
+    {
+        best_bins.push_back(best_arena.get(best_arena.createCopy(*bin)));
+    }
+}
+
+void Algo2DSpreadWFDAvg::restoreBestSolution()
+{
+    // The bins of the current solution are kept for the next copy
+    bin_arena.swap(best_arena);
+    bins.swap(best_bins);
+    solved = true;
+}
+
 void Algo2DSpreadWFDAvg::createBins(int nb_bins)
 {
     bins.reserve(nb_bins);
     for (int i = 0; i < nb_bins; ++i)
     {
-        Bin2D* bin = new Bin2D(i, bin_cpu_capacity, bin_mem_capacity);
+        Bin2D* bin = newBin(i);
         updateBinMeasure(bin);
         bins.push_back(bin);
     }
@@ -1167,15 +1222,15 @@ void Algo2DSpreadWFDAvg::updateBinMeasure(Bin2D* bin)
 void Algo2DSpreadWFDAvg::updateBinMeasures(){ }
 
 
-void Algo2DSpreadWFDAvg::allocateBatch(AppList2D::iterator first_app, AppList2D::iterator end_batch)
+void Algo2DSpreadWFDAvg::allocateBatch(AppIndexList::iterator first_app, AppIndexList::iterator end_batch)
 {
     std::cout << "For Spread algorithm please call 'solveInstanceSpread' instead" << std::endl;
     return;
 }
 
-void Algo2DSpreadWFDAvg::sortApps(AppList2D::iterator first_app, AppList2D::iterator end_it)
+void Algo2DSpreadWFDAvg::sortApps(AppIndexList::iterator first_app, AppIndexList::iterator end_it)
 {
-    stable_sort(first_app, end_it, application2D_comparator_avg_size_decreasing);
+    app_table.sortDecreasing(first_app, end_it, AppSortKey::AvgSize);
 }
 
 void Algo2DSpreadWFDAvg::sortBins()
@@ -1188,10 +1243,10 @@ bool Algo2DSpreadWFDAvg::checkItemToBin(Application2D* app, Bin2D* bin) const
     return (bin->doesItemFit(app->getCPUSize(), app->getMemorySize())) and (bin->isAffinityCompliant(app));
 }
 
-void Algo2DSpreadWFDAvg::addItemToBin(Application2D* app, int replica_id, Bin2D* bin)
+void Algo2DSpreadWFDAvg::addItemToBin(Application2D* app, Bin2D* bin)
 {
     bin->addNewConflict(app);
-    bin->addItem(app, replica_id);
+    bin->addItem(app);
 }
 
 
@@ -1207,9 +1262,9 @@ void Algo2DSpreadWFDMax::updateBinMeasure(Bin2D* bin)
     bin->setMeasure(measure);
 }
 
-void Algo2DSpreadWFDMax::sortApps(AppList2D::iterator first_app, AppList2D::iterator end_it)
+void Algo2DSpreadWFDMax::sortApps(AppIndexList::iterator first_app, AppIndexList::iterator end_it)
 {
-    stable_sort(first_app, end_it, application2D_comparator_max_size_decreasing);
+    app_table.sortDecreasing(first_app, end_it, AppSortKey::MaxSize);
 }
 
 
@@ -1221,9 +1276,9 @@ Algo2DSpreadWFDAvgExpo::Algo2DSpreadWFDAvgExpo(const Instance2D &instance):
     total_residual_mem(0)
 { }
 
-void Algo2DSpreadWFDAvgExpo::sortApps(AppList2D::iterator first_app, AppList2D::iterator end_it)
+void Algo2DSpreadWFDAvgExpo::sortApps(AppIndexList::iterator first_app, AppIndexList::iterator end_it)
 {
-    stable_sort(first_app, end_it, application2D_comparator_avgexpo_size_decreasing);
+    app_table.sortDecreasing(first_app, end_it, AppSortKey::AvgExpo);
 }
 
 void Algo2DSpreadWFDAvgExpo::createBins(int nb_bins)
@@ -1231,7 +1286,7 @@ void Algo2DSpreadWFDAvgExpo::createBins(int nb_bins)
     bins.reserve(nb_bins);
     for (int i = 0; i < nb_bins; ++i)
     {
-        Bin2D* bin = new Bin2D(i, bin_cpu_capacity, bin_mem_capacity);
+        Bin2D* bin = newBin(i);
         bins.push_back(bin);
     }
 
@@ -1239,10 +1294,10 @@ void Algo2DSpreadWFDAvgExpo::createBins(int nb_bins)
     total_residual_mem = nb_bins * bin_mem_capacity;
 }
 
-void Algo2DSpreadWFDAvgExpo::addItemToBin(Application2D* app, int replica_id, Bin2D* bin)
+void Algo2DSpreadWFDAvgExpo::addItemToBin(Application2D* app, Bin2D* bin)
 {
     bin->addNewConflict(app);
-    bin->addItem(app, replica_id);
+    bin->addItem(app);
 
     total_residual_cpu -= app->getCPUSize();
     total_residual_mem -= app->getMemorySize();
@@ -1271,9 +1326,9 @@ Algo2DSpreadWFDSurrogate::Algo2DSpreadWFDSurrogate(const Instance2D &instance):
     Algo2DSpreadWFDAvgExpo(instance)
 { }
 
-void Algo2DSpreadWFDSurrogate::sortApps(AppList2D::iterator first_app, AppList2D::iterator end_it)
+void Algo2DSpreadWFDSurrogate::sortApps(AppIndexList::iterator first_app, AppIndexList::iterator end_it)
 {
-    stable_sort(first_app, end_it, application2D_comparator_max_size_decreasing);
+    app_table.sortDecreasing(first_app, end_it, AppSortKey::MaxSize);
 }
 
 void Algo2DSpreadWFDSurrogate::updateBinMeasure(Bin2D* bin) { }
@@ -1297,9 +1352,9 @@ Algo2DSpreadWFDExtendedSum::Algo2DSpreadWFDExtendedSum(const Instance2D &instanc
     Algo2DSpreadWFDAvgExpo(instance)
 { }
 
-void Algo2DSpreadWFDExtendedSum::sortApps(AppList2D::iterator first_app, AppList2D::iterator end_it)
+void Algo2DSpreadWFDExtendedSum::sortApps(AppIndexList::iterator first_app, AppIndexList::iterator end_it)
 {
-    stable_sort(first_app, end_it, application2D_comparator_max_size_decreasing);
+    app_table.sortDecreasing(first_app, end_it, AppSortKey::MaxSize);
 }
 
 void Algo2DSpreadWFDExtendedSum::updateBinMeasure(Bin2D* bin) { }
@@ -1347,7 +1402,7 @@ int Algo2DRefineWFDAvg::solveInstanceSpread(int LB_bins, int UB_bins)
     else
     {
         // Try to refine the solution with small steps
-        BinList2D best_bins = getBinsCopy();
+        saveBestSolution();
         best_sol = UB_bins;
         int target_bins;
 
@@ -1361,15 +1416,7 @@ int Algo2DRefineWFDAvg::solveInstanceSpread(int LB_bins, int UB_bins)
                 // Update the best solution
                 best_sol = target_bins;
                 //UB_bins = target_bins;
-                for (Bin2D* bin : best_bins)
-                {
-                    if (bin != nullptr)
-                    {
-                        delete bin;
-                    }
-                }
-                best_bins.clear();
-                best_bins = getBinsCopy();
+                saveBestSolution();
             }
             else
             {
@@ -1377,7 +1424,7 @@ int Algo2DRefineWFDAvg::solveInstanceSpread(int LB_bins, int UB_bins)
                 break;
             }
         }
-        setSolution(best_bins);
+        restoreBestSolution();
     }
     return best_sol;
 }
@@ -1,6 +1,9 @@
 #ifndef ALGOS2D_HPP
 #define ALGOS2D_HPP
 
+#include "app_table.hpp"
+#include "bin_arena.hpp"
+#include "bin_pool.hpp"
 #include "application.hpp"
 #include "instance.hpp"
 #include "bins.hpp"
@@ -17,29 +20,37 @@ public:
     bool isSolved() const;
     int getSolution() const;
     const BinList2D& getBins() const;
-    BinList2D getBinsCopy() const;
+    BinList2D getBinsCopy() const; // New bins owned by the caller, see freeBins
+    std::vector<int> getReplicaBins() const; // See computeReplicaBins
     const AppList2D& getApps() const;
     const int getBinCPUCapacity() const;
     const int getBinMemCapacity() const;
     const std::string& getInstanceName() const;
 
-    void setSolution(BinList2D& bins);
-    void clearSolution();
+    // Copies the bins, which stay the caller's: bins from getBinsCopy are
+    // still freed by the caller, the copies are numbered by their position
+    virtual void setSolution(const BinList2D& bins);
+    virtual void clearSolution();
 
     int solveInstance(int hint_nb_bins = 0);
     int solvePerBatch(int batch_size, int hint_nb_bins = 0);
 
 private:
-    virtual void createNewBin(); // Open a new empty bin
-    virtual void allocateBatch(AppList2D::iterator first_app, AppList2D::iterator end_batch);
+    virtual void allocateBatch(AppIndexList::iterator first_app, AppIndexList::iterator end_batch);
+    // Index of the next bin from first_bin given to checkItemToBin for app,
+    // next_bin_index to open a new bin; first_bin by default
+    virtual int findCandidateBin(Application2D* app, int first_bin) const;
 
     // These are the methods each variant of the Fit algo should implement
     virtual void sortBins() = 0;
-    virtual void sortApps(AppList2D::iterator first_app, AppList2D::iterator end_it) = 0;
+    virtual void sortApps(AppIndexList::iterator first_app, AppIndexList::iterator end_it) = 0;
     virtual bool checkItemToBin(Application2D* app, Bin2D* bin) const = 0;
-    virtual void addItemToBin(Application2D* app, int replica_id, Bin2D* bin) = 0;
+    virtual void addItemToBin(Application2D* app, Bin2D* bin) = 0;
 
 protected:
+    virtual void createNewBin(); // Open a new empty bin
+    Bin2D* newBin(int id); // New empty bin in bin_arena
+
     std::string instance_name;
     int bin_cpu_capacity;
     int bin_mem_capacity;
@@ -50,7 +61,11 @@ protected:
     float norm_sum_mem;
     int next_bin_index;
     int curr_bin_index;
-    AppList2D apps;
+    AppList2D app_list;  // The apps of the instance, by internal id, for the bins
+    const AppTable& app_table; // Sizes and sort keys of the apps, shared with the instance
+    AppMeasures app_measures;  // Measures and packing state of the apps
+    AppIndexList apps;   // Internal ids of the apps, in the order they are packed
+    BinArena<Bin2D> bin_arena; // Storage of the bins, reused by the next solutions
     BinList2D bins;
     bool solved;
 };
@@ -66,11 +81,23 @@ class Algo2DFF : public AlgoFit2D
 {
 public: 
     Algo2DFF(const Instance2D &instance);
+
+    virtual void setSolution(const BinList2D& bins);
+    virtual void clearSolution();
 protected:
-    virtual void sortApps(AppList2D::iterator first_app, AppList2D::iterator end_it);
+    virtual void sortApps(AppIndexList::iterator first_app, AppIndexList::iterator end_it);
     virtual void sortBins();
     virtual bool checkItemToBin(Application2D* app, Bin2D* bin) const;
-    virtual void addItemToBin(Application2D* app, int replica_id, Bin2D* bin);
+    virtual void addItemToBin(Application2D* app, Bin2D* bin);
+    virtual void createNewBin();
+private:
+    // The bins without the capacity for the app are skipped by a search in
+    // bin_pool, checkItemToBin is called on the others
+    virtual int findCandidateBin(Application2D* app, int first_bin) const;
+
+    // Available capacities of the bins, indexed by their position in bins
+    // The bins are never reordered and their id is their position (see setSolution)
+    BinPool bin_pool;
 };
 
 
@@ -80,7 +107,7 @@ class Algo2DFFDDegree : public Algo2DFF
 public:
     Algo2DFFDDegree(const Instance2D &instance);
 private:
-    virtual void sortApps(AppList2D::iterator first_app, AppList2D::iterator end_it);
+    virtual void sortApps(AppIndexList::iterator first_app, AppIndexList::iterator end_it);
 };
 
 /************ First Fit Decreasing Average Affinity *********/
@@ -89,7 +116,7 @@ class Algo2DFFDAvg : public Algo2DFF
 public: 
     Algo2DFFDAvg(const Instance2D &instance);
 private:
-    virtual void sortApps(AppList2D::iterator first_app, AppList2D::iterator end_it);
+    virtual void sortApps(AppIndexList::iterator first_app, AppIndexList::iterator end_it);
 };
 
 /************ First Fit Decreasing Average with Exponential Weights Affinity *********/
@@ -98,7 +125,7 @@ class Algo2DFFDAvgExpo : public Algo2DFF
 public:
     Algo2DFFDAvgExpo(const Instance2D &instance);
 private:
-    virtual void sortApps(AppList2D::iterator first_app, AppList2D::iterator end_it);
+    virtual void sortApps(AppIndexList::iterator first_app, AppIndexList::iterator end_it);
 };
 
 /************ First Fit Decreasing Max Affinity *********/
@@ -107,7 +134,7 @@ class Algo2DFFDMax : public Algo2DFF
 public: 
     Algo2DFFDMax(const Instance2D &instance);
 private:
-    virtual void sortApps(AppList2D::iterator first_app, AppList2D::iterator end_it);
+    virtual void sortApps(AppIndexList::iterator first_app, AppIndexList::iterator end_it);
 };
 
 /************ First Fit Decreasing Surrogate Affinity *********/
@@ -117,7 +144,7 @@ public:
     Algo2DFFDSurrogate(const Instance2D &instance);
 
 protected:
-    virtual void sortApps(AppList2D::iterator first_app, AppList2D::iterator end_it);
+    virtual void sortApps(AppIndexList::iterator first_app, AppIndexList::iterator end_it);
 };
 
 /************ First Fit Decreasing Extended Sum Affinity *********/
@@ -127,7 +154,7 @@ public:
     Algo2DFFDExtendedSum(const Instance2D &instance);
 
 protected:
-    virtual void sortApps(AppList2D::iterator first_app, AppList2D::iterator end_it);
+    virtual void sortApps(AppIndexList::iterator first_app, AppIndexList::iterator end_it);
 };
 
 
@@ -141,10 +168,10 @@ class Algo2DBFDAvg : public AlgoFit2D
 public:
     Algo2DBFDAvg(const Instance2D &instance);
 private:
-    virtual void sortApps(AppList2D::iterator first_app, AppList2D::iterator end_it);
+    virtual void sortApps(AppIndexList::iterator first_app, AppIndexList::iterator end_it);
     virtual void sortBins();
     virtual bool checkItemToBin(Application2D* app, Bin2D* bin) const;
-    virtual void addItemToBin(Application2D* app, int replica_id, Bin2D* bin);
+    virtual void addItemToBin(Application2D* app, Bin2D* bin);
 
     virtual void updateBinMeasure(Bin2D* bin);
 };
@@ -155,7 +182,7 @@ class Algo2DBFDMax : public Algo2DBFDAvg
 public:
     Algo2DBFDMax(const Instance2D &instance);
 private:
-    virtual void sortApps(AppList2D::iterator first_app, AppList2D::iterator end_it);
+    virtual void sortApps(AppIndexList::iterator first_app, AppIndexList::iterator end_it);
     virtual void updateBinMeasure(Bin2D* bin);
 };
 
@@ -165,10 +192,10 @@ class Algo2DBFDAvgExpo : public Algo2DBFDAvg
 public:
     Algo2DBFDAvgExpo(const Instance2D &instance);
 private:
-    virtual void sortApps(AppList2D::iterator first_app, AppList2D::iterator end_it);
+    virtual void sortApps(AppIndexList::iterator first_app, AppIndexList::iterator end_it);
     virtual void sortBins();
     virtual void createNewBin();
-    virtual void addItemToBin(Application2D *app, int replica_id, Bin2D *bin);
+    virtual void addItemToBin(Application2D *app, Bin2D *bin);
     virtual void updateBinMeasure(Bin2D* bin);
 protected:
     int total_residual_cpu;
@@ -182,7 +209,7 @@ public:
     Algo2DBFDSurrogate(const Instance2D &instance);
 
 protected:
-    virtual void sortApps(AppList2D::iterator first_app, AppList2D::iterator end_it);
+    virtual void sortApps(AppIndexList::iterator first_app, AppIndexList::iterator end_it);
     virtual void sortBins();
     virtual void updateBinMeasure(Bin2D* bin);
 };
@@ -194,7 +221,7 @@ public:
     Algo2DBFDExtendedSum(const Instance2D &instance);
 
 protected:
-    virtual void sortApps(AppList2D::iterator first_app, AppList2D::iterator end_it);
+    virtual void sortApps(AppIndexList::iterator first_app, AppIndexList::iterator end_it);
     virtual void sortBins();
     virtual void updateBinMeasure(Bin2D* bin);
 };
@@ -261,13 +288,13 @@ class Algo2DNodeCount : public AlgoFit2D
 public:
     Algo2DNodeCount(const Instance2D &instance);
 protected:
-    virtual void sortApps(AppList2D::iterator first_app, AppList2D::iterator end_it);
+    virtual void sortApps(AppIndexList::iterator first_app, AppIndexList::iterator end_it);
     virtual void sortBins();
     virtual bool checkItemToBin(Application2D* app, Bin2D* bin) const;
-    virtual void addItemToBin(Application2D* app, int replica_id, Bin2D* bin);
+    virtual void addItemToBin(Application2D* app, Bin2D* bin);
 
 private:
-    virtual void allocateBatch(AppList2D::iterator first_app, AppList2D::iterator end_batch);
+    virtual void allocateBatch(AppIndexList::iterator first_app, AppIndexList::iterator end_batch);
 };
 
 
@@ -283,11 +310,11 @@ public:
     Algo2DBinFFDDotProduct(const Instance2D &instance);
 
 private:
-    virtual void allocateBatch(AppList2D::iterator first_app, AppList2D::iterator end_batch);
+    virtual void allocateBatch(AppIndexList::iterator first_app, AppIndexList::iterator end_batch);
 protected:
     virtual Bin2D* createNewBinRet();
     virtual bool isBinFilled(Bin2D* bin);
-    virtual void computeMeasures(AppList2D::iterator start_list, AppList2D::iterator end_list, Bin2D* bin);
+    virtual void computeMeasures(AppIndexList::iterator start_list, AppIndexList::iterator end_list, Bin2D* bin);
 };
 
 /********* Bin Centric FFD DotDivision ***************/
@@ -297,7 +324,7 @@ public:
     Algo2DBinFFDDotDivision(const Instance2D &instance);
 
 protected:
-    virtual void computeMeasures(AppList2D::iterator start_list, AppList2D::iterator end_list,  Bin2D* bin);
+    virtual void computeMeasures(AppIndexList::iterator start_list, AppIndexList::iterator end_list,  Bin2D* bin);
 };
 
 /********* Bin Centric FFD L2Norm ***************/
@@ -307,7 +334,7 @@ public:
     Algo2DBinFFDL2Norm(const Instance2D &instance);
 
 protected:
-    virtual void computeMeasures(AppList2D::iterator start_list, AppList2D::iterator end_list,  Bin2D* bin);
+    virtual void computeMeasures(AppIndexList::iterator start_list, AppIndexList::iterator end_list,  Bin2D* bin);
 };
 
 /********* Bin Centric FFD Fitness ***************/
@@ -317,10 +344,10 @@ public:
     Algo2DBinFFDFitness(const Instance2D &instance);
 
 protected:
-    virtual void computeMeasures(AppList2D::iterator start_list, AppList2D::iterator end_list,  Bin2D* bin);
+    virtual void computeMeasures(AppIndexList::iterator start_list, AppIndexList::iterator end_list,  Bin2D* bin);
 
     virtual Bin2D* createNewBinRet();
-    virtual void addItemToBin(Application2D *app, int replica_id, Bin2D *bin);
+    virtual void addItemToBin(Application2D *app, Bin2D *bin);
     int total_residual_cpu;
     int total_residual_mem;
 };
@@ -338,18 +365,22 @@ public:
     virtual int solveInstanceSpread(int LB_bins, int UB_bins);
 protected:
     bool trySolve(int nb_bins); // Try to find a solution with the given bins
+    void saveBestSolution();    // Copy of the bins as the best solution
+    void restoreBestSolution(); // The best solution becomes the solution
 private:
+    BinArena<Bin2D> best_arena; // Storage of the best bins, reused by the next copies
+    BinList2D best_bins;
 
     virtual void createBins(int nb_bins);
     virtual void updateBinMeasure(Bin2D* bin);
     virtual void updateBinMeasures();          // If all bins need to be updated
 
-    virtual void allocateBatch(AppList2D::iterator first_app, AppList2D::iterator end_batch);
+    virtual void allocateBatch(AppIndexList::iterator first_app, AppIndexList::iterator end_batch);
 
     virtual void sortBins();
-    virtual void sortApps(AppList2D::iterator first_app, AppList2D::iterator end_it);
+    virtual void sortApps(AppIndexList::iterator first_app, AppIndexList::iterator end_it);
     virtual bool checkItemToBin(Application2D* app, Bin2D* bin) const;
-    virtual void addItemToBin(Application2D* app, int replica_id, Bin2D* bin);
+    virtual void addItemToBin(Application2D* app, Bin2D* bin);
 };
 
 /*********** Spread replicas Worst Fit Max **********/
@@ -360,7 +391,7 @@ public:
 
 private:
     virtual void updateBinMeasure(Bin2D* bin);
-    virtual void sortApps(AppList2D::iterator first_app, AppList2D::iterator end_it);
+    virtual void sortApps(AppIndexList::iterator first_app, AppIndexList::iterator end_it);
 };
 
 
@@ -374,8 +405,8 @@ private:
     virtual void createBins(int nb_bins);
     virtual void updateBinMeasure(Bin2D* bin);
     virtual void updateBinMeasures();
-    virtual void addItemToBin(Application2D *app, int replica_id, Bin2D *bin);
-    virtual void sortApps(AppList2D::iterator first_app, AppList2D::iterator end_it);
+    virtual void addItemToBin(Application2D *app, Bin2D *bin);
+    virtual void sortApps(AppIndexList::iterator first_app, AppIndexList::iterator end_it);
 
 protected:
     int total_residual_cpu;
@@ -391,7 +422,7 @@ public:
 private:
     virtual void updateBinMeasure(Bin2D* bin);
     virtual void updateBinMeasures();
-    virtual void sortApps(AppList2D::iterator first_app, AppList2D::iterator end_it);
+    virtual void sortApps(AppIndexList::iterator first_app, AppIndexList::iterator end_it);
 };
 
 
@@ -404,7 +435,7 @@ public:
 private:
     virtual void updateBinMeasure(Bin2D* bin);
     virtual void updateBinMeasures();
-    virtual void sortApps(AppList2D::iterator first_app, AppList2D::iterator end_it);
+    virtual void sortApps(AppIndexList::iterator first_app, AppIndexList::iterator end_it);
 };
 
 
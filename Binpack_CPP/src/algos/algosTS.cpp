@@ -147,6 +147,7 @@ AlgoTSSpreadWFDAvg* createSpreadAlgo(const std::string &algo_name, const Instanc
 AlgoFitTS::AlgoFitTS(const InstanceTS & instance):
     instance_name(instance.getId()),
     size_TS(instance.getTSLength()),
+    precision(instance.getSeriesPrecision()),
     bin_cpu_capacity(instance.getBinCPUCapacity()),
     bin_mem_capacity(instance.getBinMemCapacity()),
     total_replicas(instance.getTotalReplicas()),
@@ -160,15 +161,7 @@ AlgoFitTS::AlgoFitTS(const InstanceTS & instance):
 { }
 
 AlgoFitTS::~AlgoFitTS()
-{
-    for (BinTS* bin : bins)
-    {
-        if (bin != nullptr)
-        {
-            delete bin;
-        }
-    }
-}
+{ } // The bins are freed with bin_arena
 
 bool AlgoFitTS::isSolved() const
 {
@@ -196,6 +189,11 @@ BinListTS AlgoFitTS::getBinsCopy() const
     return new_bins;
 }
 
+std::vector<int> AlgoFitTS::getReplicaBins() const
+{
+    return computeReplicaBins(bins, apps);
+}
+
 const AppListTS& AlgoFitTS::getApps() const
 {
     return apps;
@@ -216,30 +214,37 @@ const std::string& AlgoFitTS::getInstanceName() const
     return instance_name;
 }
 
-void AlgoFitTS::setSolution(BinListTS& bins)
+void AlgoFitTS::setSolution(const BinListTS& bins)
 {
     clearSolution();
-    this->bins = bins;
+    // The bins are copied in bin_arena, the id of a copy is its position
+    // as for the bins created by the algo
+    for (const BinTS* bin : bins)
+    {
+        BinTS* copy = bin_arena.get(bin_arena.createCopy(*bin));
+        copy->setId(next_bin_index);
+        this->bins.push_back(copy);
+        next_bin_index += 1;
+    }
     solved = true;
 }
 
 void AlgoFitTS::clearSolution()
 {
     solved = false;
-    for (BinTS* bin : bins)
-    {
-        if (bin != nullptr)
-        {
-            delete bin;
-        }
-    }
+    bin_arena.reset(); // The bins are kept for the next solution
     bins.clear();
     next_bin_index = 0;
 }
 
+BinTS* AlgoFitTS::newBin(int id)
+{
+    return bin_arena.get(bin_arena.create(id, bin_cpu_capacity, bin_mem_capacity, size_TS, precision));
+}
+
 void AlgoFitTS::createNewBin()
 {
-    bins.push_back(new BinTS(next_bin_index, bin_cpu_capacity, bin_mem_capacity, size_TS));
+    bins.push_back(newBin(next_bin_index));
     next_bin_index += 1;
 }
 
@@ -281,7 +286,7 @@ void AlgoFitTS::allocateBatch(AppListTS::iterator first_app, AppListTS::iterator
                 if (checkItemToBin(app, curr_bin))
                 {
                     // This depends whether to update conflicts/affinities of the bin
-                    addItemToBin(app, j, curr_bin);
+                    addItemToBin(app, curr_bin);
                     allocated = true;
                 }
                 else
@@ -363,10 +368,10 @@ bool AlgoTSFF::checkItemToBin(ApplicationTS* app, BinTS* bin) const
     return (bin->doesItemFit(app)) and (bin->isAffinityCompliant(app));
 }
 
-void AlgoTSFF::addItemToBin(ApplicationTS* app, int replica_id, BinTS* bin)
+void AlgoTSFF::addItemToBin(ApplicationTS* app, BinTS* bin)
 {
     bin->addNewConflict(app);
-    bin->addItem(app, replica_id);
+    bin->addItem(app);
 }
 
 
@@ -463,10 +468,10 @@ bool AlgoTSBFDAvg::checkItemToBin(ApplicationTS* app, BinTS* bin) const
     return (bin->doesItemFit(app)) and (bin->isAffinityCompliant(app));
 }
 
-void AlgoTSBFDAvg::addItemToBin(ApplicationTS* app, int replica_id, BinTS* bin)
+void AlgoTSBFDAvg::addItemToBin(ApplicationTS* app, BinTS* bin)
 {
     bin->addNewConflict(app);
-    bin->addItem(app, replica_id);
+    bin->addItem(app);
 
     updateBinMeasure(bin);
 }
@@ -533,7 +538,7 @@ void AlgoTSBFDAvgExpo::sortBins() {
 
 void AlgoTSBFDAvgExpo::createNewBin()
 {
-    bins.push_back(new BinTS(next_bin_index, bin_cpu_capacity, bin_mem_capacity, size_TS));
+    bins.push_back(newBin(next_bin_index));
     next_bin_index += 1;
 
     for(size_t i = 0; i < size_TS; ++i)
@@ -543,13 +548,13 @@ void AlgoTSBFDAvgExpo::createNewBin()
     }
 }
 
-void AlgoTSBFDAvgExpo::addItemToBin(ApplicationTS *app, int replica_id, BinTS *bin)
+void AlgoTSBFDAvgExpo::addItemToBin(ApplicationTS *app, BinTS *bin)
 {
     bin->addNewConflict(app);
-    bin->addItem(app, replica_id);
+    bin->addItem(app);
 
-    const ResourceTS& app_cpu = app->getCpuUsage();
-    const ResourceTS& app_mem = app->getMemUsage();
+    SeriesSpan app_cpu = app->getCpuUsage();
+    SeriesSpan app_mem = app->getMemUsage();
 
     for(size_t i = 0; i < size_TS; ++i)
     {
@@ -759,8 +764,8 @@ void AlgoTSBinFFDDotProduct::computeMeasures(AppListTS::iterator start_list, App
     {
         ApplicationTS * app = *it;
         // Use normalized values of app size and bin residual capacity
-        const ResourceTS& app_norm_cpu = app->getNormCpuUsage();
-        const ResourceTS& app_norm_mem = app->getNormMemUsage();
+        ScaledSeries app_norm_cpu = app->getNormCpuUsage();
+        ScaledSeries app_norm_mem = app->getNormMemUsage();
         float measure = 0.0;
         for (size_t i = 0; i < size_TS; ++i)
         {
@@ -774,7 +779,7 @@ void AlgoTSBinFFDDotProduct::computeMeasures(AppListTS::iterator start_list, App
 
 BinTS* AlgoTSBinFFDDotProduct::createNewBinRet()
 {
-    BinTS* bin = new BinTS(next_bin_index, bin_cpu_capacity, bin_mem_capacity, size_TS);
+    BinTS* bin = newBin(next_bin_index);
     next_bin_index += 1;
     bins.push_back(bin);
     return bin;
@@ -782,12 +787,12 @@ BinTS* AlgoTSBinFFDDotProduct::createNewBinRet()
 
 void AlgoTSBinFFDDotProduct::allocateBatch(AppListTS::iterator first_app, AppListTS::iterator end_batch)
 {
-    std::unordered_map<std::string, int> next_id_replicas;
+    std::unordered_map<int, int> next_id_replicas;
     next_id_replicas.reserve((end_batch - first_app)); // Stores the id of the next replica to pack for each application
 
     for(auto it = first_app; it != end_batch; ++it)
     {
-        next_id_replicas[(*it)->getId()] = 0;
+        next_id_replicas[(*it)->getInternalId()] = 0;
     }
 
     BinTS* curr_bin = nullptr;
@@ -820,14 +825,14 @@ void AlgoTSBinFFDDotProduct::allocateBatch(AppListTS::iterator first_app, AppLis
             ApplicationTS* app = *current_app_it;
 
             // Try to pack as much replicas as possible
-            int replica_id = next_id_replicas[app->getId()];
+            int replica_id = next_id_replicas[app->getInternalId()];
 
             bool could_pack = true;
             while ( (replica_id < app->getNbReplicas()) and could_pack)
             {
                 if (checkItemToBin(app, curr_bin))
                 {
-                    addItemToBin(app, replica_id, curr_bin);
+                    addItemToBin(app, curr_bin);
                     replica_id +=1;
                 }
                 else
@@ -836,7 +841,7 @@ void AlgoTSBinFFDDotProduct::allocateBatch(AppListTS::iterator first_app, AppLis
                 }
             }
 
-            next_id_replicas[app->getId()] = replica_id;
+            next_id_replicas[app->getInternalId()] = replica_id;
 
             // If no more replicas to pack, put the app in the fully packed zone
             if (replica_id >= app->getNbReplicas())
@@ -871,8 +876,8 @@ void AlgoTSBinFFDDotDivision::computeMeasures(AppListTS::iterator start_list, Ap
     {
         ApplicationTS * app = *it;
         // Use normalized values of app size and bin residual capacity
-        const ResourceTS& app_norm_cpu = app->getNormCpuUsage();
-        const ResourceTS& app_norm_mem = app->getNormMemUsage();
+        ScaledSeries app_norm_cpu = app->getNormCpuUsage();
+        ScaledSeries app_norm_mem = app->getNormMemUsage();
         float measure = 0.0;
         for (size_t i = 0; i < size_TS; ++i)
         {
@@ -899,8 +904,8 @@ void AlgoTSBinFFDL2Norm::computeMeasures(AppListTS::iterator start_list, AppList
     {
         ApplicationTS * app = *it;
         // Use normalized values of app size and bin residual capacity
-        const ResourceTS& app_norm_cpu = app->getNormCpuUsage();
-        const ResourceTS& app_norm_mem = app->getNormMemUsage();
+        ScaledSeries app_norm_cpu = app->getNormCpuUsage();
+        ScaledSeries app_norm_mem = app->getNormMemUsage();
         float measure = 0.0;
         for (size_t i = 0; i < size_TS; ++i)
         {
@@ -936,12 +941,12 @@ BinTS* AlgoTSBinFFDFitness::createNewBinRet()
     return bin;
 }
 
-void AlgoTSBinFFDFitness::addItemToBin(ApplicationTS *app, int replica_id, BinTS *bin)
+void AlgoTSBinFFDFitness::addItemToBin(ApplicationTS *app, BinTS *bin)
 {
-    AlgoTSBinFFDDotProduct::addItemToBin(app, replica_id, bin);
+    AlgoTSBinFFDDotProduct::addItemToBin(app, bin);
 
-    const ResourceTS& app_cpu = app->getCpuUsage();
-    const ResourceTS& app_mem = app->getMemUsage();
+    SeriesSpan app_cpu = app->getCpuUsage();
+    SeriesSpan app_mem = app->getMemUsage();
 
     for (size_t i = 0; i < size_TS; ++i)
     {
@@ -958,8 +963,8 @@ void AlgoTSBinFFDFitness::computeMeasures(AppListTS::iterator start_list, AppLis
     {
         ApplicationTS * app = *it;
         // Use normalized values of app size and bin residual capacity
-        const ResourceTS& app_norm_cpu = app->getNormCpuUsage();
-        const ResourceTS& app_norm_mem = app->getNormMemUsage();
+        ScaledSeries app_norm_cpu = app->getNormCpuUsage();
+        ScaledSeries app_norm_mem = app->getNormMemUsage();
         float measure = 0.0;
         for (size_t i = 0; i < size_TS; ++i)
         {
@@ -993,7 +998,7 @@ int AlgoTSSpreadWFDAvg::solveInstanceSpread(int LB_bins, int UB_bins)
     }
 
     // Store the current solution
-    BinListTS best_bins = getBinsCopy();
+    saveBestSolution();
     int best_sol = UB_bins;
     int low_bound = LB_bins;
     int target_bins;
@@ -1007,15 +1012,7 @@ int AlgoTSSpreadWFDAvg::solveInstanceSpread(int LB_bins, int UB_bins)
         {
             // Update the best solution
             best_sol = target_bins;
-            for (BinTS* bin : best_bins)
-            {
-                if (bin != nullptr)
-                {
-                    delete bin;
-                }
-            }
-            best_bins.clear();
-            best_bins = getBinsCopy();
+            saveBestSolution();
         }
         else
         {
@@ -1023,7 +1020,7 @@ int AlgoTSSpreadWFDAvg::solveInstanceSpread(int LB_bins, int UB_bins)
             low_bound = target_bins+1;
         }
     }
-    setSolution(best_bins);
+    restoreBestSolution();
     return best_sol;
 }
 
@@ -1050,7 +1047,7 @@ bool AlgoTSSpreadWFDAvg::trySolve(int nb_bins)
                 curr_bin = bins.at(curr_bin_index);
                 if (checkItemToBin(app, curr_bin))
                 {
-                    addItemToBin(app, replica_index, curr_bin);
+                    addItemToBin(app, curr_bin);
                     updateBinMeasure(curr_bin);
                     replica_packed = true;
                     replica_index -= 1;
@@ -1082,12 +1079,31 @@ bool AlgoTSSpreadWFDAvg::trySolve(int nb_bins)
     return true;
 }
 
+void AlgoTSSpreadWFDAvg::saveBestSolution()
+{
+    // Copied in the bins of best_arena, which keep their containers
+    best_arena.reset();
+    best_bins.clear();
+    for (BinTS* bin : bins)
+    {
+        best_bins.push_back(best_arena.get(best_arena.createCopy(*bin)));
+    }
+}
+
+void AlgoTSSpreadWFDAvg::restoreBestSolution()
+{
+    // The bins of the current solution are kept for the next copy
+    bin_arena.swap(best_arena);
+    bins.swap(best_bins);
+    solved = true;
+}
+
 void AlgoTSSpreadWFDAvg::createBins(int nb_bins)
 {
     bins.reserve(nb_bins);
     for (int i = 0; i < nb_bins; ++i)
     {
-        BinTS* bin = new BinTS(i, bin_cpu_capacity, bin_mem_capacity, size_TS);
+        BinTS* bin = newBin(i);
         updateBinMeasure(bin);
         bins.push_back(bin);
     }
@@ -1124,10 +1140,10 @@ bool AlgoTSSpreadWFDAvg::checkItemToBin(ApplicationTS* app, BinTS* bin) const
     return (bin->doesItemFit(app)) and (bin->isAffinityCompliant(app));
 }
 
-void AlgoTSSpreadWFDAvg::addItemToBin(ApplicationTS* app, int replica_id, BinTS* bin)
+void AlgoTSSpreadWFDAvg::addItemToBin(ApplicationTS* app, BinTS* bin)
 {
     bin->addNewConflict(app);
-    bin->addItem(app, replica_id);
+    bin->addItem(app);
 }
 
 
@@ -1209,7 +1225,7 @@ void AlgoTSSpreadWFDSurrogate::createBins(int nb_bins)
     bins.reserve(nb_bins);
     for (int i = 0; i < nb_bins; ++i)
     {
-        BinTS* bin = new BinTS(i, bin_cpu_capacity, bin_mem_capacity, size_TS);
+        BinTS* bin = newBin(i);
         bins.push_back(bin);
     }
 
@@ -1220,13 +1236,13 @@ void AlgoTSSpreadWFDSurrogate::createBins(int nb_bins)
     }
 }
 
-void AlgoTSSpreadWFDSurrogate::addItemToBin(ApplicationTS* app, int replica_id, BinTS* bin)
+void AlgoTSSpreadWFDSurrogate::addItemToBin(ApplicationTS* app, BinTS* bin)
 {
     bin->addNewConflict(app);
-    bin->addItem(app, replica_id);
+    bin->addItem(app);
 
-    const ResourceTS& app_cpu = app->getCpuUsage();
-    const ResourceTS& app_mem = app->getMemUsage();
+    SeriesSpan app_cpu = app->getCpuUsage();
+    SeriesSpan app_mem = app->getMemUsage();
 
     for(size_t i = 0; i < size_TS; ++i)
     {
@@ -1336,7 +1352,7 @@ int AlgoTSRefineWFDAvg::solveInstanceSpread(int LB_bins, int UB_bins)
     else
     {
         // Try to refine the solution with small steps
-        BinListTS best_bins = getBinsCopy();
+        saveBestSolution();
         best_sol = UB_bins;
         int target_bins;
 
@@ -1350,15 +1366,7 @@ int AlgoTSRefineWFDAvg::solveInstanceSpread(int LB_bins, int UB_bins)
                 // Update the best solution
                 best_sol = target_bins;
                 //UB_bins = target_bins;
-                for (BinTS* bin : best_bins)
-                {
-                    if (bin != nullptr)
-                    {
-                        delete bin;
-                    }
-                }
-                best_bins.clear();
-                best_bins = getBinsCopy();
+                saveBestSolution();
             }
             else
             {
@@ -1366,7 +1374,7 @@ int AlgoTSRefineWFDAvg::solveInstanceSpread(int LB_bins, int UB_bins)
                 break;
             }
         }
-        setSolution(best_bins);
+        restoreBestSolution();
     }
     return best_sol;
 }
@@ -2,6 +2,7 @@
 #define ALGOSTS_HPP
 
 #include "application.hpp"
+#include "bin_arena.hpp"
 #include "instance.hpp"
 #include "bins.hpp"
 
@@ -17,13 +18,16 @@ public:
     bool isSolved() const;
     int getSolution() const;
     const BinListTS& getBins() const;
-    BinListTS getBinsCopy() const;
+    BinListTS getBinsCopy() const; // New bins owned by the caller, see freeBins
+    std::vector<int> getReplicaBins() const; // See computeReplicaBins
     const AppListTS& getApps() const;
     const int getBinCPUCapacity() const;
     const int getBinMemCapacity() const;
     const std::string& getInstanceName() const;
 
-    void setSolution(BinListTS& bins);
+    // Copies the bins, which stay the caller's: bins from getBinsCopy are
+    // still freed by the caller, the copies are numbered by their position
+    void setSolution(const BinListTS& bins);
     void clearSolution();
 
     int solveInstance(int hint_nb_bins = 0);
@@ -37,11 +41,14 @@ private:
     virtual void sortBins() = 0;
     virtual void sortApps(AppListTS::iterator first_app, AppListTS::iterator end_it) = 0;
     virtual bool checkItemToBin(ApplicationTS* app, BinTS* bin) const = 0;
-    virtual void addItemToBin(ApplicationTS* app, int replica_id, BinTS* bin) = 0;
+    virtual void addItemToBin(ApplicationTS* app, BinTS* bin) = 0;
 
 protected:
+    BinTS* newBin(int id); // New empty bin in bin_arena
+
     std::string instance_name;
     size_t size_TS;
+    SeriesPrecision precision; // Of the bins
     int bin_cpu_capacity;
     int bin_mem_capacity;
     int total_replicas;
@@ -50,6 +57,7 @@ protected:
     int next_bin_index;
     int curr_bin_index;
     AppListTS apps;
+    BinArena<BinTS> bin_arena; // Storage of the bins, reused by the next solutions
     BinListTS bins;
     bool solved;
 };
@@ -70,7 +78,7 @@ protected:
     virtual void sortApps(AppListTS::iterator first_app, AppListTS::iterator end_it);
     virtual void sortBins();
     virtual bool checkItemToBin(ApplicationTS* app, BinTS* bin) const;
-    virtual void addItemToBin(ApplicationTS* app, int replica_id, BinTS* bin);
+    virtual void addItemToBin(ApplicationTS* app, BinTS* bin);
 };
 
 
@@ -144,7 +152,7 @@ private:
     virtual void sortApps(AppListTS::iterator first_app, AppListTS::iterator end_it);
     virtual void sortBins();
     virtual bool checkItemToBin(ApplicationTS* app, BinTS* bin) const;
-    virtual void addItemToBin(ApplicationTS* app, int replica_id, BinTS* bin);
+    virtual void addItemToBin(ApplicationTS* app, BinTS* bin);
 
     virtual void updateBinMeasure(BinTS* bin);
 };
@@ -169,7 +177,7 @@ private:
     virtual void sortApps(AppListTS::iterator first_app, AppListTS::iterator end_it);
     virtual void sortBins();
     virtual void createNewBin();
-    virtual void addItemToBin(ApplicationTS *app, int replica_id, BinTS *bin);
+    virtual void addItemToBin(ApplicationTS *app, BinTS *bin);
     virtual void updateBinMeasure(BinTS* bin);
 protected:
     ResourceTS sum_residual_cpu; // Sum of residual capacity
@@ -302,7 +310,7 @@ protected:
     virtual void computeMeasures(AppListTS::iterator start_list, AppListTS::iterator end_list, BinTS* bin);
 
     virtual BinTS* createNewBinRet();
-    virtual void addItemToBin(ApplicationTS *app, int replica_id, BinTS* bin);
+    virtual void addItemToBin(ApplicationTS *app, BinTS* bin);
     ResourceTS sum_residual_cpu; // Sum of residual capacity
     ResourceTS sum_residual_mem; // of all bins for each time step
 };
@@ -323,7 +331,11 @@ public:
     virtual int solveInstanceSpread(int LB_bins, int UB_bins);
 protected:
     bool trySolve(int nb_bins); // Try to find a solution with the given bins
+    void saveBestSolution();    // Copy of the bins as the best solution
+    void restoreBestSolution(); // The best solution becomes the solution
 private:
+    BinArena<BinTS> best_arena; // Storage of the best bins, reused by the next copies
+    BinListTS best_bins;
 
     virtual void createBins(int nb_bins);
     virtual void updateBinMeasure(BinTS* bin);
@@ -334,7 +346,7 @@ private:
     virtual void sortBins();
     virtual void sortApps(AppListTS::iterator first_app, AppListTS::iterator end_it);
     virtual bool checkItemToBin(ApplicationTS* app, BinTS* bin) const;
-    virtual void addItemToBin(ApplicationTS* app, int replica_id, BinTS* bin);
+    virtual void addItemToBin(ApplicationTS* app, BinTS* bin);
 };
 
 /*********** Spread replicas Worst Fit Max **********/
@@ -358,7 +370,7 @@ private:
     virtual void createBins(int nb_bins);
     virtual void updateBinMeasure(BinTS* bin);
     virtual void updateBinMeasures();
-    virtual void addItemToBin(ApplicationTS *app, int replica_id, BinTS *bin);
+    virtual void addItemToBin(ApplicationTS *app, BinTS *bin);
     virtual void sortApps(AppListTS::iterator first_app, AppListTS::iterator end_it);
 
 protected:
@@ -377,7 +389,7 @@ private:
     //virtual void createBins(int nb_bins);
     virtual void updateBinMeasure(BinTS* bin);
     virtual void updateBinMeasures();
-    //virtual void addItemToBin(ApplicationTS *app, int replica_id, BinTS *bin);
+    //virtual void addItemToBin(ApplicationTS *app, BinTS *bin);
     virtual void sortApps(AppListTS::iterator first_app, AppListTS::iterator end_it);
 };*/
 
@@ -0,0 +1,42 @@
+#include "binary_instance.hpp"
+
+#include <iostream>
+#include <string>
+
+using namespace std;
+
+
+int main(int argc, char** argv)
+{
+    string kind;
+    string infile;
+    string outfile;
+    if (argc > 3)
+    {
+        kind = argv[1];
+        infile = argv[2];
+        outfile = argv[3];
+    }
+    else
+    {
+        cout << "Usage: " << argv[0] << " <2D|TS> <input_csv_file> <output_binary_file>" << endl;
+        return -1;
+    }
+
+    if (kind == "2D")
+    {
+        convertInstance2DToBinary(infile, outfile);
+    }
+    else if (kind == "TS")
+    {
+        convertInstanceTSToBinary(infile, outfile);
+    }
+    else
+    {
+        cout << "Unknown instance kind: " << kind << endl;
+        return -1;
+    }
+
+    cout << "Converted " << infile << " to " << outfile << endl;
+    return 0;
+}
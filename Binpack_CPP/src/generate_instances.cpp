@@ -0,0 +1,174 @@
+#include "instance_generator.hpp"
+#include "binary_instance.hpp"
+
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <system_error>
+#include <vector>
+
+using namespace std;
+
+
+// Write one generated instance, in the CSV format or in the binary format
+// (the executables detect the format from the content, so the name is the same)
+void write_instance(InstanceGenerator& generator, BinaryInstanceColumns cols,
+                    const string& outfile, bool binary)
+{
+    if (binary)
+    {
+        writeBinaryInstance(generator.build(cols), outfile);
+    }
+    else
+    {
+        generator.writeCSV(cols, outfile);
+    }
+}
+
+// Same instances as generate_large_scale.py, or nb_instances of each graph class
+// with the given size and density
+void generate_large(InstanceGenerator& generator, const string& output_path,
+                    const vector<size_t>& list_nb_apps, double d, const string& s_density,
+                    int nb_instances, uint64_t seed, bool binary)
+{
+    vector<AffinityGraphClass> graph_classes = {
+        AffinityGraphClass::Arbitrary, AffinityGraphClass::Normal, AffinityGraphClass::Threshold
+    };
+
+    for (size_t nb_apps : list_nb_apps)
+    {
+        cout << "Generating " << nb_apps << " apps: ";
+        for (int i = 0; i < nb_instances; ++i)
+        {
+            cout << i << " " << flush;
+            // Independent of the other instances, so any instance can be generated again alone
+            generator.seed(deriveSeed(seed, nb_apps * nb_instances + i));
+            BinaryInstanceColumns base_cols = generator.sampleApps(nb_apps);
+            for (AffinityGraphClass graph_class : graph_classes)
+            {
+                BinaryInstanceColumns cols = base_cols;
+                generator.addAffinities(cols, graph_class, d);
+                string instance_name("large_scale_" + to_string(nb_apps) + "_" + affinityGraphClassName(graph_class) + "_d" + s_density + "_" + to_string(i));
+                write_instance(generator, std::move(cols), output_path + instance_name + ".csv", binary);
+            }
+        }
+        cout << endl;
+    }
+}
+
+// Same instances as generate_higher_density.py
+void generate_density(InstanceGenerator& generator, const string& output_path,
+                      uint64_t seed, bool binary)
+{
+    vector<int> densities = {1, 5, 10};
+    vector<AffinityGraphClass> graph_classes = {
+        AffinityGraphClass::Arbitrary, AffinityGraphClass::Normal, AffinityGraphClass::Threshold
+    };
+
+    BinaryInstanceColumns base_cols = generator.baselineApps();
+    for (int int_d : densities)
+    {
+        double d = int_d / 100.0;
+        cout << "Density " << d << ": ";
+        for (int i = 0; i < 10; ++i)
+        {
+            cout << i << " " << flush;
+            generator.seed(deriveSeed(seed, int_d * 10 + i));
+            for (AffinityGraphClass graph_class : graph_classes)
+            {
+                BinaryInstanceColumns cols = base_cols;
+                generator.addAffinities(cols, graph_class, d);
+                string instance_name(affinityGraphClassName(graph_class) + "_d" + to_string(int_d) + "_" + to_string(i));
+                write_instance(generator, std::move(cols), output_path + instance_name + ".csv", binary);
+            }
+        }
+        cout << endl;
+    }
+}
+
+
+int main(int argc, char** argv)
+{
+    string kind;
+    string baseline_file;
+    string output_path;
+    string family;
+    if (argc > 4)
+    {
+        kind = argv[1];
+        baseline_file = argv[2];
+        output_path = string(argv[3]) + "/";
+        family = argv[4];
+    }
+    if ((argc <= 4) or ((kind != "2D") and (kind != "TS")))
+    {
+        cout << "Usage: " << argv[0] << " <2D|TS> <baseline_file> <output_dir> large [seed] [csv|bin]" << endl;
+        cout << "       " << argv[0] << " <2D|TS> <baseline_file> <output_dir> density [seed] [csv|bin]" << endl;
+        cout << "       " << argv[0] << " <2D|TS> <baseline_file> <output_dir> <nb_apps> <density> [nb_instances] [seed] [csv|bin]" << endl;
+        return -1;
+    }
+
+    // Optional arguments after the family
+    int next_arg = 5;
+    size_t nb_apps = 0;
+    double d = 0.0;
+    string s_density;
+    int nb_instances = 10;
+    if ((family != "large") and (family != "density"))
+    {
+        if (argc <= 5)
+        {
+            cout << "Missing density for " << family << " apps" << endl;
+            return -1;
+        }
+        nb_apps = stoull(family);
+        s_density = argv[5];
+        d = stod(s_density);
+        // Name of the density as in the large scale files: 0.005 gives 005
+        s_density = s_density.substr(s_density.find('.') + 1);
+        next_arg = 6;
+        if (argc > next_arg)
+        {
+            nb_instances = stoi(argv[next_arg++]);
+        }
+    }
+    uint64_t seed = (argc > next_arg) ? stoull(argv[next_arg++]) : 0;
+    bool binary = false;
+    if (argc > next_arg)
+    {
+        string format = argv[next_arg];
+        if ((format != "csv") and (format != "bin"))
+        {
+            cout << "Unknown output format: " << format << endl;
+            return -1;
+        }
+        binary = (format == "bin");
+    }
+
+    // Also creates the parent directories, as the Python scripts do
+    std::error_code error;
+    filesystem::create_directories(output_path, error);
+    if (error)
+    {
+        cout << "Cannot create directory " << output_path << endl;
+        return -1;
+    }
+
+    BinaryInstanceKind instance_kind = (kind == "2D") ? BinaryInstanceKind::Fixed2D : BinaryInstanceKind::TimeSeries;
+    InstanceGenerator generator(baseline_file, instance_kind, seed);
+    cout << "Baseline " << baseline_file << ": " << generator.getBaselineSize() << " apps" << endl;
+
+    if (family == "large")
+    {
+        generate_large(generator, output_path, {10000, 50000, 100000}, 0.005, "005", 10, seed, binary);
+    }
+    else if (family == "density")
+    {
+        generate_density(generator, output_path, seed, binary);
+    }
+    else
+    {
+        generate_large(generator, output_path, {nb_apps}, d, s_density, nb_instances, seed, binary);
+    }
+    return 0;
+}
@@ -0,0 +1,78 @@
+#include "tclab_dataset.hpp"
+#include "binary_instance.hpp"
+#include "compressed_input.hpp"
+
+#include <cerrno>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+#include <sys/stat.h>
+
+using namespace std;
+
+
+int main(int argc, char** argv)
+{
+    string TClab_dir;
+    string output_dir;
+    bool binary = false;
+    if (argc > 1)
+    {
+        TClab_dir = argv[1];
+        output_dir = (argc > 2) ? argv[2] : TClab_dir;
+        if (argc > 3)
+        {
+            string format = argv[3];
+            if ((format != "csv") and (format != "bin"))
+            {
+                cout << "Unknown output format: " << format << endl;
+                return -1;
+            }
+            binary = (format == "bin");
+        }
+    }
+    else
+    {
+        cout << "Usage: " << argv[0] << " <TClab_dir> [output_dir] [csv|bin]" << endl;
+        return -1;
+    }
+
+    if ((mkdir(output_dir.c_str(), 0755) != 0) and (errno != EEXIST))
+    {
+        cout << "Cannot create directory " << output_dir << endl;
+        return -1;
+    }
+
+    // Binary datasets get a .bin suffix, the Python scripts read the CSV names with pandas
+    string suffix = binary ? ".bin" : ".csv";
+    string outfile_2D = output_dir + "/TClab_dataset_2D" + suffix;
+    string outfile_TS = output_dir + "/TClab_dataset_TS" + suffix;
+    try
+    {
+        // The raw tables may be compressed
+        TClabDataset dataset(findInputFile(TClab_dir + "/app_resources.csv"),
+                             findInputFile(TClab_dir + "/instance_deployment.csv"),
+                             findInputFile(TClab_dir + "/app_interference.csv"));
+        cout << "Joined " << dataset.getNbApps() << " apps from " << TClab_dir << endl;
+
+        if (binary)
+        {
+            writeBinaryInstance(dataset.build2D(), outfile_2D);
+            writeBinaryInstance(dataset.buildTS(), outfile_TS);
+        }
+        else
+        {
+            dataset.writeCSV2D(outfile_2D);
+            dataset.writeCSVTS(outfile_TS);
+        }
+    }
+    catch (const std::runtime_error& e)
+    {
+        // Missing or malformed table, "Cannot open file ..." for a missing one
+        cout << e.what() << endl;
+        return -1;
+    }
+    cout << "Written " << outfile_2D << " and " << outfile_TS << endl;
+    return 0;
+}
@@ -1,5 +1,8 @@
 #include "application.hpp"
 #include "instance.hpp"
+#include "instance_cache.hpp"
+#include "instance_family.hpp"
+#include "compressed_input.hpp"
 #include "lower_bounds.hpp"
 #include "algos/algos2D.hpp"
 
@@ -45,6 +48,14 @@ std::string run_for_instance(const Instance2D & instance,
             row_res.append("\t" + to_string(sol));
             row_time.append("\t" + to_string((float)duration.count()));
 
+#ifdef BINPACK_CHECK_SOLUTIONS
+            // Compare the replica assignment with the packing of the bins
+            if (algo->isSolved() and !checkReplicaBins(algo->getBins(), algo->getApps(), algo->getReplicaBins()))
+            {
+                cout << "Invalid replica assignment: " << algo_name << endl;
+            }
+#endif
+
             delete algo;
         }
         else
@@ -76,6 +87,14 @@ std::string run_for_instance(const Instance2D & instance,
             row_res.append("\t" + to_string(sol));
             row_time.append("\t" + to_string((float)duration.count()));
 
+#ifdef BINPACK_CHECK_SOLUTIONS
+            // Compare the replica assignment with the packing of the bins
+            if (algo->isSolved() and !checkReplicaBins(algo->getBins(), algo->getApps(), algo->getReplicaBins()))
+            {
+                cout << "Invalid replica assignment: " << algo_name << endl;
+            }
+#endif
+
             delete algo;
         }
         else
@@ -92,7 +111,8 @@ std::string run_for_instance(const Instance2D & instance,
 int run_list_algos(string input_path, string& outfile,
                    vector<string>& list_algos, vector<string>& list_spread,
                    int bin_cpu_capacity, int bin_mem_capacity,
-                   int density)
+                   int density,
+                   InstanceCache* cache)
 {
     ofstream f(outfile, ios_base::trunc);
     if (!f.is_open())
@@ -121,6 +141,8 @@ int run_list_algos(string input_path, string& outfile,
     vector<int> densities;// = { 1, 5, 10 };
     densities.push_back(density);
     vector<string> graph_classes = { "arbitrary", "normal", "threshold" };
+    // All the files have the apps and resources of the TClab dataset
+    InstanceFamily family(BinaryInstanceKind::Fixed2D);
 
     for (int d : densities)
     {
@@ -131,8 +153,18 @@ int run_list_algos(string input_path, string& outfile,
             {
                 cout << to_string(n) << " ";
                 string instance_name(graph_class + "_d" + to_string(d) + "_" + to_string(n));
-                string infile(input_path + instance_name + ".csv");
-                const Instance2D instance(instance_name, bin_cpu_capacity, bin_mem_capacity, infile);
+                string infile = findInputFile(input_path + instance_name + ".csv");
+                // Parsed once for all bin capacities when a cache directory is given,
+                // else the resources of the first file are shared by the instances
+                // with the same resources, only the affinities of their files are parsed
+                const BinaryInstanceFile& file = (cache != nullptr) ? cache->get2D(infile) : family.loadAffinities(infile);
+                const Instance2D instance = (cache != nullptr) ?
+                    Instance2D(instance_name, bin_cpu_capacity, bin_mem_capacity, file) :
+                    Instance2D(instance_name, bin_cpu_capacity, bin_mem_capacity, family.getResources(), file);
+                if (cache != nullptr)
+                {
+                    cache->clear();
+                }
 
                 string row_str = run_for_instance(instance, list_algos, list_spread);
                 f << instance_name << "\t" << row_str << "\n";
@@ -153,16 +185,21 @@ int main(int argc, char** argv)
     int bin_mem_capacity;
     string data_path;
     int density;
+    InstanceCache* cache = nullptr;
     if (argc > 4)
     {
         bin_cpu_capacity = stoi(argv[1]);
         bin_mem_capacity = stoi(argv[2]);
         data_path = argv[3];
         density = stoi(argv[4]);
+        if (argc > 5)
+        {
+            cache = new InstanceCache(argv[5]);
+        }
     }
     else
     {
-        cout << "Usage: " << argv[0] << " <bin_cpu_capacity> <bin_mem_capacity> <data_path> <density>" << endl;
+        cout << "Usage: " << argv[0] << " <bin_cpu_capacity> <bin_mem_capacity> <data_path> <density> [cache_dir]" << endl;
         return -1;
     }
 
@@ -200,7 +237,8 @@ int main(int argc, char** argv)
         //"RefineWFD-Avg-5",
     };
 
-    run_list_algos(input_path, outfile, list_algos, list_spread, bin_cpu_capacity, bin_mem_capacity, density);
+    run_list_algos(input_path, outfile, list_algos, list_spread, bin_cpu_capacity, bin_mem_capacity, density, cache);
+    delete cache;
     cout << "Run successful" << endl;
     return 0;
 }
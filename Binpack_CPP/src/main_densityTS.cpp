@@ -1,11 +1,15 @@
 #include "application.hpp"
 #include "instance.hpp"
+#include "instance_cache.hpp"
+#include "instance_family.hpp"
+#include "compressed_input.hpp"
 #include "lower_bounds.hpp"
 #include "algos/algosTS.hpp"
 
 #include <iostream>
 #include <fstream>
 #include <chrono>
+#include <stdexcept>
 
 using namespace std;
 using namespace std::chrono;
@@ -47,6 +51,14 @@ std::string run_for_instance(const InstanceTS & instance,
             row_res.append("\t" + to_string(sol));
             row_time.append("\t" + to_string((float)duration.count()));
 
+#ifdef BINPACK_CHECK_SOLUTIONS
+            // Compare the replica assignment with the packing of the bins
+            if (algo->isSolved() and !checkReplicaBins(algo->getBins(), algo->getApps(), algo->getReplicaBins()))
+            {
+                cout << "Invalid replica assignment: " << algo_name << endl;
+            }
+#endif
+
             delete algo;
         }
         else
@@ -78,6 +90,14 @@ std::string run_for_instance(const InstanceTS & instance,
             row_res.append("\t" + to_string(sol));
             row_time.append("\t" + to_string((float)duration.count()));
 
+#ifdef BINPACK_CHECK_SOLUTIONS
+            // Compare the replica assignment with the packing of the bins
+            if (algo->isSolved() and !checkReplicaBins(algo->getBins(), algo->getApps(), algo->getReplicaBins()))
+            {
+                cout << "Invalid replica assignment: " << algo_name << endl;
+            }
+#endif
+
             delete algo;
         }
         else
@@ -94,7 +114,8 @@ std::string run_for_instance(const InstanceTS & instance,
 int run_list_algos(string input_path, string& outfile,
                    vector<string>& list_algos, vector<string>& list_spread,
                    int bin_cpu_capacity, int bin_mem_capacity,
-                   int density)
+                   int density,
+                   InstanceCache* cache, SeriesPrecision precision)
 {
     ofstream f(outfile, ios_base::trunc);
     if (!f.is_open())
@@ -123,6 +144,8 @@ int run_list_algos(string input_path, string& outfile,
     vector<int> densities;// = { 1, 5, 10 };
     densities.push_back(density);
     vector<string> graph_classes = { "arbitrary", "normal", "threshold" };
+    // All the files have the apps and resources of the TClab dataset
+    InstanceFamily family(BinaryInstanceKind::TimeSeries);
 
     size_t size_series = 98;
 
@@ -135,8 +158,20 @@ int run_list_algos(string input_path, string& outfile,
             {
                 cout << to_string(n) << " ";
                 string instance_name(graph_class + "_d" + to_string(d) + "_" + to_string(n));
-                string infile(input_path + instance_name + ".csv");
-                const InstanceTS instance(instance_name, bin_cpu_capacity, bin_mem_capacity, infile, size_series);
+                string infile = findInputFile(input_path + instance_name + ".csv");
+                // Parsed once for all bin capacities when a cache directory is given,
+                // else the resources of the first file are shared by the instances
+                // with the same resources, only the affinities of their files are parsed
+                const BinaryInstanceFile& file = (cache != nullptr) ? cache->getTS(infile) : family.loadAffinities(infile);
+                const InstanceTS instance = (cache != nullptr) ?
+                    InstanceTS(instance_name, bin_cpu_capacity, bin_mem_capacity, file, size_series,
+                               SeriesStorage::Copied, precision) :
+                    InstanceTS(instance_name, bin_cpu_capacity, bin_mem_capacity, family.getResources(), file,
+                               size_series, SeriesStorage::Mapped, precision);
+                if (cache != nullptr)
+                {
+                    cache->clear();
+                }
 
                 string row_str = run_for_instance(instance, list_algos, list_spread);
                 f << instance_name << "\t" << row_str << "\n";
@@ -157,21 +192,52 @@ int main(int argc, char** argv)
     int bin_mem_capacity;
     string data_path;
     int density;
+    InstanceCache* cache = nullptr;
+    SeriesPrecision precision = SeriesPrecision::Float;
+    string precision_name = "float";
     if (argc > 4)
     {
         bin_cpu_capacity = stoi(argv[1]);
         bin_mem_capacity = stoi(argv[2]);
         data_path = argv[3];
         density = stoi(argv[4]);
+        // Optional arguments: the cache directory and the precision of the series
+        for (int i = 5; i < argc; ++i)
+        {
+            string arg = argv[i];
+            if (arg.rfind("--precision=", 0) == 0)
+            {
+                precision_name = arg.substr(12);
+                try
+                {
+                    precision = parseSeriesPrecision(precision_name);
+                }
+                catch (const std::runtime_error& e)
+                {
+                    cout << e.what() << endl;
+                    delete cache;
+                    return -1;
+                }
+            }
+            else if (cache == nullptr)
+            {
+                cache = new InstanceCache(arg);
+            }
+        }
     }
     else
     {
-        cout << "Usage: " << argv[0] << " <bin_cpu_capacity> <bin_mem_capacity> <data_path> <density>" << endl;
+        cout << "Usage: " << argv[0] << " <bin_cpu_capacity> <bin_mem_capacity> <data_path> <density> [cache_dir] [--precision=float|fixed32|fixed16]" << endl;
         return -1;
     }
 
     string input_path = data_path + "/input/densityTS/";
     string outfile(data_path + "/results/densityTS_" + to_string(bin_cpu_capacity) + "_" + to_string(bin_mem_capacity) + "_" + to_string(density) + ".csv");
+    if (precision != SeriesPrecision::Float)
+    {
+        // Kept apart from the results with floats
+        outfile.insert(outfile.size() - 4, "_" + precision_name);
+    }
 
     vector<string> list_algos = {
         // Only keep algos in paper plots
@@ -196,7 +262,8 @@ int main(int argc, char** argv)
         "RefineWFD-Avg-5",*/
     };
 
-    run_list_algos(input_path, outfile, list_algos, list_spread, bin_cpu_capacity, bin_mem_capacity, density);
+    run_list_algos(input_path, outfile, list_algos, list_spread, bin_cpu_capacity, bin_mem_capacity, density, cache, precision);
+    delete cache;
 
     std::cout << "Run successful!" << std::endl;
     return 0;
@@ -1,11 +1,14 @@
 #include "application.hpp"
 #include "instance.hpp"
+#include "instance_cache.hpp"
+#include "compressed_input.hpp"
 #include "lower_bounds.hpp"
 #include "algos/algos2D.hpp"
 
 #include <iostream>
 #include <fstream>
 #include <chrono>
+#include <cstdlib>
 
 using namespace std;
 using namespace std::chrono;
@@ -31,9 +34,11 @@ std::string run_for_instance(const Instance2D & instance,
         AlgoFit2D * algo = createAlgo2D(algo_name, instance);
         if (algo != nullptr)
         {
+            resetConflictFilterStats();
             auto start = high_resolution_clock::now();
             sol = algo->solveInstance(hint_bin);
             auto stop = high_resolution_clock::now();
+            printConflictFilterStats(algo_name);
             auto duration = duration_cast<seconds>(stop - start);
 
             if (sol < best_sol)
@@ -45,6 +50,14 @@ std::string run_for_instance(const Instance2D & instance,
             row_res.append("\t" + to_string(sol));
             row_time.append("\t" + to_string((float)duration.count()));
 
+#ifdef BINPACK_CHECK_SOLUTIONS
+            // Compare the replica assignment with the packing of the bins
+            if (algo->isSolved() and !checkReplicaBins(algo->getBins(), algo->getApps(), algo->getReplicaBins()))
+            {
+                cout << "Invalid replica assignment: " << algo_name << endl;
+            }
+#endif
+
             delete algo;
         }
         else
@@ -76,6 +89,14 @@ std::string run_for_instance(const Instance2D & instance,
             row_res.append("\t" + to_string(sol));
             row_time.append("\t" + to_string((float)duration.count()));
 
+#ifdef BINPACK_CHECK_SOLUTIONS
+            // Compare the replica assignment with the packing of the bins
+            if (algo->isSolved() and !checkReplicaBins(algo->getBins(), algo->getApps(), algo->getReplicaBins()))
+            {
+                cout << "Invalid replica assignment: " << algo_name << endl;
+            }
+#endif
+
             delete algo;
         }
         else
@@ -92,7 +113,9 @@ std::string run_for_instance(const Instance2D & instance,
 int run_list_algos(string input_path, string& outfile,
                    vector<string>& list_algos, vector<string>& list_spread,
                    int bin_cpu_capacity, int bin_mem_capacity,
-                   int ssize)
+                   int ssize,
+                   InstanceCache* cache, bool renumber,
+                   InstanceLoadMode load_mode)
 {
     ofstream f(outfile, ios_base::trunc);
     if (!f.is_open())
@@ -135,8 +158,19 @@ int run_list_algos(string input_path, string& outfile,
                 {
                     cout << to_string(n) << " ";
                     string instance_name("large_scale_" + to_string(s) + "_" + graph_class + "_d" + d + "_" + to_string(n));
-                    string infile(input_path + instance_name + ".csv");
-                    const Instance2D instance(instance_name, bin_cpu_capacity, bin_mem_capacity, infile);
+                    string infile = findInputFile(input_path + instance_name + ".csv");
+                    // Parsed once for all bin capacities when a cache directory is given
+                    Instance2D instance = (cache != nullptr) ?
+                        Instance2D(instance_name, bin_cpu_capacity, bin_mem_capacity, cache->get2D(infile)) :
+                        Instance2D(instance_name, bin_cpu_capacity, bin_mem_capacity, infile, load_mode);
+                    if (cache != nullptr)
+                    {
+                        cache->clear();
+                    }
+                    if (renumber)
+                    {
+                        instance.renumberApplications();
+                    }
 
                     string row_str = run_for_instance(instance, list_algos, list_spread);
                     f << instance_name << "\t" << row_str << "\n";
@@ -158,21 +192,67 @@ int main(int argc, char** argv)
     int bin_mem_capacity;
     string data_path;
     int ssize;
+    InstanceCache* cache = nullptr;
+    bool renumber = false;
+    InstanceLoadMode load_mode = InstanceLoadMode::Sequential;
     if (argc > 4)
     {
         bin_cpu_capacity = stoi(argv[1]);
         bin_mem_capacity = stoi(argv[2]);
         data_path = argv[3];
         ssize = stoi(argv[4]);
+        // Optional arguments: the cache directory, the renumbering of the apps
+        // and the load mode of the CSV files
+        for (int i = 5; i < argc; ++i)
+        {
+            string arg = argv[i];
+            if (arg == "--renumber")
+            {
+                renumber = true;
+            }
+            else if (arg.rfind("--load=", 0) == 0)
+            {
+                try
+                {
+                    load_mode = parseInstanceLoadMode(arg.substr(7));
+                }
+                catch (const std::runtime_error& e)
+                {
+                    cout << e.what() << endl;
+                    delete cache;
+                    return -1;
+                }
+            }
+            else if (arg.rfind("--threads=", 0) == 0)
+            {
+                int nb_threads = atoi(arg.substr(10).c_str());
+                if (nb_threads < 1)
+                {
+                    cout << "Invalid number of threads: " << arg.substr(10) << endl;
+                    delete cache;
+                    return -1;
+                }
+                setLoaderThreads(nb_threads);
+            }
+            else if (cache == nullptr)
+            {
+                cache = new InstanceCache(arg);
+            }
+        }
     }
     else
     {
-        cout << "Usage: " << argv[0] << " <bin_cpu_capacity> <bin_mem_capacity> <data_path> <size>" << endl;
+        cout << "Usage: " << argv[0] << " <bin_cpu_capacity> <bin_mem_capacity> <data_path> <size> [cache_dir] [--renumber] [--load=sequential|pipelined|chunked] [--threads=N]" << endl;
         return -1;
     }
 
     string input_path = data_path + "/input/large2D/";
     string outfile(data_path + "/results/large2D_" + to_string(bin_cpu_capacity) + "_" + to_string(bin_mem_capacity) + "_" + to_string(ssize) + "_d005.csv");
+    if (renumber)
+    {
+        // The solutions can change with the order of the apps
+        outfile.insert(outfile.size() - 4, "_renumbered");
+    }
 
     vector<string> list_algos = {
         // Only keep algos in paper plots
@@ -206,7 +286,8 @@ int main(int argc, char** argv)
 
     run_list_algos(input_path, outfile, list_algos, list_spread,
                    bin_cpu_capacity, bin_mem_capacity,
-                   ssize);
+                   ssize, cache, renumber, load_mode);
+    delete cache;
 
     std::cout << "Run successful!" << std::endl;
     return 0;
@@ -1,11 +1,15 @@
 #include "application.hpp"
 #include "instance.hpp"
+#include "instance_cache.hpp"
+#include "compressed_input.hpp"
 #include "lower_bounds.hpp"
 #include "algos/algosTS.hpp"
 
 #include <iostream>
 #include <fstream>
 #include <chrono>
+#include <cstdlib>
+#include <stdexcept>
 
 using namespace std;
 using namespace std::chrono;
@@ -33,9 +37,11 @@ std::string run_for_instance(const InstanceTS & instance,
         AlgoFitTS * algo = createAlgoTS(algo_name, instance);
         if (algo != nullptr)
         {
+            resetConflictFilterStats();
             auto start = high_resolution_clock::now();
             sol = algo->solveInstance(hint_bin);
             auto stop = high_resolution_clock::now();
+            printConflictFilterStats(algo_name);
             auto duration = duration_cast<seconds>(stop - start);
 
             if (sol < best_sol)
@@ -47,6 +53,14 @@ std::string run_for_instance(const InstanceTS & instance,
             row_res.append("\t" + to_string(sol));
             row_time.append("\t" + to_string((float)duration.count()));
 
+#ifdef BINPACK_CHECK_SOLUTIONS
+            // Compare the replica assignment with the packing of the bins
+            if (algo->isSolved() and !checkReplicaBins(algo->getBins(), algo->getApps(), algo->getReplicaBins()))
+            {
+                cout << "Invalid replica assignment: " << algo_name << endl;
+            }
+#endif
+
             delete algo;
         }
         else
@@ -78,6 +92,14 @@ std::string run_for_instance(const InstanceTS & instance,
             row_res.append("\t" + to_string(sol));
             row_time.append("\t" + to_string((float)duration.count()));
 
+#ifdef BINPACK_CHECK_SOLUTIONS
+            // Compare the replica assignment with the packing of the bins
+            if (algo->isSolved() and !checkReplicaBins(algo->getBins(), algo->getApps(), algo->getReplicaBins()))
+            {
+                cout << "Invalid replica assignment: " << algo_name << endl;
+            }
+#endif
+
             delete algo;
         }
         else
@@ -94,7 +116,9 @@ std::string run_for_instance(const InstanceTS & instance,
 int run_list_algos(string input_path, string& outfile,
                    vector<string>& list_algos, vector<string>& list_spread,
                    int bin_cpu_capacity, int bin_mem_capacity,
-                   int ssize)
+                   int ssize,
+                   InstanceCache* cache, SeriesPrecision precision, bool renumber,
+                   InstanceLoadMode load_mode)
 {
     ofstream f(outfile, ios_base::trunc);
     if (!f.is_open())
@@ -139,12 +163,26 @@ int run_list_algos(string input_path, string& outfile,
                 {
                     cout << to_string(n) << " ";
                     string instance_name("large_scale_" + to_string(s) + "_" + graph_class + "_d" + d + "_" + to_string(n));
-                    string infile(input_path + instance_name + ".csv");
-                    const InstanceTS instance(instance_name, bin_cpu_capacity, bin_mem_capacity, infile, size_series);
+                    string infile = findInputFile(input_path + instance_name + ".csv");
+                    // Parsed once for all bin capacities when a cache directory is given,
+                    // the series are then read from the mapped cache file
+                    InstanceTS instance = (cache != nullptr) ?
+                        InstanceTS(instance_name, bin_cpu_capacity, bin_mem_capacity, cache->getTS(infile), size_series,
+                                   SeriesStorage::Mapped, precision) :
+                        InstanceTS(instance_name, bin_cpu_capacity, bin_mem_capacity, infile, size_series,
+                                   load_mode, SeriesStorage::Copied, precision);
+                    if (renumber)
+                    {
+                        instance.renumberApplications();
+                    }
 
                     string row_str = run_for_instance(instance, list_algos, list_spread);
                     f << instance_name << "\t" << row_str << "\n";
                     f.flush();
+                    if (cache != nullptr)
+                    {
+                        cache->clear();
+                    }
                 }
                 cout << endl;
             }
@@ -162,21 +200,88 @@ int main(int argc, char** argv)
     int bin_mem_capacity;
     string data_path;
     int size;
+    InstanceCache* cache = nullptr;
+    SeriesPrecision precision = SeriesPrecision::Float;
+    string precision_name = "float";
+    bool renumber = false;
+    InstanceLoadMode load_mode = InstanceLoadMode::Sequential;
     if (argc > 4)
     {
         bin_cpu_capacity = stoi(argv[1]);
         bin_mem_capacity = stoi(argv[2]);
         data_path = argv[3];
         size = stoi(argv[4]);
+        // Optional arguments: the cache directory, the precision of the series,
+        // the renumbering of the apps and the load mode of the CSV files
+        for (int i = 5; i < argc; ++i)
+        {
+            string arg = argv[i];
+            if (arg == "--renumber")
+            {
+                renumber = true;
+            }
+            else if (arg.rfind("--precision=", 0) == 0)
+            {
+                precision_name = arg.substr(12);
+                try
+                {
+                    precision = parseSeriesPrecision(precision_name);
+                }
+                catch (const std::runtime_error& e)
+                {
+                    cout << e.what() << endl;
+                    delete cache;
+                    return -1;
+                }
+            }
+            else if (arg.rfind("--load=", 0) == 0)
+            {
+                try
+                {
+                    load_mode = parseInstanceLoadMode(arg.substr(7));
+                }
+                catch (const std::runtime_error& e)
+                {
+                    cout << e.what() << endl;
+                    delete cache;
+                    return -1;
+                }
+            }
+            else if (arg.rfind("--threads=", 0) == 0)
+            {
+                int nb_threads = atoi(arg.substr(10).c_str());
+                if (nb_threads < 1)
+                {
+                    cout << "Invalid number of threads: " << arg.substr(10) << endl;
+                    delete cache;
+                    return -1;
+                }
+                setLoaderThreads(nb_threads);
+            }
+            else if (cache == nullptr)
+            {
+                cache = new InstanceCache(arg);
+            }
+        }
     }
     else
     {
-        cout << "Usage: " << argv[0] << " <bin_cpu_capacity> <bin_mem_capacity> <data_path> <size>" << endl;
+        cout << "Usage: " << argv[0] << " <bin_cpu_capacity> <bin_mem_capacity> <data_path> <size> [cache_dir] [--precision=float|fixed32|fixed16] [--renumber] [--load=sequential|pipelined|chunked] [--threads=N]" << endl;
         return -1;
     }
 
     string input_path = data_path + "/input/largeTS/";
     string outfile(data_path + "/results/largeTS_" + to_string(bin_cpu_capacity) + "_" + to_string(bin_mem_capacity) + "_" + to_string(size) + ".csv");
+    if (precision != SeriesPrecision::Float)
+    {
+        // Kept apart from the results with floats
+        outfile.insert(outfile.size() - 4, "_" + precision_name);
+    }
+    if (renumber)
+    {
+        // The solutions can change with the order of the apps
+        outfile.insert(outfile.size() - 4, "_renumbered");
+    }
 
     vector<string> list_algos = {
         // Only keep algos in paper plots
@@ -201,7 +306,8 @@ int main(int argc, char** argv)
         "RefineWFD-Avg-5",*/
     };
 
-    run_list_algos(input_path, outfile, list_algos, list_spread, bin_cpu_capacity, bin_mem_capacity, size);
+    run_list_algos(input_path, outfile, list_algos, list_spread, bin_cpu_capacity, bin_mem_capacity, size, cache, precision, renumber, load_mode);
+    delete cache;
 
     return 0;
 }
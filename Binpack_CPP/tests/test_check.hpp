@@ -0,0 +1,46 @@
+#ifndef TEST_CHECK_HPP
+#define TEST_CHECK_HPP
+
+#include <iostream>
+#include <stdexcept>
+
+// Checks of the tests, a failed check is printed and counted
+static int nb_failed_checks = 0;
+
+#define CHECK(condition) \
+    do \
+    { \
+        if (!(condition)) \
+        { \
+            std::cout << __FILE__ << ":" << __LINE__ << ": check failed: " #condition << std::endl; \
+            nb_failed_checks += 1; \
+        } \
+    } while (false)
+
+// Checks that the statement throws a std::runtime_error
+#define CHECK_THROWS(statement) \
+    do \
+    { \
+        bool thrown = false; \
+        try \
+        { \
+            statement; \
+        } \
+        catch (const std::runtime_error&) \
+        { \
+            thrown = true; \
+        } \
+        if (!thrown) \
+        { \
+            std::cout << __FILE__ << ":" << __LINE__ << ": no runtime_error thrown by: " #statement << std::endl; \
+            nb_failed_checks += 1; \
+        } \
+    } while (false)
+
+// Exit code of the test
+inline int testResult()
+{
+    return (nb_failed_checks == 0) ? 0 : 1;
+}
+
+#endif // TEST_CHECK_HPP
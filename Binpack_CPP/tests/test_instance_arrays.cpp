@@ -0,0 +1,112 @@
+#include "test_check.hpp"
+#include "test_instances.hpp"
+#include "instance.hpp"
+
+#include <string>
+#include <vector>
+
+
+// Same apps as the files below: big does not fit in the bins, x is only
+// referenced by the affinities of d
+static const std::vector<std::string> APP_IDS = {"a", "b", "c", "d", "big", "x"};
+static const std::vector<int> NB_REPLICAS = {2, 3, 1, 2, 1};
+static const std::vector<int> DEGREES = {1, 2, 0, 1, 0};
+static const std::vector<size_t> EDGE_OFFSETS = {0, 1, 3, 3, 4, 4};
+static const std::vector<int> EDGE_TARGETS = {1, 0, 2, 5};
+static const std::vector<int> EDGE_VALUES = {1, 0, 1, 0};
+
+static const char* const AFFINITIES[] = {"[(b, 1)]", "[(a, 0), (c, 1)]", "[]", "[(x, 0)]", "[]"};
+
+static void test2D()
+{
+    std::vector<int> cpu_sizes = {1, 2, 3, 1, 20};
+    std::vector<int> mem_sizes = {2, 1, 3, 1, 1};
+
+    std::string content = INSTANCE_HEADER;
+    for (size_t i = 0; i < cpu_sizes.size(); ++i)
+    {
+        content += APP_IDS[i] + "\t" + std::to_string(NB_REPLICAS[i]) + "\t" + std::to_string(cpu_sizes[i])
+            + "\t" + std::to_string(mem_sizes[i]) + "\t" + std::to_string(DEGREES[i]) + "\t" + AFFINITIES[i] + "\n";
+    }
+    std::string filename = "test_arrays_2D.csv";
+    writeFile(filename, content);
+
+    InstanceArrays2D arrays;
+    arrays.nb_apps = cpu_sizes.size();
+    arrays.nb_other_ids = 1;
+    arrays.app_ids = APP_IDS.data();
+    arrays.nb_replicas = NB_REPLICAS.data();
+    arrays.cpu_sizes = cpu_sizes.data();
+    arrays.mem_sizes = mem_sizes.data();
+    arrays.degrees = DEGREES.data();
+    arrays.edge_offsets = EDGE_OFFSETS.data();
+    arrays.edge_targets = EDGE_TARGETS.data();
+    arrays.edge_values = EDGE_VALUES.data();
+
+    Instance2D instance("arrays", 10, 10, arrays);
+    Instance2D loaded("arrays", 10, 10, filename);
+    CHECK(instance.getApps().size() == 4);
+    CHECK(hasInternalIds(instance));
+    CHECK(getApp2D(instance.getApps(), "big") == nullptr);
+    CHECK(getApp2D(instance.getApps(), "b")->getAffinityOut().size() == 2);
+    CHECK(describeInstance(instance) == describeInstance(loaded));
+    CHECK(instance.getSumCPU() == loaded.getSumCPU());
+    CHECK(instance.getSumMem() == loaded.getSumMem());
+
+    // Edge to an index out of the ids
+    std::vector<int> bad_targets = {1, 0, 2, 6};
+    arrays.edge_targets = bad_targets.data();
+    CHECK_THROWS(Instance2D("arrays", 10, 10, arrays));
+}
+
+static void testTS()
+{
+    const size_t size_series = 3;
+    std::vector<float> cpu_series = {1, 2, 3,  2, 2, 2,  3, 1, 3,  1, 1, 1,  20, 1, 1};
+    std::vector<float> mem_series = {2, 1, 2,  1, 1, 1,  3, 3, 3,  1, 2, 1,  1, 1, 1};
+
+    std::string content = INSTANCE_HEADER;
+    for (size_t i = 0; i < NB_REPLICAS.size(); ++i)
+    {
+        std::string cpu = "[";
+        std::string mem = "[";
+        for (size_t t = 0; t < size_series; ++t)
+        {
+            cpu += ((t > 0) ? ", " : "") + std::to_string(cpu_series[i * size_series + t]);
+            mem += ((t > 0) ? ", " : "") + std::to_string(mem_series[i * size_series + t]);
+        }
+        content += APP_IDS[i] + "\t" + std::to_string(NB_REPLICAS[i]) + "\t" + cpu + "]\t" + mem + "]\t"
+            + std::to_string(DEGREES[i]) + "\t" + AFFINITIES[i] + "\n";
+    }
+    std::string filename = "test_arrays_TS.csv";
+    writeFile(filename, content);
+
+    InstanceArraysTS arrays;
+    arrays.nb_apps = NB_REPLICAS.size();
+    arrays.nb_other_ids = 1;
+    arrays.app_ids = APP_IDS.data();
+    arrays.nb_replicas = NB_REPLICAS.data();
+    arrays.cpu_series = cpu_series.data();
+    arrays.mem_series = mem_series.data();
+    arrays.degrees = DEGREES.data();
+    arrays.edge_offsets = EDGE_OFFSETS.data();
+    arrays.edge_targets = EDGE_TARGETS.data();
+    arrays.edge_values = EDGE_VALUES.data();
+
+    InstanceTS instance("arrays", 10, 10, arrays, size_series);
+    InstanceTS loaded("arrays", 10, 10, filename, size_series);
+    CHECK(instance.getApps().size() == 4);
+    CHECK(hasInternalIds(instance));
+    CHECK(describeInstance(instance) == describeInstance(loaded));
+
+    // Mapped series reference the arrays of the caller
+    InstanceTS mapped("arrays", 10, 10, arrays, size_series, SeriesStorage::Mapped);
+    CHECK(describeInstance(mapped) == describeInstance(loaded));
+}
+
+int main()
+{
+    test2D();
+    testTS();
+    return testResult();
+}
@@ -0,0 +1,149 @@
+#include "test_check.hpp"
+#include "instance.hpp"
+#include "instance_delta.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+
+static const char* const HEADER = "app_id\tnb_instances\tcore\tmemory\tinter_degree\tinter_aff\n";
+
+static void writeFile(const std::string& filename, const std::string& content)
+{
+    std::ofstream f(filename, std::ios_base::trunc);
+    f << content;
+}
+
+// Apps of the instance sorted by id, with their edges named after the apps,
+// so that instances with different internal ids can be compared
+static std::string describeInstance(const Instance2D& instance)
+{
+    std::map<int, std::string> names;
+    for (Application2D* app : instance.getApps())
+    {
+        names[app->getInternalId()] = app->getId();
+    }
+    auto describeEdges = [&names](AffinitySpan edges) {
+        std::vector<std::string> items;
+        for (const AffinityEdge& edge : edges)
+        {
+            auto it = names.find(edge.target);
+            items.push_back(((it != names.end()) ? it->second : "?") + ":" + std::to_string(edge.value));
+        }
+        std::sort(items.begin(), items.end());
+        std::string s;
+        for (const std::string& item : items)
+        {
+            s += " " + item;
+        }
+        return s;
+    };
+
+    std::vector<std::string> lines;
+    for (Application2D* app : instance.getApps())
+    {
+        std::ostringstream line;
+        line << app->getId() << " " << app->getNbReplicas() << " " << app->getCPUSize()
+             << " " << app->getMemorySize() << " " << app->getTotalDegree()
+             << " out" << describeEdges(app->getAffinityOut())
+             << " in" << describeEdges(app->getAffinityIn());
+        lines.push_back(line.str());
+    }
+    std::sort(lines.begin(), lines.end());
+
+    std::ostringstream s;
+    s << instance.getSumCPU() << " " << instance.getSumMem() << " " << instance.getTotalReplicas() << "\n";
+    for (const std::string& line : lines)
+    {
+        s << line << "\n";
+    }
+    return s.str();
+}
+
+// The internal ids and the app table follow the app list
+static bool isConsistent(const Instance2D& instance)
+{
+    const AppList2D& apps = instance.getApps();
+    const AppTable& table = instance.getAppTable();
+    if (table.size() != apps.size())
+    {
+        return false;
+    }
+    for (size_t i = 0; i < apps.size(); ++i)
+    {
+        if ((apps[i]->getInternalId() != (int)i)
+            or (table.getNbReplicas(i) != apps[i]->getNbReplicas())
+            or (table.getCPUSize(i) != apps[i]->getCPUSize())
+            or (table.getMemorySize(i) != apps[i]->getMemorySize())
+            or (table.getTotalDegree(i) != apps[i]->getTotalDegree()))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+int main()
+{
+    // big does not fit in the bins, x is only referenced
+    std::string base_file = "test_deltas_base.csv";
+    writeFile(base_file, std::string(HEADER) +
+              "a\t2\t1\t2\t1\t[(b, 1)]\n"
+              "b\t3\t2\t1\t2\t[(a, 0), (c, 1)]\n"
+              "c\t1\t3\t3\t0\t[]\n"
+              "d\t2\t1\t1\t1\t[(x, 0)]\n"
+              "big\t1\t20\t1\t0\t[]\n");
+    std::string delta_file = "test_deltas.csv";
+    writeFile(delta_file,
+              "op\tapp_id\tnb_instances\tcore\tmemory\tinter_degree\tinter_aff\n"
+              "add\te\t2\t2\t2\t2\t[(a, 1), (d, 0)]\n"
+              "remove\tc\t\t\t\t\t\n"
+              "replicas\ta\t4\t\t\t\t\n"
+              "affinities\tb\t\t\t\t\t[(e, 0), (big, 1)]\n");
+    // Same instance as base_file after the deltas
+    std::string edited_file = "test_deltas_edited.csv";
+    writeFile(edited_file, std::string(HEADER) +
+              "a\t4\t1\t2\t1\t[(b, 1)]\n"
+              "b\t3\t2\t1\t2\t[(e, 0), (big, 1)]\n"
+              "d\t2\t1\t1\t1\t[(x, 0)]\n"
+              "big\t1\t20\t1\t0\t[]\n"
+              "e\t2\t2\t2\t2\t[(a, 1), (d, 0)]\n");
+
+    std::vector<InstanceDelta> deltas = readInstanceDeltas(delta_file);
+    CHECK(deltas.size() == 4);
+
+    Instance2D instance("deltas", 10, 10, base_file);
+    CHECK(instance.getApps().size() == 4);
+    instance.applyDeltas(deltas);
+    Instance2D edited("deltas", 10, 10, edited_file);
+
+    CHECK(instance.getApps().size() == 4);
+    CHECK(getApp2D(instance.getApps(), "c") == nullptr);
+    CHECK(getApp2D(instance.getApps(), "a")->getNbReplicas() == 4);
+    CHECK(getApp2D(instance.getApps(), "e")->getAffinityOut().size() == 2);
+    CHECK(instance.getTotalReplicas() == 11);
+    CHECK(isConsistent(instance));
+    CHECK(describeInstance(instance) == describeInstance(edited));
+
+    // The same deltas applied one at a time
+    Instance2D stepwise("deltas", 10, 10, base_file);
+    for (const InstanceDelta& delta : deltas)
+    {
+        stepwise.applyDeltas({delta});
+        CHECK(isConsistent(stepwise));
+    }
+    CHECK(describeInstance(stepwise) == describeInstance(edited));
+
+    // Unknown application
+    std::string bad_file = "test_deltas_bad.csv";
+    writeFile(bad_file,
+              "op\tapp_id\tnb_instances\tcore\tmemory\tinter_degree\tinter_aff\n"
+              "remove\tunknown\t\t\t\t\t\n");
+    CHECK_THROWS(instance.applyDeltas(readInstanceDeltas(bad_file)));
+
+    return testResult();
+}
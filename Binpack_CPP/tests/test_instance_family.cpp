@@ -0,0 +1,105 @@
+#include "test_check.hpp"
+#include "instance.hpp"
+#include "instance_family.hpp"
+
+#include <fstream>
+#include <sstream>
+#include <string>
+
+
+static const char* const HEADER = "app_id\tnb_instances\tcore\tmemory\tinter_degree\tinter_aff\n";
+
+static void writeFile(const std::string& filename, const std::string& content)
+{
+    std::ofstream f(filename, std::ios_base::trunc);
+    f << content;
+}
+
+static std::string describeInstance(const Instance2D& instance)
+{
+    std::ostringstream s;
+    for (Application2D* app : instance.getApps())
+    {
+        s << app->getId() << " " << app->getNbReplicas() << " " << app->getCPUSize()
+          << " " << app->getMemorySize() << " " << app->getAffinityOut().size() << "\n";
+    }
+    return s.str();
+}
+
+static std::string describeInstance(const InstanceTS& instance)
+{
+    std::ostringstream s;
+    for (ApplicationTS* app : instance.getApps())
+    {
+        s << app->getId() << " " << app->getNbReplicas();
+        for (size_t t = 0; t < app->getCpuUsage().size(); ++t)
+        {
+            s << " " << app->getCpuUsage()[t] << "/" << app->getMemUsage()[t];
+        }
+        s << " " << app->getAffinityOut().size() << "\n";
+    }
+    return s.str();
+}
+
+static void test2D()
+{
+    std::string base_file = "test_family_2D.csv";
+    writeFile(base_file, std::string(HEADER) +
+              "a\t2\t1\t2\t1\t[(b, 1)]\n"
+              "b\t3\t2\t1\t1\t[(a, 0)]\n");
+    // Same resources, other replicas and affinities
+    std::string same_file = "test_family_2D_same.csv";
+    writeFile(same_file, std::string(HEADER) +
+              "a\t4\t1\t2\t0\t[]\n"
+              "b\t1\t2\t1\t1\t[(a, 1)]\n");
+    // Other resources of b
+    std::string other_file = "test_family_2D_other.csv";
+    writeFile(other_file, std::string(HEADER) +
+              "a\t2\t1\t2\t1\t[(b, 1)]\n"
+              "b\t3\t5\t1\t1\t[(a, 0)]\n");
+
+    InstanceFamily family(BinaryInstanceKind::Fixed2D);
+    family.loadAffinities(base_file);
+    CHECK(&family.getResources() == &family.getBaseline());
+
+    std::string files[] = {same_file, other_file, base_file};
+    for (std::string& file_name : files)
+    {
+        const BinaryInstanceFile& file = family.loadAffinities(file_name);
+        Instance2D instance("family", 10, 10, family.getResources(), file);
+        Instance2D direct("family", 10, 10, file_name);
+        CHECK(describeInstance(instance) == describeInstance(direct));
+    }
+    family.loadAffinities(same_file);
+    CHECK(&family.getResources() == &family.getBaseline());
+    family.loadAffinities(other_file);
+    CHECK(&family.getResources() != &family.getBaseline());
+}
+
+static void testTS()
+{
+    std::string base_file = "test_family_TS.csv";
+    writeFile(base_file, std::string(HEADER) +
+              "a\t1\t[1.0, 2.0, 3.0]\t[1.0, 1.0, 1.0]\t1\t[(b, 1)]\n"
+              "b\t2\t[2.0, 2.0, 2.0]\t[3.0, 2.0, 1.0]\t0\t[]\n");
+    // Other memory series of a
+    std::string other_file = "test_family_TS_other.csv";
+    writeFile(other_file, std::string(HEADER) +
+              "a\t1\t[1.0, 2.0, 3.0]\t[1.0, 4.0, 1.0]\t0\t[]\n"
+              "b\t2\t[2.0, 2.0, 2.0]\t[3.0, 2.0, 1.0]\t1\t[(a, 1)]\n");
+
+    InstanceFamily family(BinaryInstanceKind::TimeSeries);
+    family.loadAffinities(base_file);
+    const BinaryInstanceFile& file = family.loadAffinities(other_file);
+    CHECK(&family.getResources() != &family.getBaseline());
+    InstanceTS instance("family", 10, 10, family.getResources(), file, 3);
+    InstanceTS direct("family", 10, 10, other_file, 3);
+    CHECK(describeInstance(instance) == describeInstance(direct));
+}
+
+int main()
+{
+    test2D();
+    testTS();
+    return testResult();
+}
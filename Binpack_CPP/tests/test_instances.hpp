@@ -0,0 +1,99 @@
+#ifndef TEST_INSTANCES_HPP
+#define TEST_INSTANCES_HPP
+
+#include "instance.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Instance files and descriptions shared by the tests
+
+static const char* const INSTANCE_HEADER = "app_id\tnb_instances\tcore\tmemory\tinter_degree\tinter_aff\n";
+
+inline void writeFile(const std::string& filename, const std::string& content)
+{
+    std::ofstream f(filename, std::ios_base::trunc);
+    f << content;
+}
+
+inline std::string describeResources(const Application2D* app)
+{
+    return std::to_string(app->getCPUSize()) + " " + std::to_string(app->getMemorySize());
+}
+
+inline std::string describeResources(const ApplicationTS* app)
+{
+    std::ostringstream s;
+    for (size_t t = 0; t < app->getCpuUsage().size(); ++t)
+    {
+        s << ((t > 0) ? " " : "") << app->getCpuUsage()[t] << "/" << app->getMemUsage()[t];
+    }
+    return s.str();
+}
+
+// Apps of the instance sorted by id, with their edges named after the apps,
+// so that instances with different internal ids can be compared
+template<typename Instance>
+std::string describeInstance(const Instance& instance)
+{
+    std::map<int, std::string> names;
+    for (auto app : instance.getApps())
+    {
+        names[app->getInternalId()] = app->getId();
+    }
+    auto describeEdges = [&names](AffinitySpan edges) {
+        std::vector<std::string> items;
+        for (const AffinityEdge& edge : edges)
+        {
+            auto it = names.find(edge.target);
+            items.push_back(((it != names.end()) ? it->second : "?") + ":" + std::to_string(edge.value));
+        }
+        std::sort(items.begin(), items.end());
+        std::string s;
+        for (const std::string& item : items)
+        {
+            s += " " + item;
+        }
+        return s;
+    };
+
+    std::vector<std::string> lines;
+    for (auto app : instance.getApps())
+    {
+        std::ostringstream line;
+        line << app->getId() << " " << app->getNbReplicas() << " " << describeResources(app)
+             << " " << app->getTotalDegree()
+             << " out" << describeEdges(app->getAffinityOut())
+             << " in" << describeEdges(app->getAffinityIn());
+        lines.push_back(line.str());
+    }
+    std::sort(lines.begin(), lines.end());
+
+    std::ostringstream s;
+    s << instance.getTotalReplicas() << "\n";
+    for (const std::string& line : lines)
+    {
+        s << line << "\n";
+    }
+    return s.str();
+}
+
+// The internal ids follow the app list
+template<typename Instance>
+bool hasInternalIds(const Instance& instance)
+{
+    for (size_t i = 0; i < instance.getApps().size(); ++i)
+    {
+        if (instance.getApps()[i]->getInternalId() != (int)i)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+#endif // TEST_INSTANCES_HPP
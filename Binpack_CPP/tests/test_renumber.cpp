@@ -0,0 +1,127 @@
+#include "test_check.hpp"
+#include "test_instances.hpp"
+#include "instance.hpp"
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+
+static const int NB_APPS = 20;
+
+// Affinities of app i with apps scattered in the file, and with x which is
+// not an app of the file
+static std::string affinities(int i, int& degree)
+{
+    std::ostringstream s;
+    s << "[(app" << (i * 7 + 3) % NB_APPS << ", " << (i % 2) << ")";
+    degree = 1;
+    if (i % 5 == 0)
+    {
+        s << ", (x, 0)";
+        degree += 1;
+    }
+    return s.str() + "]";
+}
+
+static std::string writeInstance(bool time_series)
+{
+    std::string filename = time_series ? "test_renumber_TS.csv" : "test_renumber_2D.csv";
+    std::ostringstream content;
+    content << INSTANCE_HEADER;
+    for (int i = 0; i < NB_APPS; ++i)
+    {
+        int degree;
+        std::string aff = affinities(i, degree);
+        content << "app" << i << "\t" << (1 + i % 3) << "\t";
+        if (time_series)
+        {
+            content << "[" << (1 + i % 4) << ".0, 2.0]\t[1.0, " << (1 + i % 5) << ".0]";
+        }
+        else
+        {
+            content << (1 + i % 4) << "\t" << (1 + i % 5);
+        }
+        content << "\t" << degree << "\t" << aff << "\n";
+    }
+    writeFile(filename, content.str());
+    return filename;
+}
+
+// Whether the internal ids are a new order of the apps
+template<typename Instance>
+bool isReordered(const Instance& instance)
+{
+    for (size_t i = 0; i < instance.getApps().size(); ++i)
+    {
+        if (instance.getApps()[i]->getId() != "app" + std::to_string(i))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+// The app table follows the app list
+static bool hasAppTable(const Instance2D& instance)
+{
+    const AppList2D& apps = instance.getApps();
+    const AppTable& table = instance.getAppTable();
+    if (table.size() != apps.size())
+    {
+        return false;
+    }
+    for (size_t i = 0; i < apps.size(); ++i)
+    {
+        if ((table.getNbReplicas(i) != apps[i]->getNbReplicas())
+            or (table.getCPUSize(i) != apps[i]->getCPUSize())
+            or (table.getMemorySize(i) != apps[i]->getMemorySize())
+            or (table.getTotalDegree(i) != apps[i]->getTotalDegree()))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void test2D()
+{
+    std::string filename = writeInstance(false);
+    Instance2D instance("renumber", 10, 10, filename);
+    std::string before = describeInstance(instance);
+    CHECK(!isReordered(instance));
+
+    instance.renumberApplications();
+    CHECK(isReordered(instance));
+    CHECK(hasInternalIds(instance));
+    CHECK(hasAppTable(instance));
+    // Same apps with the same edges, named after the apps
+    CHECK(describeInstance(instance) == before);
+    CHECK(instance.getApps().size() == (size_t)NB_APPS);
+
+    // The apps are still found by their id
+    for (int i = 0; i < NB_APPS; ++i)
+    {
+        Application2D* app = getApp2D(instance.getApps(), "app" + std::to_string(i));
+        CHECK((app != nullptr) and (instance.getApps()[app->getInternalId()] == app));
+    }
+}
+
+static void testTS()
+{
+    std::string filename = writeInstance(true);
+    InstanceTS instance("renumber", 10, 10, filename, 2);
+    std::string before = describeInstance(instance);
+
+    instance.renumberApplications();
+    CHECK(isReordered(instance));
+    CHECK(hasInternalIds(instance));
+    CHECK(describeInstance(instance) == before);
+}
+
+int main()
+{
+    test2D();
+    testTS();
+    return testResult();
+}
@@ -0,0 +1,191 @@
+#include "test_check.hpp"
+#include "instance.hpp"
+#include "algos/algos2D.hpp"
+#include "algos/algosTS.hpp"
+
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+
+static const char* const HEADER = "app_id\tnb_instances\tcore\tmemory\tinter_degree\tinter_aff\n";
+static const int NB_APPS = 40;
+static const size_t TS_SIZE = 4;
+
+static const std::vector<std::string> ALGOS = {
+    "FF", "FFD-Degree", "FFD-Avg", "FFD-Max", "FFD-AvgExpo", "FFD-Surrogate", "FFD-ExtendedSum",
+    "BFD-Avg", "BFD-Max", "BFD-AvgExpo", "BFD-Surrogate", "BFD-ExtendedSum",
+    "WFD-Avg", "WFD-Max", "WFD-AvgExpo", "WFD-Surrogate", "WFD-ExtendedSum",
+    "NCD-DotProduct", "NCD-DotDivision", "NCD-L2Norm", "NCD-Fitness"
+};
+static const std::vector<std::string> SPREAD_ALGOS_2D = {
+    "SpreadWFD-Avg", "SpreadWFD-Max", "SpreadWFD-AvgExpo", "SpreadWFD-Surrogate", "SpreadWFD-ExtendedSum",
+    "RefineWFD-Avg-2", "RefineWFD-Avg-3", "RefineWFD-Avg-5"
+};
+static const std::vector<std::string> SPREAD_ALGOS_TS = {
+    "SpreadWFD-Avg", "SpreadWFD-Max", "SpreadWFD-Surrogate",
+    "RefineWFD-Avg-2", "RefineWFD-Avg-3", "RefineWFD-Avg-5"
+};
+
+// Affinities of app i with the next apps, with a few replicas each
+static std::string affinities(int i, int& degree)
+{
+    std::ostringstream s;
+    s << "[";
+    degree = 0;
+    for (int j = i + 1; (j < NB_APPS) and (j <= i + 3); ++j)
+    {
+        if ((i + j) % 2 == 0)
+        {
+            s << ((degree > 0) ? ", " : "") << "(app" << j << ", " << (j % 3) << ")";
+            degree += 1;
+        }
+    }
+    s << "]";
+    return s.str();
+}
+
+static std::string writeInstance2D()
+{
+    std::string filename = "test_replica_bins_2D.csv";
+    std::ofstream f(filename, std::ios_base::trunc);
+    f << HEADER;
+    for (int i = 0; i < NB_APPS; ++i)
+    {
+        int degree;
+        std::string aff = affinities(i, degree);
+        f << "app" << i << "\t" << (1 + i % 4) << "\t" << (1 + (7 * i) % 9) << "\t" << (1 + (5 * i) % 11)
+          << "\t" << degree << "\t" << aff << "\n";
+    }
+    return filename;
+}
+
+static std::string writeInstanceTS()
+{
+    std::string filename = "test_replica_bins_TS.csv";
+    std::ofstream f(filename, std::ios_base::trunc);
+    f << HEADER;
+    for (int i = 0; i < NB_APPS; ++i)
+    {
+        int degree;
+        std::string aff = affinities(i, degree);
+        f << "app" << i << "\t" << (1 + i % 4) << "\t[";
+        for (size_t t = 0; t < TS_SIZE; ++t)
+        {
+            f << ((t > 0) ? ", " : "") << (1 + (7 * i + 3 * t) % 9) << ".5";
+        }
+        f << "]\t[";
+        for (size_t t = 0; t < TS_SIZE; ++t)
+        {
+            f << ((t > 0) ? ", " : "") << (1 + (5 * i + t) % 11) << ".0";
+        }
+        f << "]\t" << degree << "\t" << aff << "\n";
+    }
+    return filename;
+}
+
+// The replica assignment of a solved algo matches its bins, and no longer
+// once a replica is moved to another bin
+template<typename Algo>
+static void checkAlgo(const Algo& algo, const std::string& algo_name)
+{
+    CHECK(algo.isSolved());
+    std::vector<int> replica_bins = algo.getReplicaBins();
+    bool valid = checkReplicaBins(algo.getBins(), algo.getApps(), replica_bins);
+    if (!valid)
+    {
+        std::cout << "Invalid replica assignment: " << algo_name << std::endl;
+    }
+    CHECK(valid);
+    if (algo.getBins().size() > 1)
+    {
+        replica_bins[0] = (replica_bins[0] == algo.getBins()[0]->getId()) ?
+            algo.getBins()[1]->getId() : algo.getBins()[0]->getId();
+        CHECK(!checkReplicaBins(algo.getBins(), algo.getApps(), replica_bins));
+    }
+}
+
+static void test2D()
+{
+    std::string filename = writeInstance2D();
+    Instance2D instance("replica_bins", 20, 20, filename);
+    for (const std::string& algo_name : ALGOS)
+    {
+        AlgoFit2D* algo = createAlgo2D(algo_name, instance);
+        CHECK(algo != nullptr);
+        algo->solveInstance();
+        checkAlgo(*algo, algo_name);
+        delete algo;
+    }
+
+    // A solution given in another order is numbered by the positions of its bins
+    AlgoFit2D* algo = createAlgo2D("FFD-Degree", instance);
+    algo->solveInstance();
+    BinList2D reversed(algo->getBins().rbegin(), algo->getBins().rend());
+    AlgoFit2D* algoSet = createAlgo2D("FF", instance);
+    algoSet->setSolution(reversed);
+    delete algo;
+    CHECK(algoSet->getSolution() == (int)reversed.size());
+    for (size_t i = 0; i < algoSet->getBins().size(); ++i)
+    {
+        CHECK(algoSet->getBins()[i]->getId() == (int)i);
+    }
+    checkAlgo(*algoSet, "FF setSolution");
+
+    // The copies of getBinsCopy are freed by the caller, also once given to setSolution
+    BinList2D copies = algoSet->getBinsCopy();
+    algoSet->setSolution(copies);
+    freeBins(copies);
+    CHECK(copies.empty());
+    checkAlgo(*algoSet, "FF getBinsCopy");
+    delete algoSet;
+
+    // The spread algos are given room for a first solution, as with the UB of FF
+    // they may find none and keep the solution unset
+    AlgoFit2D* algoFF = createAlgo2D("FF", instance);
+    int UB = algoFF->solveInstance();
+    delete algoFF;
+    for (const std::string& algo_name : SPREAD_ALGOS_2D)
+    {
+        Algo2DSpreadWFDAvg* algo = createSpreadAlgo(algo_name, instance);
+        CHECK(algo != nullptr);
+        algo->solveInstanceSpread(1, 2 * UB);
+        checkAlgo(*algo, algo_name);
+        delete algo;
+    }
+}
+
+static void testTS()
+{
+    std::string filename = writeInstanceTS();
+    InstanceTS instance("replica_bins", 20, 20, filename, TS_SIZE);
+    for (const std::string& algo_name : ALGOS)
+    {
+        AlgoFitTS* algo = createAlgoTS(algo_name, instance);
+        CHECK(algo != nullptr);
+        algo->solveInstance();
+        checkAlgo(*algo, algo_name);
+        delete algo;
+    }
+
+    // See test2D
+    AlgoFitTS* algoFF = createAlgoTS("FF", instance);
+    int UB = algoFF->solveInstance();
+    delete algoFF;
+    for (const std::string& algo_name : SPREAD_ALGOS_TS)
+    {
+        AlgoTSSpreadWFDAvg* algo = createSpreadAlgo(algo_name, instance);
+        CHECK(algo != nullptr);
+        algo->solveInstanceSpread(1, 2 * UB);
+        checkAlgo(*algo, algo_name);
+        delete algo;
+    }
+}
+
+int main()
+{
+    test2D();
+    testTS();
+    return testResult();
+}
@@ -0,0 +1,35 @@
+#include "test_check.hpp"
+#include "instance.hpp"
+
+#include <string>
+#include <vector>
+
+
+static size_t parse(const std::string& series, std::vector<float>& values, float& peak, float& sum)
+{
+    values.assign(8, 0.0);
+    return parseResourceTS(series, 1, values.data(), values.size(), peak, sum);
+}
+
+int main()
+{
+    std::vector<float> values;
+    float peak;
+    float sum;
+
+    CHECK(parse("1.0,2.5, 0.5", values, peak, sum) == 3);
+    CHECK((values[0] == 1.0) and (values[1] == 2.5) and (values[2] == 0.5));
+    CHECK(peak == 2.5);
+    CHECK(sum == 4.0);
+    CHECK(parse(" +1.0 , 2.0 ", values, peak, sum) == 2);
+
+    // Malformed values and separators
+    CHECK_THROWS(parse("1.0,abc", values, peak, sum));
+    CHECK_THROWS(parse("1.0;2.0", values, peak, sum));
+    CHECK_THROWS(parse("1.0,,2.0", values, peak, sum));
+    // Empty field after a trailing separator
+    CHECK_THROWS(parse("1.0,2.0,", values, peak, sum));
+    CHECK_THROWS(parse("1.0,2.0, ", values, peak, sum));
+
+    return testResult();
+}
@@ -33,6 +33,8 @@ let
             
             buildInputs = with pkgs; [
                 cmake
+                zlib
+                zstd
             ];
 
             src = pkgs.lib.sourceByRegex ./Binpack_CPP [